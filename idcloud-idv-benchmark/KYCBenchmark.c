@@ -0,0 +1,1061 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#include "KYCCodec.h"
+
+#include <dirent.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+/**
+ Command-line benchmark and test of the request building and response parsing path.
+
+ Request templates in {@code corpus/requests} are the JSON bodies of {@code createVerificationJSON},
+ {@code initialRequestCreateJSON} and {@code verifySlefieCreateJSON}. Every {@code "@image"} leaf is replayed the same
+ way as {@code KYCStreamedBody} does it: JSON fragments as they are, image base64 encoded chunk by chunk into the
+ bound buffer of the upload stream.
+
+ Response templates in {@code corpus/responses} are recorded server replies. Every {@code "@image"} value is expanded
+ to base64 of the image before the run. {@code "@image-escaped"} escapes slash and {@code "@image-wrapped"} adds line
+ wrapping, as some JSON writers do. Response is delivered in network sized pieces and read the same way as
+ {@code KYCJSONReader} does it: strings are scanned in runs and image values are decoded on the fly.
+
+ Usage: KYCBenchmark --corpus <dir> [--test] [--thresholds <file>] [--target-mb <MiB per case>]
+ */
+
+// Raw image bytes encoded at once. Same as in KYCStreamedBody.
+#define kBase64ChunkSize        (48 * 1024)
+
+// Size of the bound buffer between body producer and upload stream. Same as in KYCStreamedBody.
+#define kBoundBufferSize        (64 * 1024)
+
+// Size of response pieces delivered by the transport.
+#define kNetworkChunkSize       (16 * 1024)
+
+// Line length of wrapped base64 values.
+#define kWrapLength             76
+
+// Limits of the corpus. Templates are small, so fixed arrays are enough.
+#define kMaxTemplates           16
+#define kMaxImages              16
+#define kMaxImageSizes          32
+#define kMaxDepth               32
+#define kMaxKeyLength           64
+#define kMaxNameLength          64
+#define kMaxThresholds          16
+
+// Amount of data processed by each case. Each case runs at least kMinOps operations.
+#define kDefaultTargetMB        64
+#define kMinOps                 3
+
+#define kImageMarker            "@image"
+#define kEscapedImageMarker     "@image-escaped"
+#define kWrappedImageMarker     "@image-wrapped"
+
+// MARK: - Allocation Counting
+
+// Allocator of the C library is wrapped, so every allocation made during timed loop is counted.
+#if defined(__GLIBC__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void __libc_free(void *pointer);
+
+static unsigned long long sAllocations = 0;
+
+void *malloc(size_t size) {
+    sAllocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    sAllocations++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+    sAllocations++;
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) {
+    __libc_free(pointer);
+}
+
+#define kAllocationsCounted     true
+
+#else
+
+static unsigned long long sAllocations = 0;
+
+#define kAllocationsCounted     false
+
+#endif
+
+// MARK: - Types
+
+typedef struct {
+    char        name[kMaxNameLength];
+    char        *text;
+    // Parts of the text. Fragments are split by images, so there is always one more fragment than images.
+    const char  *fragments[kMaxImages + 1];
+    size_t      fragmentLengths[kMaxImages + 1];
+    const char  *markers[kMaxImages];
+    size_t      imageCount;
+} KYCTemplate;
+
+typedef struct {
+    uint8_t     bound[kBoundBufferSize];
+    size_t      boundOffset;
+    uint8_t     *capture;
+    size_t      captureCapacity;
+    size_t      length;
+} KYCBodySink;
+
+typedef enum {
+    KYCReaderStateStructural,
+    KYCReaderStateString,
+    KYCReaderStateEscape
+} KYCReaderState;
+
+typedef struct {
+    KYCReaderState          state;
+    char                    containers[kMaxDepth];
+    size_t                  depth;
+    bool                    keyExpected;
+    bool                    stringIsKey;
+    bool                    stringIsImage;
+    char                    key[kMaxKeyLength + 1];
+    size_t                  keyLength;
+    const char              **imageKeys;
+    KYCCodecBase64Decoder   decoder;
+    uint8_t                 *decoded;
+    size_t                  decodedLength;
+    size_t                  decodedCapacity;
+    // Expected image. Compared only when verify is set.
+    const uint8_t           *image;
+    size_t                  imageLength;
+    bool                    verify;
+    size_t                  images;
+    bool                    failed;
+} KYCResponseReader;
+
+typedef struct {
+    char        phase[kMaxNameLength];
+    char        metric[kMaxNameLength];
+    double      limit;
+} KYCThreshold;
+
+typedef struct {
+    unsigned long long  bytes;
+    unsigned long long  elapsed;
+    unsigned long long  ops;
+    unsigned long long  allocations;
+} KYCPhaseTotals;
+
+typedef struct {
+    const char          *corpus;
+    const char          *thresholdsPath;
+    double              targetMB;
+    bool                test;
+    KYCTemplate         requests[kMaxTemplates];
+    size_t              requestCount;
+    KYCTemplate         responses[kMaxTemplates];
+    size_t              responseCount;
+    size_t              imageSizes[kMaxImageSizes];
+    size_t              imageSizeCount;
+    size_t              maxImageSize;
+    uint8_t             *image;
+    uint8_t             *chunk;
+    uint8_t             *document;
+    size_t              documentCapacity;
+    uint8_t             *decoded;
+    size_t              decodedCapacity;
+    KYCPhaseTotals      requestTotals;
+    KYCPhaseTotals      responseTotals;
+    long                baselineKB;
+    long                peakKB;
+    unsigned            failures;
+} KYCBenchmark;
+
+// Keys of image values. Response keys are the same as in KYCResponse. Request keys are used to read back request bodies.
+static const char *kResponseImageKeys[]  = {"portrait", "imageWhiteFront", "imageWhiteBack", "image", NULL};
+static const char *kRequestImageKeys[]   = {"front", "back", "image", "frontWhiteImage", "backWhiteImage", "face", NULL};
+
+// Shared by all runs. Too large for stack.
+static KYCBodySink      sSink;
+static KYCBenchmark     sBenchmark;
+
+// MARK: - Common Helpers
+
+static void KYCDie(const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    fprintf(stderr, "error: ");
+    vfprintf(stderr, format, arguments);
+    fprintf(stderr, "\n");
+    va_end(arguments);
+    exit(EXIT_FAILURE);
+}
+
+static void *KYCAllocate(size_t size) {
+    void *retValue = malloc(size ? size : 1);
+    if (!retValue) {
+        KYCDie("Out of memory.");
+    }
+    
+    // Touch all pages, so peak memory of the run does not include buffers of the harness.
+    memset(retValue, 0, size);
+    return retValue;
+}
+
+static unsigned long long KYCNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec;
+}
+
+static long KYCPeakMemoryKB(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static char *KYCReadFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        KYCDie("Can't open %s.", path);
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    char *retValue = KYCAllocate((size_t)size + 1);
+    if (fread(retValue, 1, (size_t)size, file) != (size_t)size) {
+        KYCDie("Can't read %s.", path);
+    }
+    fclose(file);
+    
+    retValue[size] = 0;
+    if (length) {
+        *length = (size_t)size;
+    }
+    return retValue;
+}
+
+static int KYCCompareNames(const void *first, const void *second) {
+    return strcmp(*(const char * const *)first, *(const char * const *)second);
+}
+
+// MARK: - Corpus
+
+/**
+ Splits template text by image markers. Marker is the whole string value, quotes stay in the fragments.
+ */
+static void KYCTemplateParse(KYCTemplate *template) {
+    const char *position = template->text;
+    template->imageCount = 0;
+    for (const char *loopMarker = strstr(position, "\"" kImageMarker); loopMarker; loopMarker = strstr(position, "\"" kImageMarker)) {
+        const char *end = strchr(loopMarker + 1, '"');
+        if (!end) {
+            KYCDie("Unterminated image marker in %s.", template->name);
+        } else if (template->imageCount == kMaxImages) {
+            KYCDie("Too many images in %s.", template->name);
+        }
+        
+        template->fragments[template->imageCount]       = position;
+        template->fragmentLengths[template->imageCount] = (size_t)(loopMarker + 1 - position);
+        template->markers[template->imageCount]         = loopMarker + 1;
+        template->imageCount++;
+        position = end;
+    }
+    
+    template->fragments[template->imageCount]       = position;
+    template->fragmentLengths[template->imageCount] = strlen(position);
+}
+
+static size_t KYCLoadTemplates(const char *directory, KYCTemplate *templates) {
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        KYCDie("Can't open %s.", directory);
+    }
+    
+    // Sorted, so the output is always in the same order.
+    char    *names[kMaxTemplates];
+    size_t  retValue = 0;
+    for (struct dirent *loopEntry = readdir(dir); loopEntry; loopEntry = readdir(dir)) {
+        size_t length = strlen(loopEntry->d_name);
+        if (length < 5 || strcmp(loopEntry->d_name + length - 5, ".json")) {
+            continue;
+        } else if (retValue == kMaxTemplates) {
+            KYCDie("Too many templates in %s.", directory);
+        }
+        names[retValue++] = strdup(loopEntry->d_name);
+    }
+    closedir(dir);
+    qsort(names, retValue, sizeof(*names), KYCCompareNames);
+    
+    for (size_t loopIndex = 0; loopIndex < retValue; loopIndex++) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s", directory, names[loopIndex]);
+        snprintf(templates[loopIndex].name, kMaxNameLength, "%.*s", (int)(strlen(names[loopIndex]) - 5), names[loopIndex]);
+        templates[loopIndex].text = KYCReadFile(path, NULL);
+        KYCTemplateParse(&templates[loopIndex]);
+        free(names[loopIndex]);
+    }
+    
+    return retValue;
+}
+
+static void KYCLoadImageSizes(KYCBenchmark *benchmark) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/images.txt", benchmark->corpus);
+    char *text = KYCReadFile(path, NULL);
+    
+    for (char *loopLine = strtok(text, "\n"); loopLine; loopLine = strtok(NULL, "\n")) {
+        if (*loopLine == '#' || !*loopLine) {
+            continue;
+        } else if (benchmark->imageSizeCount == kMaxImageSizes) {
+            KYCDie("Too many image sizes in %s.", path);
+        }
+        
+        size_t size = strtoull(loopLine, NULL, 10);
+        if (!size) {
+            KYCDie("Invalid image size '%s' in %s.", loopLine, path);
+        }
+        benchmark->imageSizes[benchmark->imageSizeCount++] = size;
+        if (size > benchmark->maxImageSize) {
+            benchmark->maxImageSize = size;
+        }
+    }
+    
+    free(text);
+}
+
+static size_t KYCLoadThresholds(const char *path, KYCThreshold *thresholds) {
+    char    *text       = KYCReadFile(path, NULL);
+    size_t  retValue    = 0;
+    for (char *loopLine = strtok(text, "\n"); loopLine; loopLine = strtok(NULL, "\n")) {
+        if (*loopLine == '#' || !*loopLine) {
+            continue;
+        } else if (retValue == kMaxThresholds) {
+            KYCDie("Too many thresholds in %s.", path);
+        }
+        
+        KYCThreshold *threshold = &thresholds[retValue];
+        if (sscanf(loopLine, "%63s %63s %lf", threshold->phase, threshold->metric, &threshold->limit) != 3) {
+            KYCDie("Invalid threshold '%s' in %s.", loopLine, path);
+        }
+        retValue++;
+    }
+    
+    free(text);
+    return retValue;
+}
+
+/**
+ Fills image with pseudo random bytes. JPEG data looks random to base64, all characters occur.
+ */
+static void KYCFillImage(uint8_t *image, size_t length) {
+    uint32_t state = 0x2545F491;
+    for (size_t loopIndex = 0; loopIndex < length; loopIndex++) {
+        state       ^= state << 13;
+        state       ^= state >> 17;
+        state       ^= state << 5;
+        image[loopIndex] = (uint8_t)(state >> 24);
+    }
+}
+
+/**
+ Length of image value in expanded response including quotes.
+ */
+static size_t KYCExpandedImageLength(const char *marker, size_t imageLength) {
+    size_t encoded = KYCCodecBase64EncodedLength(imageLength);
+    if (!strncmp(marker, kEscapedImageMarker "\"", strlen(kEscapedImageMarker) + 1)) {
+        // Worst case. Every character is escaped slash.
+        return 2 + encoded * 2;
+    } else if (!strncmp(marker, kWrappedImageMarker "\"", strlen(kWrappedImageMarker) + 1)) {
+        return 2 + encoded + (encoded / kWrapLength + 1) * 4;
+    }
+    
+    return 2 + encoded;
+}
+
+/**
+ Writes response with all image markers replaced by base64 of the image.
+
+ @return Length of the response.
+ */
+static size_t KYCExpandResponse(const KYCTemplate *template, const uint8_t *image, size_t imageLength, uint8_t *output) {
+    uint8_t *start = output;
+    for (size_t loopIndex = 0; loopIndex < template->imageCount; loopIndex++) {
+        // Fragment ends with the opening quote of the value. Marker is written instead of it.
+        memcpy(output, template->fragments[loopIndex], template->fragmentLengths[loopIndex] - 1);
+        output += template->fragmentLengths[loopIndex] - 1;
+        
+        const char  *marker     = template->markers[loopIndex];
+        uint8_t     *encoded    = output + 1;
+        size_t      length      = KYCCodecBase64Encode(image, imageLength, encoded);
+        *output++ = '"';
+        if (!strncmp(marker, kEscapedImageMarker "\"", strlen(kEscapedImageMarker) + 1)) {
+            // Expanded backwards in place.
+            size_t slashes = 0;
+            for (size_t loopChar = 0; loopChar < length; loopChar++) {
+                slashes += encoded[loopChar] == '/';
+            }
+            for (size_t loopChar = length, target = length + slashes; loopChar > 0; loopChar--) {
+                encoded[--target] = encoded[loopChar - 1];
+                if (encoded[loopChar - 1] == '/') {
+                    encoded[--target] = '\\';
+                }
+            }
+            length += slashes;
+        } else if (!strncmp(marker, kWrappedImageMarker "\"", strlen(kWrappedImageMarker) + 1)) {
+            size_t lines = (length + kWrapLength - 1) / kWrapLength;
+            for (size_t loopLine = lines; loopLine > 1; loopLine--) {
+                size_t  lineStart   = (loopLine - 1) * kWrapLength;
+                size_t  lineLength  = loopLine == lines ? length - lineStart : kWrapLength;
+                uint8_t *target     = encoded + lineStart + (loopLine - 1) * 4;
+                memmove(target, encoded + lineStart, lineLength);
+                memcpy(target - 4, "\\r\\n", 4);
+            }
+            length += lines ? (lines - 1) * 4 : 0;
+        }
+        output += length;
+    }
+    
+    // Last fragment starts with the closing quote of the last value.
+    memcpy(output, template->fragments[template->imageCount], template->fragmentLengths[template->imageCount]);
+    output += template->fragmentLengths[template->imageCount];
+    
+    return (size_t)(output - start);
+}
+
+static size_t KYCMaxResponseLength(const KYCTemplate *template, size_t imageLength) {
+    size_t retValue = 0;
+    for (size_t loopIndex = 0; loopIndex <= template->imageCount; loopIndex++) {
+        retValue += template->fragmentLengths[loopIndex];
+    }
+    for (size_t loopIndex = 0; loopIndex < template->imageCount; loopIndex++) {
+        retValue += KYCExpandedImageLength(template->markers[loopIndex], imageLength);
+    }
+    
+    return retValue;
+}
+
+// MARK: - Request Replay
+
+static void KYCSinkReset(KYCBodySink *sink, uint8_t *capture, size_t captureCapacity) {
+    sink->boundOffset       = 0;
+    sink->capture           = capture;
+    sink->captureCapacity   = captureCapacity;
+    sink->length            = 0;
+}
+
+/**
+ Copies produced bytes to the bound buffer the same way as the upload stream does. Reader drains it right away.
+ */
+static void KYCSinkWrite(KYCBodySink *sink, const uint8_t *bytes, size_t length) {
+    if (sink->capture) {
+        if (sink->length + length > sink->captureCapacity) {
+            KYCDie("Captured body is too long.");
+        }
+        memcpy(sink->capture + sink->length, bytes, length);
+    } else {
+        for (size_t loopOffset = 0; loopOffset < length;) {
+            size_t part = kBoundBufferSize - sink->boundOffset;
+            part = part < length - loopOffset ? part : length - loopOffset;
+            memcpy(sink->bound + sink->boundOffset, bytes + loopOffset, part);
+            sink->boundOffset   = (sink->boundOffset + part) % kBoundBufferSize;
+            loopOffset          += part;
+        }
+    }
+    
+    sink->length += length;
+}
+
+/**
+ Content length of the body. Same computation as in KYCStreamedBody.
+ */
+static size_t KYCRequestContentLength(const KYCTemplate *template, size_t imageLength) {
+    size_t retValue = 0;
+    for (size_t loopIndex = 0; loopIndex <= template->imageCount; loopIndex++) {
+        retValue += template->fragmentLengths[loopIndex];
+    }
+    
+    return retValue + template->imageCount * KYCCodecBase64EncodedLength(imageLength);
+}
+
+/**
+ Produces the whole body. Images are encoded in chunks the same way as in KYCBodyProducer.
+ */
+static size_t KYCReplayRequest(const KYCTemplate *template, const uint8_t *image, size_t imageLength, uint8_t *chunk, KYCBodySink *sink) {
+    for (size_t loopIndex = 0; loopIndex < template->imageCount; loopIndex++) {
+        KYCSinkWrite(sink, (const uint8_t *)template->fragments[loopIndex], template->fragmentLengths[loopIndex]);
+        for (size_t loopOffset = 0; loopOffset < imageLength; loopOffset += kBase64ChunkSize) {
+            size_t length = imageLength - loopOffset < kBase64ChunkSize ? imageLength - loopOffset : kBase64ChunkSize;
+            KYCSinkWrite(sink, chunk, KYCCodecBase64Encode(image + loopOffset, length, chunk));
+        }
+    }
+    KYCSinkWrite(sink, (const uint8_t *)template->fragments[template->imageCount], template->fragmentLengths[template->imageCount]);
+    
+    return sink->length;
+}
+
+// MARK: - Response Replay
+
+static void KYCReaderReset(KYCResponseReader *reader, const char **imageKeys, uint8_t *decoded, size_t decodedCapacity) {
+    memset(reader, 0, sizeof(*reader));
+    reader->imageKeys       = imageKeys;
+    reader->decoded         = decoded;
+    reader->decodedCapacity = decodedCapacity;
+}
+
+static bool KYCIsImageKey(const char **imageKeys, const char *key) {
+    for (const char **loopKey = imageKeys; *loopKey; loopKey++) {
+        if (!strcmp(*loopKey, key)) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+static void KYCReaderStructural(KYCResponseReader *reader, uint8_t byte) {
+    bool object = reader->depth && reader->containers[reader->depth - 1] == '{';
+    switch (byte) {
+        case '{':
+        case '[':
+            if (reader->depth == kMaxDepth) {
+                reader->failed = true;
+                return;
+            }
+            reader->containers[reader->depth++] = (char)byte;
+            reader->keyExpected                 = byte == '{';
+            break;
+        case '}':
+        case ']':
+            if (!reader->depth || reader->containers[reader->depth - 1] != (byte == '}' ? '{' : '[')) {
+                reader->failed = true;
+                return;
+            }
+            reader->depth--;
+            break;
+        case ',':
+            reader->keyExpected = object;
+            break;
+        case ':':
+            reader->keyExpected = false;
+            break;
+        case '"':
+            reader->stringIsKey     = object && reader->keyExpected;
+            reader->stringIsImage   = object && !reader->keyExpected && KYCIsImageKey(reader->imageKeys, reader->key);
+            reader->state           = KYCReaderStateString;
+            if (reader->stringIsKey) {
+                reader->keyLength = 0;
+            } else if (reader->stringIsImage) {
+                reader->decodedLength = 0;
+                KYCCodecBase64DecoderInit(&reader->decoder);
+            }
+            break;
+        default:
+            // Whitespace and literals. Not needed by the replay.
+            break;
+    }
+}
+
+static void KYCReaderAppendString(KYCResponseReader *reader, const uint8_t *bytes, size_t length) {
+    if (reader->stringIsKey) {
+        size_t part = kMaxKeyLength - reader->keyLength;
+        part = part < length ? part : length;
+        memcpy(reader->key + reader->keyLength, bytes, part);
+        reader->keyLength += part;
+    } else if (reader->stringIsImage) {
+        if (reader->decodedLength + KYCCodecBase64DecoderMaxOutput(length) > reader->decodedCapacity) {
+            reader->failed = true;
+            return;
+        }
+        reader->decodedLength += KYCCodecBase64DecoderUpdate(&reader->decoder, bytes, length, reader->decoded + reader->decodedLength);
+    }
+}
+
+static void KYCReaderFinishString(KYCResponseReader *reader) {
+    reader->state = KYCReaderStateStructural;
+    if (reader->stringIsKey) {
+        reader->key[reader->keyLength] = 0;
+    } else if (reader->stringIsImage) {
+        if (reader->decodedLength + 2 > reader->decodedCapacity) {
+            reader->failed = true;
+            return;
+        }
+        reader->decodedLength += KYCCodecBase64DecoderFinish(&reader->decoder, reader->decoded + reader->decodedLength);
+        if (reader->decoder.failed) {
+            reader->failed = true;
+        } else if (reader->verify && (reader->decodedLength != reader->imageLength || memcmp(reader->decoded, reader->image, reader->imageLength))) {
+            reader->failed = true;
+        } else {
+            reader->images++;
+        }
+    }
+}
+
+static void KYCReaderAppend(KYCResponseReader *reader, const uint8_t *bytes, size_t length) {
+    size_t index = 0;
+    while (index < length && !reader->failed) {
+        switch (reader->state) {
+            case KYCReaderStateString: {
+                // Most of the response is inside of strings. Whole runs are processed at once.
+                size_t run = KYCCodecJSONStringRun(bytes + index, length - index);
+                KYCReaderAppendString(reader, bytes + index, run);
+                index += run;
+                if (index < length) {
+                    if (bytes[index] == '\\') {
+                        reader->state = KYCReaderStateEscape;
+                    } else {
+                        KYCReaderFinishString(reader);
+                    }
+                    index++;
+                }
+                break;
+            }
+            case KYCReaderStateEscape:
+                // Escaped slash is part of base64. Anything else is line wrapping.
+                if (bytes[index] == '/' || !reader->stringIsImage) {
+                    KYCReaderAppendString(reader, bytes + index, 1);
+                }
+                reader->state = KYCReaderStateString;
+                index++;
+                break;
+            default:
+                KYCReaderStructural(reader, bytes[index]);
+                index++;
+                break;
+        }
+    }
+}
+
+/**
+ Reads whole response delivered in network sized pieces.
+ 
+ @return Number of decoded images or -1 if response could not be read.
+ */
+static long KYCReplayResponse(KYCResponseReader *reader, const uint8_t *document, size_t length) {
+    for (size_t loopOffset = 0; loopOffset < length; loopOffset += kNetworkChunkSize) {
+        size_t part = length - loopOffset < kNetworkChunkSize ? length - loopOffset : kNetworkChunkSize;
+        KYCReaderAppend(reader, document + loopOffset, part);
+    }
+    
+    return reader->failed || reader->depth || reader->state != KYCReaderStateStructural ? -1 : (long)reader->images;
+}
+
+// MARK: - Tests
+
+static void KYCCheck(KYCBenchmark *benchmark, bool condition, const char *format, ...) {
+    if (condition) {
+        return;
+    }
+    
+    va_list arguments;
+    va_start(arguments, format);
+    fprintf(stderr, "FAIL: ");
+    vfprintf(stderr, format, arguments);
+    fprintf(stderr, "\n");
+    va_end(arguments);
+    benchmark->failures++;
+}
+
+/**
+ Decodes text split into two pieces.
+ 
+ @return Decoded length or -1 if text is not valid.
+ */
+static long KYCDecodeSplit(const char *text, size_t length, size_t split, uint8_t *output) {
+    KYCCodecBase64Decoder decoder;
+    KYCCodecBase64DecoderInit(&decoder);
+    
+    size_t retValue = KYCCodecBase64DecoderUpdate(&decoder, (const uint8_t *)text, split, output);
+    retValue += KYCCodecBase64DecoderUpdate(&decoder, (const uint8_t *)text + split, length - split, output + retValue);
+    retValue += KYCCodecBase64DecoderFinish(&decoder, output + retValue);
+    
+    return decoder.failed ? -1 : (long)retValue;
+}
+
+static void KYCTestVectors(KYCBenchmark *benchmark) {
+    // RFC 4648 test vectors.
+    static const char *kPlain[]     = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    static const char *kEncoded[]   = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    for (size_t loopIndex = 0; loopIndex < sizeof(kPlain) / sizeof(*kPlain); loopIndex++) {
+        uint8_t output[16];
+        size_t  length = KYCCodecBase64Encode((const uint8_t *)kPlain[loopIndex], strlen(kPlain[loopIndex]), output);
+        KYCCheck(benchmark, length == strlen(kEncoded[loopIndex]) && !memcmp(output, kEncoded[loopIndex], length),
+                 "Encoding of '%s'.", kPlain[loopIndex]);
+        KYCCheck(benchmark, length == KYCCodecBase64EncodedLength(strlen(kPlain[loopIndex])),
+                 "Encoded length of '%s'.", kPlain[loopIndex]);
+        
+        long decoded = KYCDecodeSplit(kEncoded[loopIndex], strlen(kEncoded[loopIndex]), 0, output);
+        KYCCheck(benchmark, decoded == (long)strlen(kPlain[loopIndex]) && !memcmp(output, kPlain[loopIndex], (size_t)decoded),
+                 "Decoding of '%s'.", kEncoded[loopIndex]);
+    }
+}
+
+static void KYCTestDecoderRules(KYCBenchmark *benchmark) {
+    static const struct {
+        const char  *text;
+        const char  *plain;     // NULL if text is not valid.
+    } kCases[] = {
+        {"Zg", "f"},                // Missing padding is tolerated.
+        {"Zm8", "fo"},
+        {"Zg=", "f"},
+        {"Zm9v\r\nYmFy", "foobar"}, // Line wrapping is ignored.
+        {"Zm 9v\tYg", "foob"},
+        {"Zm9vY", NULL},            // Single extra character.
+        {"Zm9vY=", NULL},
+        {"=", NULL},                // Padding without data.
+        {"Zm9v=", NULL},
+        {"Zg===", NULL},            // Too much padding.
+        {"Zg==Zg==", NULL},         // Data after padding.
+        {"Zm8=Zg", NULL},
+    };
+    
+    for (size_t loopIndex = 0; loopIndex < sizeof(kCases) / sizeof(*kCases); loopIndex++) {
+        const char  *text   = kCases[loopIndex].text;
+        const char  *plain  = kCases[loopIndex].plain;
+        for (size_t loopSplit = 0; loopSplit <= strlen(text); loopSplit++) {
+            uint8_t output[16];
+            long    decoded = KYCDecodeSplit(text, strlen(text), loopSplit, output);
+            if (plain) {
+                KYCCheck(benchmark, decoded == (long)strlen(plain) && !memcmp(output, plain, (size_t)decoded),
+                         "Decoding of '%s' split at %zu.", text, loopSplit);
+            } else {
+                KYCCheck(benchmark, decoded == -1, "Invalid '%s' split at %zu was accepted.", text, loopSplit);
+            }
+        }
+    }
+}
+
+static void KYCTestRoundTrip(KYCBenchmark *benchmark) {
+    uint8_t image[300];
+    uint8_t encoded[400];
+    uint8_t decoded[300];
+    KYCFillImage(image, sizeof(image));
+    
+    for (size_t loopLength = 0; loopLength <= sizeof(image); loopLength++) {
+        // Chunks dividable by 3 concatenate to the same text as single encoding.
+        size_t length = KYCCodecBase64Encode(image, loopLength, encoded);
+        size_t chunked = 0;
+        for (size_t loopOffset = 0; loopOffset < loopLength; loopOffset += 9) {
+            uint8_t chunk[12];
+            size_t  part    = loopLength - loopOffset < 9 ? loopLength - loopOffset : 9;
+            size_t  written = KYCCodecBase64Encode(image + loopOffset, part, chunk);
+            KYCCheck(benchmark, !memcmp(chunk, encoded + chunked, written), "Chunked encoding of %zu bytes.", loopLength);
+            chunked += written;
+        }
+        KYCCheck(benchmark, chunked == length, "Chunked encoding length of %zu bytes.", loopLength);
+        
+        // Split anywhere, even inside of quadruplet.
+        for (size_t loopSplit = 0; loopSplit <= length; loopSplit += loopLength < 64 ? 1 : 7) {
+            long result = KYCDecodeSplit((const char *)encoded, length, loopSplit, decoded);
+            KYCCheck(benchmark, result == (long)loopLength && !memcmp(decoded, image, loopLength),
+                     "Round trip of %zu bytes split at %zu.", loopLength, loopSplit);
+        }
+    }
+}
+
+static void KYCTestStringRun(KYCBenchmark *benchmark) {
+    static const struct {
+        const char  *text;
+        size_t      run;
+    } kCases[] = {
+        {"", 0},
+        {"abc", 3},
+        {"\"", 0},
+        {"ab\"c", 2},
+        {"a\\b\"", 1},
+        {"abcdefgh\\", 8},
+        {"abcdefghi\"", 9},
+    };
+    
+    for (size_t loopIndex = 0; loopIndex < sizeof(kCases) / sizeof(*kCases); loopIndex++) {
+        size_t run = KYCCodecJSONStringRun((const uint8_t *)kCases[loopIndex].text, strlen(kCases[loopIndex].text));
+        KYCCheck(benchmark, run == kCases[loopIndex].run, "String run of '%s' is %zu.", kCases[loopIndex].text, run);
+    }
+}
+
+/**
+ Replays small bodies of every request template and reads them back as response.
+ */
+static void KYCTestReplay(KYCBenchmark *benchmark) {
+    static const size_t kSizes[] = {1, 2, 3, 100, kBase64ChunkSize - 1, kBase64ChunkSize, kBase64ChunkSize + 1, 100000};
+    for (size_t loopTemplate = 0; loopTemplate < benchmark->requestCount; loopTemplate++) {
+        const KYCTemplate *template = &benchmark->requests[loopTemplate];
+        for (size_t loopSize = 0; loopSize < sizeof(kSizes) / sizeof(*kSizes); loopSize++) {
+            size_t  size            = kSizes[loopSize];
+            size_t  contentLength   = KYCRequestContentLength(template, size);
+            uint8_t *body           = KYCAllocate(contentLength);
+            
+            KYCSinkReset(&sSink, body, contentLength);
+            size_t length = KYCReplayRequest(template, benchmark->image, size, benchmark->chunk, &sSink);
+            KYCCheck(benchmark, length == contentLength, "%s with %zu bytes: body length %zu, content length %zu.",
+                     template->name, size, length, contentLength);
+            
+            // Body must be the same as expanded template, which encodes every image at once.
+            uint8_t *expected = KYCAllocate(KYCMaxResponseLength(template, size));
+            size_t  expectedLength = KYCExpandResponse(template, benchmark->image, size, expected);
+            KYCCheck(benchmark, length == expectedLength && !memcmp(body, expected, length), "%s with %zu bytes: body differs.",
+                     template->name, size);
+            
+            KYCResponseReader reader;
+            KYCReaderReset(&reader, kRequestImageKeys, benchmark->decoded, benchmark->decodedCapacity);
+            reader.image        = benchmark->image;
+            reader.imageLength  = size;
+            reader.verify       = true;
+            long images = KYCReplayResponse(&reader, body, length);
+            KYCCheck(benchmark, images == (long)template->imageCount, "%s with %zu bytes: %ld of %zu images read back.",
+                     template->name, size, images, template->imageCount);
+            
+            free(expected);
+            free(body);
+        }
+    }
+}
+
+// MARK: - Benchmark
+
+static unsigned long long KYCOpsForBytes(const KYCBenchmark *benchmark, size_t bytes) {
+    unsigned long long retValue = (unsigned long long)(benchmark->targetMB * 1024 * 1024 / (bytes ? bytes : 1));
+    return retValue < kMinOps ? kMinOps : retValue;
+}
+
+static void KYCReport(KYCBenchmark *benchmark, KYCPhaseTotals *totals, const char *phase, const char *name, size_t imageLength,
+                      size_t bytes, unsigned long long ops, unsigned long long elapsed, unsigned long long allocations) {
+    totals->bytes       += bytes * ops;
+    totals->elapsed     += elapsed;
+    totals->ops         += ops;
+    totals->allocations += allocations;
+    benchmark->peakKB   = KYCPeakMemoryKB();
+    
+    printf("%-9s %-28s %9zu %10zu %7llu %13.0f %8.3f %9.2f %9ld\n", phase, name, imageLength, bytes, ops, (double)elapsed / ops,
+           (double)elapsed / ((double)bytes * ops), kAllocationsCounted ? (double)allocations / ops : -1., benchmark->peakKB);
+}
+
+static void KYCBenchmarkRequests(KYCBenchmark *benchmark) {
+    for (size_t loopTemplate = 0; loopTemplate < benchmark->requestCount; loopTemplate++) {
+        const KYCTemplate *template = &benchmark->requests[loopTemplate];
+        for (size_t loopSize = 0; loopSize < benchmark->imageSizeCount; loopSize++) {
+            size_t size             = benchmark->imageSizes[loopSize];
+            size_t contentLength    = KYCRequestContentLength(template, size);
+            
+            // Warm up and check the length.
+            KYCSinkReset(&sSink, NULL, 0);
+            KYCCheck(benchmark, KYCReplayRequest(template, benchmark->image, size, benchmark->chunk, &sSink) == contentLength,
+                     "%s with %zu bytes: body length does not match content length.", template->name, size);
+            
+            unsigned long long  ops         = KYCOpsForBytes(benchmark, contentLength);
+            unsigned long long  allocations = sAllocations;
+            unsigned long long  start       = KYCNow();
+            for (unsigned long long loopOp = 0; loopOp < ops; loopOp++) {
+                KYCSinkReset(&sSink, NULL, 0);
+                KYCReplayRequest(template, benchmark->image, size, benchmark->chunk, &sSink);
+            }
+            unsigned long long  elapsed     = KYCNow() - start;
+            
+            KYCReport(benchmark, &benchmark->requestTotals, "request", template->name, size, contentLength, ops, elapsed,
+                      sAllocations - allocations);
+        }
+    }
+}
+
+static void KYCBenchmarkResponses(KYCBenchmark *benchmark) {
+    for (size_t loopTemplate = 0; loopTemplate < benchmark->responseCount; loopTemplate++) {
+        const KYCTemplate *template = &benchmark->responses[loopTemplate];
+        for (size_t loopSize = 0; loopSize < benchmark->imageSizeCount; loopSize++) {
+            size_t size     = benchmark->imageSizes[loopSize];
+            size_t length   = KYCExpandResponse(template, benchmark->image, size, benchmark->document);
+            
+            // Warm up and check every decoded image.
+            KYCResponseReader reader;
+            KYCReaderReset(&reader, kResponseImageKeys, benchmark->decoded, benchmark->decodedCapacity);
+            reader.image        = benchmark->image;
+            reader.imageLength  = size;
+            reader.verify       = true;
+            long images = KYCReplayResponse(&reader, benchmark->document, length);
+            KYCCheck(benchmark, images == (long)template->imageCount, "%s with %zu bytes: %ld of %zu images read.",
+                     template->name, size, images, template->imageCount);
+            
+            unsigned long long  ops         = KYCOpsForBytes(benchmark, length);
+            unsigned long long  allocations = sAllocations;
+            unsigned long long  start       = KYCNow();
+            for (unsigned long long loopOp = 0; loopOp < ops; loopOp++) {
+                KYCReaderReset(&reader, kResponseImageKeys, benchmark->decoded, benchmark->decodedCapacity);
+                KYCReplayResponse(&reader, benchmark->document, length);
+            }
+            unsigned long long  elapsed     = KYCNow() - start;
+            
+            KYCReport(benchmark, &benchmark->responseTotals, "response", template->name, size, length, ops, elapsed,
+                      sAllocations - allocations);
+        }
+    }
+}
+
+static double KYCMetric(const KYCBenchmark *benchmark, const char *phase, const char *metric, bool *known) {
+    const KYCPhaseTotals *totals = NULL;
+    if (!strcmp(phase, "request")) {
+        totals = &benchmark->requestTotals;
+    } else if (!strcmp(phase, "response")) {
+        totals = &benchmark->responseTotals;
+    }
+    
+    *known = true;
+    if (totals && !strcmp(metric, "ns_per_byte")) {
+        return totals->bytes ? (double)totals->elapsed / totals->bytes : 0.;
+    } else if (totals && !strcmp(metric, "ns_per_op")) {
+        return totals->ops ? (double)totals->elapsed / totals->ops : 0.;
+    } else if (totals && !strcmp(metric, "allocs_per_op")) {
+        // Not available without wrapped allocator. Never fails.
+        *known = kAllocationsCounted;
+        return totals->ops ? (double)totals->allocations / totals->ops : 0.;
+    } else if (!strcmp(phase, "all") && !strcmp(metric, "peak_growth_kb")) {
+        return (double)(benchmark->peakKB - benchmark->baselineKB);
+    }
+    
+    KYCDie("Unknown threshold %s %s.", phase, metric);
+    return 0.;
+}
+
+static void KYCCheckThresholds(KYCBenchmark *benchmark) {
+    KYCThreshold    thresholds[kMaxThresholds];
+    size_t          count = KYCLoadThresholds(benchmark->thresholdsPath, thresholds);
+    
+    printf("\n%-9s %-16s %12s %12s\n", "phase", "metric", "value", "limit");
+    for (size_t loopIndex = 0; loopIndex < count; loopIndex++) {
+        const KYCThreshold  *threshold = &thresholds[loopIndex];
+        bool                known;
+        double              value = KYCMetric(benchmark, threshold->phase, threshold->metric, &known);
+        if (!known) {
+            printf("%-9s %-16s %12s %12.3f  skipped\n", threshold->phase, threshold->metric, "n/a", threshold->limit);
+            continue;
+        }
+        
+        bool passed = value <= threshold->limit;
+        printf("%-9s %-16s %12.3f %12.3f  %s\n", threshold->phase, threshold->metric, value, threshold->limit, passed ? "ok" : "FAIL");
+        KYCCheck(benchmark, passed, "Threshold %s %s exceeded: %.3f > %.3f.", threshold->phase, threshold->metric, value, threshold->limit);
+    }
+}
+
+// MARK: - Main
+
+static void KYCParseArguments(KYCBenchmark *benchmark, int argc, char **argv) {
+    benchmark->targetMB = kDefaultTargetMB;
+    for (int loopIndex = 1; loopIndex < argc; loopIndex++) {
+        const char *argument    = argv[loopIndex];
+        const char *value       = loopIndex + 1 < argc ? argv[loopIndex + 1] : NULL;
+        if (!strcmp(argument, "--test")) {
+            benchmark->test = true;
+            continue;
+        } else if (!value) {
+            KYCDie("Missing value of %s.", argument);
+        } else if (!strcmp(argument, "--corpus")) {
+            benchmark->corpus = value;
+        } else if (!strcmp(argument, "--thresholds")) {
+            benchmark->thresholdsPath = value;
+        } else if (!strcmp(argument, "--target-mb")) {
+            benchmark->targetMB = atof(value);
+        } else {
+            KYCDie("Unknown argument %s.", argument);
+        }
+        loopIndex++;
+    }
+    
+    if (!benchmark->corpus || benchmark->targetMB <= 0) {
+        KYCDie("Usage: %s --corpus <dir> [--test] [--thresholds <file>] [--target-mb <MiB per case>]", argv[0]);
+    }
+}
+
+static void KYCPrepare(KYCBenchmark *benchmark) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/requests", benchmark->corpus);
+    benchmark->requestCount = KYCLoadTemplates(path, benchmark->requests);
+    snprintf(path, sizeof(path), "%s/responses", benchmark->corpus);
+    benchmark->responseCount = KYCLoadTemplates(path, benchmark->responses);
+    KYCLoadImageSizes(benchmark);
+    
+    // Tests use their own sizes. Buffers must fit both.
+    if (benchmark->maxImageSize < 2 * kBase64ChunkSize + 1) {
+        benchmark->maxImageSize = 2 * kBase64ChunkSize + 1;
+    }
+    
+    // Every image of all cases is a prefix of the same data. Responses are expanded to the same buffer.
+    benchmark->image            = KYCAllocate(benchmark->maxImageSize);
+    benchmark->chunk            = KYCAllocate(KYCCodecBase64EncodedLength(kBase64ChunkSize));
+    benchmark->decodedCapacity  = KYCCodecBase64DecoderMaxOutput(2 * KYCCodecBase64EncodedLength(benchmark->maxImageSize));
+    benchmark->decoded          = KYCAllocate(benchmark->decodedCapacity);
+    KYCFillImage(benchmark->image, benchmark->maxImageSize);
+    
+    for (size_t loopTemplate = 0; loopTemplate < benchmark->responseCount; loopTemplate++) {
+        size_t length = KYCMaxResponseLength(&benchmark->responses[loopTemplate], benchmark->maxImageSize);
+        if (length > benchmark->documentCapacity) {
+            benchmark->documentCapacity = length;
+        }
+    }
+    benchmark->document = KYCAllocate(benchmark->documentCapacity);
+}
+
+int main(int argc, char **argv) {
+    KYCBenchmark *benchmark = &sBenchmark;
+    KYCParseArguments(benchmark, argc, argv);
+    KYCPrepare(benchmark);
+    
+    if (benchmark->test) {
+        KYCTestVectors(benchmark);
+        KYCTestDecoderRules(benchmark);
+        KYCTestRoundTrip(benchmark);
+        KYCTestStringRun(benchmark);
+        KYCTestReplay(benchmark);
+        printf("%s\n", benchmark->failures ? "FAILED" : "PASSED");
+        return benchmark->failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    
+    printf("%-9s %-28s %9s %10s %7s %13s %8s %9s %9s\n", "phase", "case", "image B", "bytes", "ops", "ns/op", "ns/byte",
+           "allocs/op", "peak KB");
+    
+    // Everything the harness needs is allocated and touched. Any further growth comes from the replayed code.
+    benchmark->baselineKB = KYCPeakMemoryKB();
+    KYCBenchmarkRequests(benchmark);
+    KYCBenchmarkResponses(benchmark);
+    printf("\nPeak memory: %ld KB, growth during run: %ld KB.\n", benchmark->peakKB, benchmark->peakKB - benchmark->baselineKB);
+    
+    if (benchmark->thresholdsPath) {
+        KYCCheckThresholds(benchmark);
+    }
+    printf("%s\n", benchmark->failures ? "FAILED" : "PASSED");
+    return benchmark->failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
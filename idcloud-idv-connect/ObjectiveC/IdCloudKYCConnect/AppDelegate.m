@@ -21,6 +21,11 @@
  */
 
 #import "AppDelegate.h"
+#import "KYCBackgroundTransport.h"
+#import "KYCTrace.h"
+#import "KYCCommunication.h"
+#import "KYCLoopbackTransport.h"
+#import "KYCBlobUploader.h"
 
 @interface AppDelegate()
 
@@ -40,9 +45,36 @@
     // Load proper VC based on SDK state.
     [[KYCManager sharedInstance] updateRootViewController];
     
+    // Spans are recorded only when tracing is compiled in.
+    if (CFG_IDCLOUD_TRACE) {
+        [KYCTrace addSink:[KYCTraceSignpostSink sinkWithSubsystem:[NSBundle mainBundle].bundleIdentifier]];
+        [KYCTrace addSink:[KYCTraceRecorder sharedInstance]];
+        [KYCTrace setEnabled:YES];
+    }
+    
+    // Verification backend is emulated in process. Must be set before any pending verification is resumed.
+    if (CFG_IDCLOUD_LOOPBACK) {
+        [KYCCommunication setTransport:[KYCLoopbackTransport transportWithSeed:CFG_IDCLOUD_LOOPBACK_SEED]];
+        [KYCCommunication setBaseURL:[KYCLoopbackTransport baseURL]];
+        [KYCBlobUploader sharedInstance].stagingURL = [KYCLoopbackTransport stagingURL];
+    }
+
+    // Reconnect to background uploads started before the app was terminated.
+    if (CFG_IDCLOUD_BACKGROUND_UPLOAD) {
+        [[KYCBackgroundTransport sharedInstance] resumePendingSessions];
+    }
+    
     return YES;
 }
 
+- (void)application:(UIApplication *)application
+handleEventsForBackgroundURLSession:(NSString *)identifier
+  completionHandler:(void (^)(void))completionHandler {
+    // App was relaunched in background to finish verification upload.
+    [[KYCBackgroundTransport sharedInstance] handleEventsForBackgroundURLSession:identifier
+                                                              completionHandler:completionHandler];
+}
+
 - (void)applicationWillResignActive:(UIApplication *)application {
     //ios 8 FP calls resign active & become active sequentially, so app blicks. To avoid this state, skipNextResignActive is used for Touch ID flows
     if(!_skipNextResignActive) {
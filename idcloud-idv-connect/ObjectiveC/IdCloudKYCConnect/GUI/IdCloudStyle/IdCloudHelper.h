@@ -31,9 +31,4 @@ Please make sure to review our IdCloud documentation, including security guideli
            inParent:(UIView *)parent
           withDelay:(CGFloat*)delay;
 
-+ (NSData *)imageFromBase64:(NSString *)base64;
-
-+ (UIImage*)imageWithImage:(UIImage*)sourceImage
-             scaledToWidth:(CGFloat)width;
-
 @end
@@ -79,28 +79,4 @@ Please make sure to review our IdCloud documentation, including security guideli
     }
 }
 
-+ (NSData *)imageFromBase64:(NSString *)base64 {
-    if (base64 && base64.length) {
-        return [[NSData alloc] initWithBase64EncodedString:base64 options:0];
-    } else {
-        return nil;
-    }
-}
-
-+ (UIImage*)imageWithImage:(UIImage*)sourceImage
-             scaledToWidth:(CGFloat)width
-{
-    CGFloat oldWidth = sourceImage.size.width;
-    CGFloat scaleFactor = width / oldWidth;
-
-    CGFloat newHeight = sourceImage.size.height * scaleFactor;
-    CGFloat newWidth = oldWidth * scaleFactor;
-
-    UIGraphicsBeginImageContext(CGSizeMake(newWidth, newHeight));
-    [sourceImage drawInRect:CGRectMake(0, 0, newWidth, newHeight)];
-    UIImage *newImage = UIGraphicsGetImageFromCurrentImageContext();
-    UIGraphicsEndImageContext();
-    return newImage;
-}
-
 @end
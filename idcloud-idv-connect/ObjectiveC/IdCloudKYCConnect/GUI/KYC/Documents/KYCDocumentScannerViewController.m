@@ -28,10 +28,13 @@
 #import <AcuantIPLiveness/AcuantIPLiveness-Swift.h>
 #import "KYCFaceIdTutorialViewController.h"
 #import "KYCOverviewViewController.h"
+#import "KYCImageScaler.h"
+#import "KYCTrace.h"
 
 @interface KYCDocumentScannerViewController () <CameraCaptureDelegate>
 
 @property (nonatomic, assign) KYCDocumentType documentType;
+@property (nonatomic, strong) KYCTraceSpan    *captureSpan;
 
 @end
 
@@ -96,6 +99,9 @@
 }
 
 - (void)showDocumentCaptureCamera {
+    [_captureSpan end];
+    self.captureSpan = [KYCTrace beginSpanWithName:@"documentCapture" category:kTraceCategoryCapture];
+    
     [self requestAccesSync:^{
         DocumentCameraController *documentCameraController = [DocumentCameraController getCameraControllerWithDelegate:self
                                                                                                          cameraOptions:[self getCameraOptions]];
@@ -128,19 +134,24 @@
 - (void)setCapturedImageWithImage:(Image * _Nonnull)image
                     barcodeString:(NSString *)barcodeString {
     // Hide current scanner.
+    [_captureSpan end];
     _shouldAnimate = NO;
     [self dismissViewControllerAnimated:YES completion:nil];
     
     // Get manager and crop image.
+    KYCTraceSpan *cropSpan = [KYCTrace beginSpanWithName:@"documentCrop" category:kTraceCategoryImage];
     KYCManager  *manager        = [KYCManager sharedInstance];
     Image       *croppedImage   = [self getCropedImage:image];
+    [cropSpan end];
     
     if (!croppedImage.image || (croppedImage.error && croppedImage.error.errorCode == AcuantErrorCodes.ERROR_LowResolutionImage)) {
         [self tryAgainWithMessage:croppedImage.error.errorDescription];
     } else {
         // Check image sharpness, glare and minimum DPI.
+        KYCTraceSpan *qualitySpan = [KYCTrace beginSpanWithName:@"documentQuality" category:kTraceCategoryImage];
         NSInteger sharpness = [AcuantImagePreparation sharpnessWithImage:croppedImage.image];
         NSInteger glare     = [AcuantImagePreparation glareWithImage:croppedImage.image];
+        [qualitySpan end];
         if (sharpness < CaptureConstants.SHARPNESS_THRESHOLD || glare < CaptureConstants.GLARE_THRESHOLD ||
             croppedImage.dpi < CaptureConstants.MANDATORY_RESOLUTION_THRESHOLD_SMALL) {
             NSString *message = [NSString stringWithFormat:@"Image did not meet basic criteria.\nSharpness: %ld(%ld)\nGlare: %ld(%ld)\nDPI: %ld(%ld)",
@@ -149,25 +160,42 @@
                                  croppedImage.dpi, CaptureConstants.MANDATORY_RESOLUTION_THRESHOLD_SMALL];
             [self tryAgainWithMessage:message];
         } else {
-            UIImage *scaledImage = croppedImage.image;
-            if (scaledImage.size.width > KYCManager.sharedInstance.maxImageWidth) {
-                scaledImage = [IdCloudHelper imageWithImage:scaledImage scaledToWidth:KYCManager.sharedInstance.maxImageWidth];
-            }
-            
-            NSData *croppedImageData = UIImageJPEGRepresentation(scaledImage, 1.f);
-            // Update current step.
-            if (_documentType == KYCDocumentTypeIdCard && manager.scannedDocFront) {
-                manager.scannedDocBack = croppedImageData;
-                [self nextStepAfterDocumentScanning];
-            } else {
-                manager.scannedDocFront = croppedImageData;
-                if (_documentType == KYCDocumentTypePassport) {
-                    [self nextStepAfterDocumentScanning];
-                } else {
-                    // First page is scanned continue with another one.
-                    [self showDocumentCaptureCamera];
-                }
+            // Scale and encode on background queue. Quality is lowered to fit the budget, but image must stay sharp.
+            __weak __typeof(self) weakSelf = self;
+            KYCTraceSpan *encodeSpan = [KYCTrace beginSpanWithName:@"documentEncode" category:kTraceCategoryImage];
+            [KYCImageScaler jpegFromImage:croppedImage.image
+                                 maxWidth:manager.maxImageWidth
+                               byteBudget:MAX(manager.imageSizeBudget, 0) * 1024
+                                validator:^BOOL(NSData *data) {
+                return [AcuantImagePreparation sharpnessWithImage:[UIImage imageWithData:data]] >= CaptureConstants.SHARPNESS_THRESHOLD;
             }
+                               completion:^(NSData *data) {
+                [encodeSpan setArgument:@(data.length) forKey:@"bytes"];
+                [encodeSpan end];
+                [weakSelf storeScannedDocument:[KYCImageBuffer bufferWithData:data]];
+            }];
+        }
+    }
+}
+
+- (void)storeScannedDocument:(KYCImageBuffer *)document {
+    if (!document) {
+        [self tryAgainWithMessage:@"Failed to process captured image."];
+        return;
+    }
+    
+    // Update current step.
+    KYCManager *manager = [KYCManager sharedInstance];
+    if (_documentType == KYCDocumentTypeIdCard && manager.scannedDocFront) {
+        manager.scannedDocBack = document;
+        [self nextStepAfterDocumentScanning];
+    } else {
+        manager.scannedDocFront = document;
+        if (_documentType == KYCDocumentTypePassport) {
+            [self nextStepAfterDocumentScanning];
+        } else {
+            // First page is scanned continue with another one.
+            [self showDocumentCaptureCamera];
         }
     }
 }
@@ -23,6 +23,7 @@ Please make sure to review our IdCloud documentation, including security guideli
 #import "FaceLivenessCameraController.h"
 #import <AVFoundation/AVFoundation.h>
 #import <CoreText/CoreText.h>
+#import "KYCTrace.h"
 
 @interface FaceLivenessCameraController () <AcuantHGLiveFaceCaptureDelegate>
 
@@ -33,6 +34,7 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (nonatomic, strong) CAShapeLayer                  *faceOval;
 @property (nonatomic, strong) CATextLayer                   *blinkLabel;
 @property (nonatomic, assign) CGFloat                        currentFrameTime;
+@property (nonatomic, strong) KYCTraceSpan                  *captureSpan;
 
 @end
 
@@ -104,6 +106,7 @@ Please make sure to review our IdCloud documentation, including security guideli
     self.captureSession = [AcuantHGLiveness getFaceCaptureSessionWithDelegate:self
                                                                 captureDevice:captureDevice];
     [_captureSession start];
+    self.captureSpan = [KYCTrace beginSpanWithName:@"faceCapture" category:kTraceCategoryCapture];
 
     self.videoPreviewLayer = [AVCaptureVideoPreviewLayer layerWithSession:_captureSession];
     _videoPreviewLayer.videoGravity = AVLayerVideoGravityResizeAspectFill;
@@ -274,6 +277,7 @@ Please make sure to review our IdCloud documentation, including security guideli
 
         if (liveFaceDetails.isLiveFace && !_captured) {
             _captured = YES;
+            [_captureSpan end];
             [_delegate liveFaceCapturedWithImage:liveFaceDetails.image];
         }
     } else if(!liveFaceDetails || !liveFaceDetails.faceRect) {
@@ -23,6 +23,7 @@
 #import "KYCFaceIdTutorialViewController.h"
 #import "FaceLivenessCameraController.h"
 #import "KYCOverviewViewController.h"
+#import "KYCTrace.h"
 
 
 @interface KYCFaceIdTutorialViewController () <UIScrollViewDelegate, AcuantHGLivenessDelegate>
@@ -144,7 +145,9 @@
 // MARK: - AcuantHGLivenessDelegate
 
 - (void)liveFaceCapturedWithImage:(UIImage *)image {
-    [KYCManager sharedInstance].scannedPortrait = UIImagePNGRepresentation(image);
+    KYCTraceSpan *encodeSpan = [KYCTrace beginSpanWithName:@"portraitEncode" category:kTraceCategoryImage];
+    [KYCManager sharedInstance].scannedPortrait = [KYCImageBuffer bufferWithData:UIImagePNGRepresentation(image)];
+    [encodeSpan end];
     
     _shouldAnimate = NO;
     [self dismissViewControllerAnimated:YES completion:nil];
@@ -22,6 +22,11 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 #import "KYCOverviewViewController.h"
 #import "KYCCommunication.h"
+#import "KYCBackgroundTransport.h"
+#import "KYCTrace.h"
+
+// Fallback size of thumbnails in points. Used before the layout is finished.
+#define kThumbnailMinSize 128.f
 
 @interface KYCOverviewViewController()
 
@@ -71,6 +76,13 @@ Please make sure to review our IdCloud documentation, including security guideli
     [IdCloudHelper animateView:_imageStatus inParent:self.view withDelay:&delay];
     [IdCloudHelper animateView:_labelStatus inParent:self.view withDelay:&delay];
     [IdCloudHelper animateView:_buttonNext inParent:self.view withDelay:kZeroDelay];
+    
+    // Verification started before app was terminated can finish while this screen is displayed.
+    // Unregistration is done in base class.
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(onVerificationRestored:)
+                                                 name:kNotificationVerificationRestored
+                                               object:nil];
 }
 
 // MARK: - MainViewController
@@ -93,8 +105,11 @@ Please make sure to review our IdCloud documentation, including security guideli
     } completion:nil];
 }
 
-- (void)loadOrHideImage:(NSData *)image view:(UIImageView *)view {
-    [view setImage:[UIImage imageWithData:image]];
+- (void)loadOrHideImage:(KYCImageBuffer *)image view:(UIImageView *)view {
+    // Decode only what is displayed. Full resolution image stays encoded for upload.
+    CGSize  size            = view.bounds.size;
+    CGFloat maxPixelSize    = MAX(MAX(size.width, size.height), kThumbnailMinSize) * [UIScreen mainScreen].scale;
+    [view setImage:[image thumbnailWithMaxPixelSize:maxPixelSize]];
     [view setHidden:!image];
 }
 
@@ -145,7 +160,7 @@ Please make sure to review our IdCloud documentation, including security guideli
     _imageStatus.tintColor  = [UIColor greenColor];
 
     // Update extracted portrait.
-    [self loadOrHideImage:response.document.portrait view:self.imagePortraitExtracted];
+    [self loadOrHideImage:[KYCImageBuffer bufferWithData:response.document.portrait] view:self.imagePortraitExtracted];
     
     // Animate result part.
     [self showOrHideResultArea:YES animated:YES];
@@ -235,9 +250,9 @@ Please make sure to review our IdCloud documentation, including security guideli
     
     // Send data to server and wait for response.
     __weak __typeof(self) weakSelf = self;
-    [KYCCommunication verifyDocumentFront:manager.scannedDocFront
-                             documentBack:manager.scannedDocBack
-                                   selfie:manager.scannedPortrait
+    [KYCCommunication verifyDocumentFront:manager.scannedDocFront.data
+                             documentBack:manager.scannedDocBack.data
+                                   selfie:manager.scannedPortrait.data
                         completionHandler:^(KYCResponse *response, NSString *error) {
         // UI is already gone.
         if (!weakSelf) {
@@ -246,18 +261,32 @@ Please make sure to review our IdCloud documentation, including security guideli
         
         // Hide loading indicator and unblock UI.
         [weakSelf loadingIndicatorHide];
-        
-        if (response) {
-            [weakSelf displayResult:response];
+        [weakSelf displayResponse:response error:error];
+    }];
+}
+
+- (void)onVerificationRestored:(NSNotification *)notification {
+    [self loadingIndicatorHide];
+    [self displayResponse:notification.userInfo[kNotificationVerificationRestoredResponse]
+                    error:notification.userInfo[kNotificationVerificationRestoredError]];
+}
+
+- (void)displayResponse:(KYCResponse *)response error:(NSString *)error {
+    // Timeline of the whole flow is exported after each verification.
+    if ([KYCTrace isEnabled]) {
+        [[KYCTraceRecorder sharedInstance] writeToURL:[KYCTraceRecorder defaultURL] error:nil];
+    }
+    
+    if (response) {
+        [self displayResult:response];
+    } else {
+        // No response? Display error if we have one, otherwise some generict err message.
+        if (!error) {
+            [self displayError:@"Failed to get valid response from server." response:nil];
         } else {
-            // No response? Display error if we have one, otherwise some generict err message.
-            if (!error) {
-                [weakSelf displayError:@"Failed to get valid response from server." response:nil];
-            } else {
-                [weakSelf displayError:error.description response:nil];
-            }
+            [self displayError:error.description response:nil];
         }
-    }];
+    }
 }
 
 @end
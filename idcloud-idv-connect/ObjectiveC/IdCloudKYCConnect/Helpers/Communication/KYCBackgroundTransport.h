@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCSession.h"
+#import "KYCTransport.h"
+
+#define kNotificationVerificationRestored           @"kNotificationVerificationRestored"
+#define kNotificationVerificationRestoredResponse   @"response"
+#define kNotificationVerificationRestoredError      @"error"
+
+/**
+ Sends verification requests through background {@code NSURLSession}. Upload and server response are handled by
+ the system even if the app is suspended or terminated.
+
+ Every task is tagged with {@code KYCSession} identifier. When the app is relaunched, tasks without a waiting
+ handler restore the persisted session and continue with the next step. Final result of such a session is posted
+ as {@code kNotificationVerificationRestored} with {@code KYCResponse} or error string in user info.
+ */
+@interface KYCBackgroundTransport : NSObject <KYCTransport>
+
+/**
+ Common method to get KYCBackgroundTransport singletone.
+
+ @return Instance of KYCBackgroundTransport class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Release singletone together with all helper class inside.
+ */
++ (void)end;
+
+/**
+ Sends the request. Body is written to file first, because background session can upload only files. Streamed or
+ compressed body is therefore fully encoded before the upload starts, unlike on the regular session.
+
+ @param request Request to be sent.
+ @param session Session which owns the request. Session is persisted, so it can be resumed after relaunch.
+ @param handler Callback. Called on background queue.
+ */
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler;
+
+/**
+ Reconnects to background session after relaunch. Sessions without any running task continue with their current step
+ once the background session delivered all events of tasks finished while the app was not running. If the app was
+ launched in background, that happens only after the system reported the events or the app became active. Must be
+ called on main thread from {@code application:didFinishLaunchingWithOptions:}.
+ */
+- (void)resumePendingSessions;
+
+/**
+ Stores system completion handler. It's called once all events of the background session are delivered.
+
+ @param identifier Background session identifier.
+ @param completionHandler System completion handler.
+ */
+- (void)handleEventsForBackgroundURLSession:(NSString *)identifier
+                          completionHandler:(void (^)(void))completionHandler;
+
+@end
@@ -0,0 +1,345 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCBackgroundTransport.h"
+#import "KYCCommunication.h"
+#import "KYCURLSessionManager.h"
+
+#define kStreamBufferSize (64 * 1024)
+
+static KYCBackgroundTransport *sInstance = nil;
+
+@interface KYCBackgroundTransport() <NSURLSessionDataDelegate>
+
+@property (nonatomic, strong)   NSURLSession                                        *session;
+@property (nonatomic, strong)   NSMutableDictionary<NSNumber *, KYCTransportHandler> *handlers;
+@property (nonatomic, strong)   NSMutableDictionary<NSNumber *, NSMutableData *>    *responses;
+@property (nonatomic, strong)   NSMutableSet<NSString *>                            *restoredIdentifiers;
+@property (nonatomic, copy)     void (^backgroundCompletionHandler)(void);
+@property (nonatomic, assign)   BOOL                                                resumePending;
+
+@end
+
+@implementation KYCBackgroundTransport
+
+// MARK: - Static Helpers
+
++ (instancetype)sharedInstance {
+    @synchronized (self) {
+        if (!sInstance) {
+            sInstance = [[KYCBackgroundTransport alloc] init];
+        }
+        
+        return sInstance;
+    }
+}
+
++ (void)end {
+    @synchronized (self) {
+        [sInstance.session finishTasksAndInvalidate];
+        sInstance = nil;
+    }
+}
+
++ (NSString *)sessionIdentifier {
+    return [NSString stringWithFormat:@"%@.kyc.upload", [NSBundle mainBundle].bundleIdentifier];
+}
+
+// MARK: - Life Cycle
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.handlers   = [NSMutableDictionary new];
+        self.responses              = [NSMutableDictionary new];
+        self.restoredIdentifiers    = [NSMutableSet new];
+        self.session                = [self createUrlSession];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler {
+    // Body can be streamed and encoded on the fly. Do not block the caller while it's written to disk.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        // Session state must be on disk before the task starts. App can be killed any time after that.
+        [session persist];
+        
+        NSError *error;
+        if (![KYCBackgroundTransport writeBody:request toURL:session.bodyFileURL error:&error]) {
+            handler(nil, nil, error);
+            return;
+        }
+        
+        NSURLSessionUploadTask *task = [self.session uploadTaskWithRequest:[self backgroundRequest:request]
+                                                                  fromFile:session.bodyFileURL];
+        task.taskDescription = session.identifier;
+        
+        @synchronized (self) {
+            self.handlers[@(task.taskIdentifier)] = handler;
+        }
+        [task resume];
+    });
+}
+
+- (void)resumePendingSessions {
+    // App launched in background is most likely relaunched to handle events of the background session. System reports
+    // them only after the launch and they may finish some sessions. Wait for them, or for the app to become active
+    // if the launch had other reason.
+    if ([UIApplication sharedApplication].applicationState == UIApplicationStateBackground) {
+        @synchronized (self) {
+            self.resumePending = YES;
+        }
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(resumeStaleSessionsIfPending)
+                                                     name:UIApplicationDidBecomeActiveNotification
+                                                   object:nil];
+        return;
+    }
+    
+    [self resumeStaleSessions];
+}
+
+- (void)handleEventsForBackgroundURLSession:(NSString *)identifier
+                          completionHandler:(void (^)(void))completionHandler {
+    // Not our session. Nothing to wait for.
+    if (![identifier isEqualToString:[KYCBackgroundTransport sessionIdentifier]]) {
+        completionHandler();
+        return;
+    }
+    
+    @synchronized (self) {
+        self.backgroundCompletionHandler = completionHandler;
+    }
+}
+
+// MARK: - Private Helpers
+
+/**
+ Resumes stale sessions if it was postponed by background launch. Only the first call does anything.
+ */
+- (void)resumeStaleSessionsIfPending {
+    BOOL resumePending;
+    @synchronized (self) {
+        resumePending       = _resumePending;
+        self.resumePending  = NO;
+    }
+    
+    if (resumePending) {
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidBecomeActiveNotification object:nil];
+        [self resumeStaleSessions];
+    }
+}
+
+- (void)resumeStaleSessions {
+    [_session getAllTasksWithCompletionHandler:^(NSArray<__kindof NSURLSessionTask *> *tasks) {
+        // Sessions with running task are resumed once the task finishes.
+        NSMutableSet *running = [NSMutableSet new];
+        for (NSURLSessionTask *loopTask in tasks) {
+            if (loopTask.taskDescription) {
+                [running addObject:loopTask.taskDescription];
+            }
+        }
+        
+        // Completion of tasks which finished while the app was not running is already queued on the delegate queue.
+        // Queue behind it, so such sessions continue with the server response instead of repeating the upload.
+        [self.session.delegateQueue addOperationWithBlock:^{
+            // App was terminated between two steps. Repeat the current one.
+            for (NSString *loopIdentifier in [KYCSession persistedIdentifiers]) {
+                if ([running containsObject:loopIdentifier] || ![self claimRestoredIdentifier:loopIdentifier]) {
+                    continue;
+                }
+                
+                KYCSession *session = [KYCBackgroundTransport restoreSession:loopIdentifier];
+                if (session) {
+                    [KYCCommunication resumeSession:session];
+                }
+            }
+        }];
+    }];
+}
+
+/**
+ Each persisted session is restored at most once per launch, either from task completion or as a stale session.
+ 
+ @param identifier Session identifier.
+ 
+ @return {@code True} if the session was not restored yet, else {@code false}.
+ */
+- (BOOL)claimRestoredIdentifier:(NSString *)identifier {
+    @synchronized (self) {
+        if (!identifier || [_restoredIdentifiers containsObject:identifier]) {
+            return NO;
+        }
+        [_restoredIdentifiers addObject:identifier];
+    }
+    
+    return YES;
+}
+
+- (NSURLSession *)createUrlSession {
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:[KYCBackgroundTransport sessionIdentifier]];
+    configuration.sessionSendsLaunchEvents  = YES;
+    configuration.discretionary             = NO;
+    
+    return [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:nil];
+}
+
+- (NSURLRequest *)backgroundRequest:(NSURLRequest *)request {
+    NSMutableURLRequest *retValue   = [request mutableCopy];
+    retValue.HTTPBody               = nil;
+    retValue.HTTPBodyStream         = nil;
+    
+    // Background session outlives credential changes. Use headers of the current regular session for each request.
+    NSDictionary *headers = [KYCURLSessionManager sharedInstance].session.configuration.HTTPAdditionalHeaders;
+    [headers enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        if (![retValue valueForHTTPHeaderField:key]) {
+            [retValue setValue:value forHTTPHeaderField:key];
+        }
+    }];
+    
+    return retValue;
+}
+
++ (BOOL)writeBody:(NSURLRequest *)request toURL:(NSURL *)url error:(NSError **)error {
+    if (!request.HTTPBodyStream) {
+        NSData *body = request.HTTPBody ?: [NSData data];
+        return [body writeToURL:url options:NSDataWritingAtomic error:error];
+    }
+    
+    NSInputStream   *input  = request.HTTPBodyStream;
+    NSOutputStream  *output = [NSOutputStream outputStreamWithURL:url append:NO];
+    uint8_t         *buffer = malloc(kStreamBufferSize);
+    BOOL            success = YES;
+    
+    [input open];
+    [output open];
+    while (success) {
+        NSInteger read = [input read:buffer maxLength:kStreamBufferSize];
+        if (read <= 0) {
+            success = read == 0;
+            break;
+        }
+        
+        for (NSInteger written = 0; written < read && success; ) {
+            NSInteger result = [output write:buffer + written maxLength:read - written];
+            success = result > 0;
+            written += result;
+        }
+    }
+    [input close];
+    [output close];
+    free(buffer);
+    
+    if (!success && error) {
+        *error = input.streamError ?: output.streamError;
+    }
+    
+    return success;
+}
+
++ (KYCSession *)restoreSession:(NSString *)identifier {
+    // Task was not created by this transport.
+    if (!identifier) {
+        return nil;
+    }
+    
+    // Original handler did not survive relaunch. Anyone interested in the result can listen for notification.
+    return [KYCSession restoreWithIdentifier:identifier andHandler:^(KYCResponse *response, NSString *error) {
+        NSMutableDictionary *userInfo = [NSMutableDictionary new];
+        if (response) {
+            [userInfo setObject:response forKey:kNotificationVerificationRestoredResponse];
+        }
+        if (error) {
+            [userInfo setObject:error forKey:kNotificationVerificationRestoredError];
+        }
+        
+        [[NSNotificationCenter defaultCenter] postNotificationName:kNotificationVerificationRestored
+                                                            object:nil
+                                                          userInfo:userInfo];
+    }];
+}
+
+// MARK: - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    @synchronized (self) {
+        NSMutableData *response = _responses[@(dataTask.taskIdentifier)];
+        if (response) {
+            [response appendData:data];
+        } else {
+            _responses[@(dataTask.taskIdentifier)] = [data mutableCopy];
+        }
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    KYCTransportHandler handler;
+    NSData              *data;
+    @synchronized (self) {
+        handler = _handlers[@(task.taskIdentifier)];
+        data    = _responses[@(task.taskIdentifier)];
+        [_handlers removeObjectForKey:@(task.taskIdentifier)];
+        [_responses removeObjectForKey:@(task.taskIdentifier)];
+    }
+    
+    if (handler) {
+        handler(data, task.response, error);
+        return;
+    }
+    
+    // Task was started before the app was terminated. Continue with the persisted session.
+    if (![self claimRestoredIdentifier:task.taskDescription]) {
+        return;
+    }
+    
+    KYCSession *restored = [KYCBackgroundTransport restoreSession:task.taskDescription];
+    if (restored) {
+        [KYCCommunication resumeSession:restored data:data error:error];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [[KYCURLSessionManager sharedInstance] updateCapabilitiesWithMetrics:metrics];
+}
+
+- (void)URLSessionDidFinishEventsForBackgroundURLSession:(NSURLSession *)session {
+    // All finished tasks were delivered. Whatever is still persisted and not running was interrupted between steps.
+    [self resumeStaleSessionsIfPending];
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        void (^completionHandler)(void);
+        @synchronized (self) {
+            completionHandler                   = self.backgroundCompletionHandler;
+            self.backgroundCompletionHandler    = nil;
+        }
+        
+        if (completionHandler) {
+            completionHandler();
+        }
+    });
+}
+
+@end
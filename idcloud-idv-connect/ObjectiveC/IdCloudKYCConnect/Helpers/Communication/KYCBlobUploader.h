@@ -0,0 +1,97 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCSession.h"
+
+/**
+ Blob upload callback.
+ 
+ @param digests Digest of each image under the same key as the image. {@code nil} if upload failed.
+ @param error Communication error.
+ */
+typedef void (^KYCBlobUploadHandler)(NSDictionary<NSString *, NSString *> *digests, NSError *error);
+
+/**
+ Uploads images to content-addressed staging area of the verification backend.
+
+ Image is identified by SHA-256 digest of its content and stored as {@code <stagingURL>/<digest>}. Image already
+ present in the staging area is not uploaded again. Image staged by this instance is used without asking the server
+ only for {@code CFG_IDCLOUD_STAGING_RETENTION_SEC}. Verification steps reference images by digest, so a repeated step
+ or restored session does not upload any image data.
+ */
+@interface KYCBlobUploader : NSObject
+
+/**
+ Staging area URL. Default value is {@code CFG_IDCLOUD_STAGING_URL}.
+ */
+@property (nonatomic, copy)             NSString    *stagingURL;
+
+/**
+ Number of image bytes uploaded to the staging area.
+ */
+@property (nonatomic, assign, readonly) long long   uploadedBytes;
+
+/**
+ Number of image bytes which were already staged and did not have to be uploaded.
+ */
+@property (nonatomic, assign, readonly) long long   reusedBytes;
+
+/**
+ Common method to get KYCBlobUploader singletone.
+
+ @return Instance of KYCBlobUploader class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Release singletone together with all helper class inside.
+ */
++ (void)end;
+
+/**
+ Reference to staged image used in verification JSON instead of image data.
+ 
+ @param digest Image digest.
+ 
+ @return Reference JSON or {@code nil} if digest is {@code nil}.
+ */
++ (NSDictionary *)referenceToDigest:(NSString *)digest;
+
+/**
+ Makes sure all images are present in the staging area. Images are uploaded in parallel. Failed upload is repeated
+ up to {@code CFG_IDCLOUD_STEP_RETRY_COUNT} times.
+ 
+ @param images Images to be staged.
+ @param session Session which owns the images. Repeated uploads are accounted to it.
+ @param handler Callback. Called on background queue.
+ */
+- (void)stageImages:(NSDictionary<NSString *, NSData *> *)images
+            session:(KYCSession *)session
+  completionHandler:(KYCBlobUploadHandler)handler;
+
+/**
+ Stops trusting that images are staged. Next use asks the server again and uploads them if they are missing.
+ 
+ @param digests Digests of images.
+ */
+- (void)forgetDigests:(NSArray<NSString *> *)digests;
+
+@end
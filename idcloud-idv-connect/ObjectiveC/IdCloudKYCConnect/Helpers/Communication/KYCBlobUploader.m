@@ -0,0 +1,220 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCBlobUploader.h"
+#import "KYCCommunication.h"
+#import "KYCURLSessionManager.h"
+#import "KYCBackgroundTransport.h"
+#import <CommonCrypto/CommonDigest.h>
+
+#define kDigestPrefix @"sha256:"
+
+static KYCBlobUploader *sInstance = nil;
+
+@interface KYCBlobUploader()
+
+// Time when each image was last known to be staged.
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, NSDate *>  *staged;
+
+@end
+
+@implementation KYCBlobUploader
+
+// MARK: - Static Helpers
+
++ (instancetype)sharedInstance {
+    @synchronized (self) {
+        if (!sInstance) {
+            sInstance = [[KYCBlobUploader alloc] init];
+        }
+        
+        return sInstance;
+    }
+}
+
++ (void)end {
+    @synchronized (self) {
+        sInstance = nil;
+    }
+}
+
++ (NSDictionary *)referenceToDigest:(NSString *)digest {
+    return digest ? @{@"digest": digest} : nil;
+}
+
+// MARK: - Life Cycle
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.stagingURL = CFG_IDCLOUD_STAGING_URL;
+        self.staged     = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (void)stageImages:(NSDictionary<NSString *, NSData *> *)images
+            session:(KYCSession *)session
+  completionHandler:(KYCBlobUploadHandler)handler {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        KYCTraceSpan        *span       = [session beginTraceSpan:@"stageImages" category:kTraceCategoryNetwork];
+        dispatch_group_t    group       = dispatch_group_create();
+        NSMutableDictionary *digests    = [NSMutableDictionary new];
+        __block NSError     *failure    = nil;
+        
+        for (NSString *loopKey in images) {
+            NSData      *data   = images[loopKey];
+            NSString    *digest = [KYCBlobUploader digestOfData:data];
+            digests[loopKey]    = digest;
+            
+            dispatch_group_enter(group);
+            [self stageData:data digest:digest session:session attempt:0 completionHandler:^(NSError *error) {
+                @synchronized (digests) {
+                    failure = failure ?: error;
+                }
+                dispatch_group_leave(group);
+            }];
+        }
+        
+        dispatch_group_notify(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            [span end];
+            handler(failure ? nil : digests, failure);
+        });
+    });
+}
+
+- (void)forgetDigests:(NSArray<NSString *> *)digests {
+    @synchronized (self) {
+        [_staged removeObjectsForKeys:digests];
+    }
+}
+
+// MARK: - Private Helpers
+
+/**
+ Uploads single image unless it is already staged.
+ 
+ @param data Image data.
+ @param digest Image digest.
+ @param session Session which owns the image.
+ @param attempt Number of already failed uploads.
+ @param handler Callback.
+ */
+- (void)stageData:(NSData *)data
+           digest:(NSString *)digest
+          session:(KYCSession *)session
+          attempt:(NSInteger)attempt
+completionHandler:(void (^)(NSError *error))handler {
+    // Staging area drops images after a while. Trust only recent state, otherwise ask the server.
+    @synchronized (self) {
+        NSDate *stagedDate = _staged[digest];
+        if (stagedDate && -[stagedDate timeIntervalSinceNow] < CFG_IDCLOUD_STAGING_RETENTION_SEC) {
+            _reusedBytes += data.length;
+            handler(nil);
+            return;
+        }
+    }
+    
+    NSURL                   *url        = [[NSURL URLWithString:_stagingURL] URLByAppendingPathComponent:digest];
+    id<KYCTransport>        transport   = [KYCBlobUploader transport];
+    NSMutableURLRequest     *request    = [NSMutableURLRequest requestWithURL:url];
+    
+    // Staging area can still hold the image from previous run of the app. Ask before sending anything.
+    request.HTTPMethod = @"HEAD";
+    [transport sendRequest:request session:session completionHandler:^(NSData *headData, NSURLResponse *headResponse, NSError *headError) {
+        if (!headError && ((NSHTTPURLResponse *)headResponse).statusCode == 200) {
+            [self markStaged:digest bytes:data.length reused:YES];
+            handler(nil);
+            return;
+        }
+        
+        NSMutableURLRequest *upload = [NSMutableURLRequest requestWithURL:url];
+        upload.HTTPMethod           = @"PUT";
+        upload.HTTPBody             = data;
+        [upload setValue:@"application/octet-stream" forHTTPHeaderField:@"Content-Type"];
+        
+        [transport sendRequest:upload session:session completionHandler:^(NSData *putData, NSURLResponse *putResponse, NSError *putError) {
+            NSInteger statusCode = ((NSHTTPURLResponse *)putResponse).statusCode;
+            if (!putError && statusCode >= 200 && statusCode < 300) {
+                [self markStaged:digest bytes:data.length reused:NO];
+                handler(nil);
+                return;
+            }
+            
+            NSError *error = putError ?: [NSError errorWithDomain:NSURLErrorDomain
+                                                             code:NSURLErrorBadServerResponse
+                                                         userInfo:@{NSLocalizedDescriptionKey: @"Failed to upload image."}];
+            if (attempt >= CFG_IDCLOUD_STEP_RETRY_COUNT) {
+                handler(error);
+                return;
+            }
+            
+            // Whole image has to be sent again.
+            [session addRetryOfBytes:data.length];
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((attempt + 1) * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                [self stageData:data digest:digest session:session attempt:attempt + 1 completionHandler:handler];
+            });
+        }];
+    }];
+}
+
+- (void)markStaged:(NSString *)digest bytes:(long long)bytes reused:(BOOL)reused {
+    @synchronized (self) {
+        [_staged setObject:[NSDate date] forKey:digest];
+        if (reused) {
+            _reusedBytes += bytes;
+        } else {
+            _uploadedBytes += bytes;
+        }
+    }
+}
+
+/**
+ Transport used for image upload. Background transport sends one body per session, so images go through regular
+ session in parallel instead.
+ 
+ @return Transport.
+ */
++ (id<KYCTransport>)transport {
+    id<KYCTransport> retValue = [KYCCommunication transport];
+    if ([retValue isKindOfClass:[KYCBackgroundTransport class]]) {
+        retValue = [KYCURLSessionManager sharedInstance];
+    }
+    
+    return retValue;
+}
+
++ (NSString *)digestOfData:(NSData *)data {
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256(data.bytes, (CC_LONG)data.length, digest);
+    
+    NSMutableString *retValue = [NSMutableString stringWithString:kDigestPrefix];
+    for (NSInteger index = 0; index < CC_SHA256_DIGEST_LENGTH; index++) {
+        [retValue appendFormat:@"%02x", digest[index]];
+    }
+    
+    return retValue;
+}
+
+@end
@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#ifndef KYCCodec_h
+#define KYCCodec_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ Portable core of the request building and response parsing path.
+ 
+ Plain C without Foundation, so the same code runs in the application and in the command-line benchmark on any
+ platform. Functions never allocate. Caller provides all buffers, which keeps the hot loops free of per chunk objects.
+ */
+
+// MARK: - Base64 Encoding
+
+/**
+ Returns length of base64 text of given data including padding.
+ 
+ @param length Length of raw data.
+ 
+ @return Length of base64 text.
+ */
+size_t KYCCodecBase64EncodedLength(size_t length);
+
+/**
+ Encodes data to base64 text with padding. Chunks with length dividable by 3 can be simply concatenated.
+ 
+ @param input Raw data.
+ @param length Length of raw data.
+ @param output Buffer with at least {@code KYCCodecBase64EncodedLength(length)} bytes.
+ 
+ @return Number of written bytes.
+ */
+size_t KYCCodecBase64Encode(const uint8_t *input, size_t length, uint8_t *output);
+
+// MARK: - Base64 Decoding
+
+/**
+ State of base64 text decoded piece by piece. Pieces can be split anywhere, even inside of quadruplet.
+ */
+typedef struct {
+    uint32_t    bits;       // Sextets of incomplete quadruplet.
+    unsigned    count;      // Number of sextets in bits.
+    unsigned    padding;    // Number of padding characters still allowed. Set once padding started.
+    bool        padded;     // Padding started. No more data can follow.
+    bool        failed;     // Text is not valid base64. Set permanently.
+} KYCCodecBase64Decoder;
+
+/**
+ Prepares decoder for new text.
+ 
+ @param decoder Decoder.
+ */
+void KYCCodecBase64DecoderInit(KYCCodecBase64Decoder *decoder);
+
+/**
+ Returns maximum number of bytes produced by single update.
+ 
+ @param length Length of base64 text passed to the update.
+ 
+ @return Required output buffer size.
+ */
+size_t KYCCodecBase64DecoderMaxOutput(size_t length);
+
+/**
+ Decodes next piece of base64 text. Characters outside of the alphabet, like line wrapping, are ignored.
+ 
+ @param decoder Decoder.
+ @param input Piece of base64 text.
+ @param length Length of the piece.
+ @param output Buffer with at least {@code KYCCodecBase64DecoderMaxOutput(length)} bytes.
+ 
+ @return Number of written bytes. Nothing is written once decoder failed.
+ */
+size_t KYCCodecBase64DecoderUpdate(KYCCodecBase64Decoder *decoder, const uint8_t *input, size_t length, uint8_t *output);
+
+/**
+ Finishes the text. Missing padding is tolerated. Single extra character is not.
+ 
+ @param decoder Decoder.
+ @param output Buffer with at least 2 bytes for the rest of incomplete quadruplet.
+ 
+ @return Number of written bytes. Check {@code failed} of the decoder afterwards.
+ */
+size_t KYCCodecBase64DecoderFinish(KYCCodecBase64Decoder *decoder, uint8_t *output);
+
+// MARK: - JSON Scanning
+
+/**
+ Returns length of the run of plain string characters. Run ends with quote or backslash.
+ 
+ @param bytes String content right after the opening quote or the last escape sequence.
+ @param length Number of available bytes.
+ 
+ @return Index of the first quote or backslash or {@code length} if there is none.
+ */
+size_t KYCCodecJSONStringRun(const uint8_t *bytes, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KYCCodec_h */
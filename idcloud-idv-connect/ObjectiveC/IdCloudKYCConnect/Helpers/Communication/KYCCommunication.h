@@ -21,12 +21,41 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCSession.h"
+#import "KYCTransport.h"
 
 /**
  Class which ensures the communication with the verification backend.
  */
 @interface KYCCommunication : NSObject
 
+/**
+ Replaces transport used for all verification requests. E.g. with {@code KYCLoopbackTransport} for offline runs.
+ 
+ @param transport Transport or {@code nil} to restore the default one.
+ */
++ (void)setTransport:(id<KYCTransport>)transport;
+
+/**
+ Transport used for verification requests.
+ 
+ @return Custom transport if set, otherwise the default one.
+ */
++ (id<KYCTransport>)transport;
+
+/**
+ Replaces verification backend URL for new verifications.
+ 
+ @param baseURL Backend URL or {@code nil} to restore {@code CFG_IDCLOUD_BASE_URL}.
+ */
++ (void)setBaseURL:(NSString *)baseURL;
+
+/**
+ Verification backend URL used for new verifications.
+ 
+ @return Custom URL if set, otherwise {@code CFG_IDCLOUD_BASE_URL}.
+ */
++ (NSString *)baseURL;
+
 /**
  Sends the document and face images to the verification backend for verification.
  
@@ -40,4 +69,20 @@ Please make sure to review our IdCloud documentation, including security guideli
                      selfie:(NSData *)selfie
           completionHandler:(KYCResponseHandler)handler;
 
+/**
+ Continues restored session by sending its current step again.
+ 
+ @param session Session restored after app relaunch.
+ */
++ (void)resumeSession:(KYCSession *)session;
+
+/**
+ Continues restored session with the response of its current step.
+ 
+ @param session Session restored after app relaunch.
+ @param data Response data.
+ @param error Communication error.
+ */
++ (void)resumeSession:(KYCSession *)session data:(NSData *)data error:(NSError *)error;
+
 @end
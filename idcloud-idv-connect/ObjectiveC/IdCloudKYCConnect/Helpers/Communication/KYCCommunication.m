@@ -21,17 +21,60 @@
  */
 #import "KYCCommunication.h"
 #import "KYCSession.h"
+#import "KYCStreamedBody.h"
+#import "KYCURLSessionManager.h"
+#import "KYCBackgroundTransport.h"
+#import "KYCBlobUploader.h"
 
 #define kStateWaiting   @"Waiting"  // Waiting for remaining images.
 #define kStateFinished  @"Finished" // All images was uploaded and processed.
 
+#define kImageFront     @"front"
+#define kImageBack      @"back"
+#define kImageSelfie    @"selfie"
+
 typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
 
+static id<KYCTransport> sTransport  = nil;
+static NSString         *sBaseURL   = nil;
 
 @implementation KYCCommunication
 
 // MARK: - Public API
 
++ (void)setTransport:(id<KYCTransport>)transport {
+    @synchronized (self) {
+        sTransport = transport;
+    }
+}
+
++ (id<KYCTransport>)transport {
+    @synchronized (self) {
+        if (sTransport) {
+            return sTransport;
+        }
+    }
+    
+    // Upload continues even if app is suspended. Session is persisted so the flow can be resumed after relaunch.
+    if (CFG_IDCLOUD_BACKGROUND_UPLOAD) {
+        return [KYCBackgroundTransport sharedInstance];
+    }
+    
+    return [KYCURLSessionManager sharedInstance];
+}
+
++ (void)setBaseURL:(NSString *)baseURL {
+    @synchronized (self) {
+        sBaseURL = [baseURL copy];
+    }
+}
+
++ (NSString *)baseURL {
+    @synchronized (self) {
+        return sBaseURL ?: CFG_IDCLOUD_BASE_URL;
+    }
+}
+
 + (void)verifyDocumentFront:(NSData *)docFront
                documentBack:(NSData *)docBack
                      selfie:(NSData *)selfie
@@ -46,6 +89,35 @@ typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
     
 }
 
++ (void)resumeSession:(KYCSession *)session {
+    switch (session.step) {
+        case KYCSessionStepInitial:
+            // Documents are not persisted. Whole verification must be started again.
+            [session handleError:@"Verification was interrupted before documents were uploaded."];
+            break;
+        case KYCSessionStepVerifyDocument:
+            [KYCCommunication verifyDocumentPrepareAndSend:session];
+            break;
+        case KYCSessionStepVerifySelfie:
+            [KYCCommunication verifySelfiePrepareAndSend:nil session:session];
+            break;
+    }
+}
+
++ (void)resumeSession:(KYCSession *)session data:(NSData *)data error:(NSError *)error {
+    switch (session.step) {
+        case KYCSessionStepInitial:
+            [KYCCommunication initialRequestHandleResponse:data error:error session:session];
+            break;
+        case KYCSessionStepVerifyDocument:
+            [KYCCommunication verifyDocumentHandleResponse:data error:error session:session];
+            break;
+        case KYCSessionStepVerifySelfie:
+            [KYCCommunication verifySelfieHandleResponse:data error:error session:session];
+            break;
+    }
+}
+
 // MARK: - Private Helpers - Initial request
 
 /**
@@ -60,60 +132,127 @@ typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
                         documentBack:(NSData *)docBack
                               selfie:(NSData *)selfie
                    completionHandler:(KYCResponseHandler)handler {
-    // Build and possible send initial request.
+    // Prepare session.
+    KYCSession *session = [KYCSession createWithURL:[KYCCommunication baseURL]
+                                           portrait:selfie
+                                         andHandler:handler];
+    
+    if (!CFG_IDCLOUD_STAGED_UPLOAD) {
+        [KYCCommunication initialRequestSend:docFront documentBack:docBack session:session];
+        return;
+    }
+    
+    // Images are uploaded only once. Verification steps and their retries just reference them.
+    NSMutableDictionary *images = [NSMutableDictionary new];
+    if (docFront) {
+        [images setObject:docFront forKey:kImageFront];
+    }
+    if (docBack) {
+        [images setObject:docBack forKey:kImageBack];
+    }
+    if (selfie) {
+        [images setObject:selfie forKey:kImageSelfie];
+    }
+    
+    [[KYCBlobUploader sharedInstance] stageImages:images
+                                          session:session
+                                completionHandler:^(NSDictionary<NSString *, NSString *> *digests, NSError *error) {
+        if (error) {
+            [session handleError:error.localizedDescription];
+            return;
+        }
+        
+        session.portraitDigest  = digests[kImageSelfie];
+        session.stagedDigests   = digests.allValues;
+        [KYCCommunication initialRequestSend:[KYCBlobUploader referenceToDigest:digests[kImageFront]]
+                                documentBack:[KYCBlobUploader referenceToDigest:digests[kImageBack]]
+                                     session:session];
+    }];
+}
+
+/**
+ Builds and sends the first verification request.
+ 
+ @param docFront Front side of document. Image data or reference to staged image.
+ @param docBack Back side of document. Image data or reference to staged image.
+ @param session Session.
+ */
++ (void)initialRequestSend:(id)docFront
+              documentBack:(id)docBack
+                   session:(KYCSession *)session {
+    // Build and possible send initial request. With streamed upload images are base64 encoded later during upload.
+    KYCTraceSpan *buildSpan = [session beginTraceSpan:@"buildBody" category:kTraceCategoryNetwork];
     [KYCCommunication initialRequestCreateJSON:docFront
                                   documentBack:docBack
-                                        selfie:selfie
+                                        selfie:session.portrait != nil
                                        handler:^(NSURLRequest *request, NSError *error) {
-        // Prepare session.
-        KYCSession *session = [KYCSession createWithURL:CFG_IDCLOUD_BASE_URL
-                                               portrait:selfie
-                                             andHandler:handler];
+        [buildSpan end];
+        
         if (error) {
             // Failed to build initial request.
             [session handleError:error.localizedDescription];
         } else {
+            // Selfie body does not depend on the first response. Build it while documents are being uploaded.
+            if (CFG_IDCLOUD_PIPELINED_UPLOAD && session.portrait) {
+                [KYCCommunication verifySelfiePrepareInBackground:session];
+            }
+            
             // Execute request.
-            [[[KYCCommunication createUrlSession] dataTaskWithRequest:request
-                                                    completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-                // Something went wrong during communication. Return error from SDK.
-                if (error) {
-                    [session handleError:error.localizedDescription];
-                    return;
-                }
-                
-                // Parse server response, update session id and check possible errors.
-                if ([session parseResultAndHandleErrors:data]) {
-                    // Continue with verify status. We can call it directly without delay. Acuant is fast.
-                    dispatch_async(dispatch_get_main_queue(), ^{
-                        [KYCCommunication performSelector:@selector(verifyDocumentPrepareAndSend:) withObject:session];
-                    });
-                }
-            }] resume];
+            session.step = KYCSessionStepInitial;
+            [session markTimeline:@"initialRequestSent"];
+            [KYCCommunication sendRequest:request
+                                  session:session
+                        completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+                [KYCCommunication initialRequestHandleResponse:data error:error session:session];
+            }];
         }
     }];
 }
 
 /**
- Creates the HTTP JSON body for the first verification step.
+ Handles the response of the first verification step.
+ 
+ @param data Response data.
+ @param error Communication error.
+ @param session Session.
+ */
++ (void)initialRequestHandleResponse:(NSData *)data error:(NSError *)error session:(KYCSession *)session {
+    // Something went wrong during communication. Return error from SDK.
+    if (error) {
+        [session handleError:error.localizedDescription];
+        return;
+    }
+    
+    // Parse server response, update session id and check possible errors.
+    [session markTimeline:@"initialResponseReceived"];
+    if ([session parseResultAndHandleErrors:data]) {
+        // Continue with verify status. We can call it directly without delay. Acuant is fast.
+        [KYCCommunication dispatchNextStep:^{
+            [KYCCommunication verifyDocumentPrepareAndSend:session];
+        }];
+    }
+}
 
- @param docFront Front side of document.
- @param docBack Back side of document.
- @param selfie Selfie image.
+/**
+ Creates the HTTP JSON body for the first verification step.
+ 
+ @param docFront Front side of document. Image data or reference to staged image.
+ @param docBack Back side of document. Image data or reference to staged image.
+ @param selfie {@code True} if selfie image is included, else {@code false}.
  @param handler Callback.
  */
-+ (void)initialRequestCreateJSON:(NSData *)docFront
-                    documentBack:(NSData *)docBack
-                          selfie:(NSData *)selfie
++ (void)initialRequestCreateJSON:(id)docFront
+                    documentBack:(id)docBack
+                          selfie:(BOOL)selfie
                          handler:(RequestBuilder)handler {
     // Input is object containing document and optionaly face.
     NSMutableDictionary *input = [NSMutableDictionary new];
     [input setObject:@"SDK" forKey:@"captureMethod"];
     if (docFront) {
-        [input setObject:[docFront base64EncodedStringWithOptions:0] forKey:@"frontWhiteImage"];
+        [input setObject:docFront forKey:@"frontWhiteImage"];
     }
     if (docBack) {
-        [input setObject:[docBack base64EncodedStringWithOptions:0] forKey:@"backWhiteImage"];
+        [input setObject:docBack forKey:@"backWhiteImage"];
     }
     
     // Optional values for faster evaluation.
@@ -130,18 +269,17 @@ typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
     NSError *error;
     NSMutableDictionary *json = [KYCCommunication createMassageBase:selfie];
     [json setObject:input forKey:@"input"];
-    NSData *requestData = [NSJSONSerialization dataWithJSONObject:json options:0 error:&error];
+    
+    // Build request.
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:[KYCCommunication baseURL]]];
+    request.HTTPMethod  = @"POST";
     
     // Something went wrong during JSON serialization.
-    if (error) {
+    if (![KYCCommunication setBody:json request:request streamed:[KYCCommunication streamedBody] error:&error]) {
         handler(nil, error);
+        return;
     }
     
-    // Build request.
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:CFG_IDCLOUD_BASE_URL]];
-    request.HTTPMethod  = @"POST";
-    request.HTTPBody    = requestData;
-    
     // Return complete request
     handler(request, nil);
 }
@@ -168,37 +306,52 @@ typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
     }
     
     // Execute request.
-    [[[KYCCommunication createUrlSession] dataTaskWithRequest:request
-                                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        // Something went wrong during communication. Return error from SDK.
-        if (error) {
-            [session handleError:error.localizedDescription];
-            return;
-        }
-        
-        // Parse server response, update session id and check possible errors.
-        NSDictionary *res = [session parseResultAndHandleErrors:data];
-        if (!res) {
-            return;
-        }
-        
-        NSString *status= res[@"status"];
-        if (session.portrait && [status isEqualToString:kStateWaiting]) {
-            // Face identification is included in next step.
-            dispatch_async(dispatch_get_main_queue(), ^{
-                [KYCCommunication performSelector:@selector(verifySelfiePrepareAndSend:session:) withObject:response withObject:session];
-            });
-        } else if (!session.portrait && [status isEqualToString:kStateFinished]) {
-            KYCResponse *response = [KYCResponse createWithJSON:res[@"state"][@"result"]];
-            if (response) {
-                [session handleResult:response];
-            } else {
-                [session handleError:@"Failed to parse server response."];
-            }
+    session.step = KYCSessionStepVerifyDocument;
+    [session markTimeline:@"verifyDocumentSent"];
+    [KYCCommunication sendRequest:request
+                          session:session
+                completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [KYCCommunication verifyDocumentHandleResponse:data error:error session:session];
+    }];
+}
+
+/**
+ Handles the response of document verification.
+ 
+ @param data Response data.
+ @param error Communication error.
+ @param session Session.
+ */
++ (void)verifyDocumentHandleResponse:(NSData *)data error:(NSError *)error session:(KYCSession *)session {
+    // Something went wrong during communication. Return error from SDK.
+    if (error) {
+        [session handleError:error.localizedDescription];
+        return;
+    }
+    
+    // Parse server response, update session id and check possible errors.
+    [session markTimeline:@"verifyDocumentReceived"];
+    NSDictionary *res = [session parseResultAndHandleErrors:data];
+    if (!res) {
+        return;
+    }
+    
+    NSString *status= res[@"status"];
+    if (session.portrait && [status isEqualToString:kStateWaiting]) {
+        // Face identification is included in next step.
+        [KYCCommunication dispatchNextStep:^{
+            [KYCCommunication verifySelfiePrepareAndSend:nil session:session];
+        }];
+    } else if (!session.portrait && [status isEqualToString:kStateFinished]) {
+        KYCResponse *response = [KYCResponse createWithJSON:res[@"state"][@"result"]];
+        if (response) {
+            [session handleResult:response];
         } else {
-            [session handleError:@"Unexpected server state."];
+            [session handleError:@"Failed to parse server response."];
         }
-    }] resume];
+    } else {
+        [session handleError:@"Unexpected server state."];
+    }
 }
 
 /**
@@ -220,81 +373,327 @@ typedef void (^RequestBuilder)(NSURLRequest *request, NSError *error);
  @param session Session.
  */
 + (void)verifySelfiePrepareAndSend:(KYCResponse *)response1 session:(KYCSession *)session {
+    // Body was already prepared during document upload. Wait for it without blocking the network queue.
+    if (session.selfieRequestGroup) {
+        dispatch_group_notify(session.selfieRequestGroup, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            [KYCCommunication verifySelfieSend:session.selfieRequest error:session.selfieRequestError session:session];
+        });
+        return;
+    }
+    
     // Build request.
+    KYCTraceSpan *buildSpan = [session beginTraceSpan:@"buildSelfieBody" category:kTraceCategoryNetwork];
     NSError *error;
-    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:session.urlSelfie];
+    NSMutableURLRequest *request = [KYCCommunication verifySelfieCreateRequest:[KYCCommunication portraitOfSession:session]
+                                                                      streamed:[KYCCommunication streamedBody]
+                                                                         error:&error];
+    [buildSpan end];
+    [KYCCommunication verifySelfieSend:request error:error session:session];
+}
+
+/**
+ Builds the selfie request on background queue while the first step is still running.
+ 
+ @param session Session.
+ */
++ (void)verifySelfiePrepareInBackground:(KYCSession *)session {
+    dispatch_group_t group = dispatch_group_create();
+    session.selfieRequestGroup = group;
+    
+    dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        KYCTraceSpan *buildSpan = [session beginTraceSpan:@"buildSelfieBody" category:kTraceCategoryNetwork];
+        NSError *error;
+        // Streamed body would start its writer now and keep it waiting for the first step. Serialize it instead.
+        session.selfieRequest       = [KYCCommunication verifySelfieCreateRequest:[KYCCommunication portraitOfSession:session]
+                                                                             streamed:NO
+                                                                                error:&error];
+        session.selfieRequestError  = error;
+        [buildSpan end];
+        [session markTimeline:@"selfieBodyPrepared"];
+    });
+}
+
+/**
+ Creates the selfie request without URL. URL depends on session id, which is known only after the first step.
+ 
+ @param portrait Selfie image data or reference to staged image.
+ @param streamed Whether body should be streamed or serialized in memory.
+ @param error Error object.
+ 
+ @return Selfie request.
+ */
++ (NSMutableURLRequest *)verifySelfieCreateRequest:(id)portrait streamed:(BOOL)streamed error:(NSError **)error {
+    NSMutableURLRequest *request = [NSMutableURLRequest new];
     request.HTTPMethod = @"PATCH";
-    request.HTTPBody    = [KYCCommunication verifySlefieCreateJSON:session.portrait
-                                                             error:&error];
     
+    // Without streaming whole body is serialized here, so it's ready before it is needed.
+    if (![KYCCommunication setBody:[KYCCommunication verifySlefieCreateJSON:portrait]
+                           request:request
+                          streamed:streamed
+                             error:error]) {
+        return nil;
+    }
+    
+    return request;
+}
+
+/**
+ Sends the prepared selfie request.
+ 
+ @param request Selfie request.
+ @param error Error during request preparation.
+ @param session Session.
+ */
++ (void)verifySelfieSend:(NSMutableURLRequest *)request error:(NSError *)error session:(KYCSession *)session {
     // Failed to build verification JSON. No reason to continue.
-    if (error) {
+    if (!request) {
         [session handleError:error.localizedDescription];
         return;
     }
     
+    request.URL = session.urlSelfie;
+    
     // Execute request.
-    [[[KYCCommunication createUrlSession] dataTaskWithRequest:request
-                                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        // Something went wrong during communication. Return error from SDK.
-        if (error) {
-            [session handleError:error.localizedDescription];
-            return;
-        }
-        
-        // Parse server response, update session id and check possible errors.
-        NSDictionary *res = [session parseResultAndHandleErrors:data];
-        if (!res) {
-            return;
-        }
-        
-        if ([res[@"status"] isEqualToString:kStateFinished]) {
-            KYCResponse *response = [KYCResponse createWithJSON:res[@"state"][@"result"]];
-            if (response) {
-                [session handleResult:response];
-            } else {
-                [session handleError:@"Failed to parse server response."];
-            }
+    session.step = KYCSessionStepVerifySelfie;
+    [session markTimeline:@"verifySelfieSent"];
+    [KYCCommunication sendRequest:request
+                          session:session
+                completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [KYCCommunication verifySelfieHandleResponse:data error:error session:session];
+    }];
+}
+
+/**
+ Handles the response of selfie verification.
+ 
+ @param data Response data.
+ @param error Communication error.
+ @param session Session.
+ */
++ (void)verifySelfieHandleResponse:(NSData *)data error:(NSError *)error session:(KYCSession *)session {
+    // Something went wrong during communication. Return error from SDK.
+    if (error) {
+        [session handleError:error.localizedDescription];
+        return;
+    }
+    
+    // Parse server response, update session id and check possible errors.
+    [session markTimeline:@"verifySelfieReceived"];
+    NSDictionary *res = [session parseResultAndHandleErrors:data];
+    if (!res) {
+        return;
+    }
+    
+    if ([res[@"status"] isEqualToString:kStateFinished]) {
+        KYCResponse *response = [KYCResponse createWithJSON:res[@"state"][@"result"]];
+        if (response) {
+            [session handleResult:response];
         } else {
-            // Unknown state. Not handled response type.
-            [session handleError:@"Unexpected server response."];
+            [session handleError:@"Failed to parse server response."];
         }
-    }] resume];
+    } else {
+        // Unknown state. Not handled response type.
+        [session handleError:@"Unexpected server response."];
+    }
 }
 
 /**
- Creates the JSON body for document verification.
-
- @param portrait Selfie image.
- @param error Error object.
+ Creates the JSON body for selfie verification. Image is kept as raw data and base64 encoded during serialization.
+ 
+ @param portrait Selfie image data or reference to staged image.
+ 
+ @return JSON body.
 */
-+ (NSData *)verifySlefieCreateJSON:(NSData *)portrait
-                             error:(NSError **)error {
++ (NSDictionary *)verifySlefieCreateJSON:(id)portrait {
     NSMutableDictionary *json = [KYCCommunication createMassageBase:YES];
     
     NSMutableDictionary *input = [NSMutableDictionary new];
-    [input setObject:[portrait base64EncodedStringWithOptions:0] forKey:@"face"];
+    [input setObject:portrait forKey:@"face"];
     [json setObject:input forKey:@"input"];
     
-    return [NSJSONSerialization dataWithJSONObject:json options:0 error:error];
+    return json;
 }
 
 // MARK: - Private Helpers - Common
 
 /**
- Creates the url session for all verification steps.
+ Sends the request through current transport.
+ 
+ @param request Request to be sent.
+ @param session Session.
+ @param handler Callback.
+ */
++ (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler {
+    // One span per request. It covers upload of the body as well as server processing of the step.
+    KYCTraceSpan *span = [session beginTraceSpan:[KYCCommunication traceNameOfStep:session.step] category:kTraceCategoryNetwork];
+    if (span) {
+        KYCTransportHandler original = handler;
+        handler = ^(NSData *data, NSURLResponse *response, NSError *error) {
+            [span end];
+            original(data, response, error);
+        };
+    }
+    
+    [KYCCommunication sendRequest:request session:session attempt:0 completionHandler:handler];
+}
+
+/**
+ Sends the request and repeats it after communication error which proves the request did not reach the server.
+ Steps are not idempotent, so request which might have been processed is never repeated. Streamed body is consumed
+ by the first attempt, so the repeated request gets a new stream of the same body.
+ 
+ @param request Request to be sent.
+ @param session Session.
+ @param attempt Number of already failed attempts.
+ @param handler Callback.
+ */
++ (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+            attempt:(NSInteger)attempt
+  completionHandler:(KYCTransportHandler)handler {
+    [[KYCCommunication transport] sendRequest:request
+                                      session:session
+                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        KYCStreamedBody *body   = [KYCStreamedBody bodyOfStream:request.HTTPBodyStream];
+        BOOL            retry   = [KYCCommunication isUnsentRequestError:error] && (!request.HTTPBodyStream || body) &&
+                                  attempt < CFG_IDCLOUD_STEP_RETRY_COUNT;
+        if (!retry) {
+            handler(data, response, error);
+            return;
+        }
+        
+        // With staged images the repeated body holds only references.
+        NSURLRequest *retryRequest = request;
+        if (body) {
+            NSMutableURLRequest *streamedRequest    = [request mutableCopy];
+            streamedRequest.HTTPBodyStream          = body.inputStream;
+            retryRequest                            = streamedRequest;
+            [session addRetryOfBytes:body.contentLength];
+        } else {
+            [session addRetryOfBytes:request.HTTPBody.length];
+        }
+        
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)((attempt + 1) * NSEC_PER_SEC)),
+                       dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+            [KYCCommunication sendRequest:retryRequest session:session attempt:attempt + 1 completionHandler:handler];
+        });
+    }];
+}
+
+/**
+ Whether the error was raised before any part of the request could reach the server.
+ 
+ @param error Communication error.
+ 
+ @return {@code True} if it's safe to send the request again, else {@code false}.
+ */
++ (BOOL)isUnsentRequestError:(NSError *)error {
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    
+    switch (error.code) {
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorDNSLookupFailed:
+        case NSURLErrorNotConnectedToInternet:
+        case NSURLErrorSecureConnectionFailed:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+/**
+ Name of the verification step used in trace.
+ 
+ @param step Verification step.
+ 
+ @return Span name.
+ */
++ (NSString *)traceNameOfStep:(KYCSessionStep)step {
+    switch (step) {
+        case KYCSessionStepInitial:
+            return @"initialRequest";
+        case KYCSessionStepVerifyDocument:
+            return @"verifyDocument";
+        case KYCSessionStepVerifySelfie:
+            return @"verifySelfie";
+    }
+}
+
+/**
+ Continues with the next verification step. Pipelined mode calls it directly from network callback queue.
+ 
+ @param step Next step.
+ */
++ (void)dispatchNextStep:(dispatch_block_t)step {
+    if (CFG_IDCLOUD_PIPELINED_UPLOAD) {
+        step();
+    } else {
+        dispatch_async(dispatch_get_main_queue(), step);
+    }
+}
+
+/**
+ Whether request bodies should be streamed based on configuration.
+ Body with staged images holds only references. Keep it in memory, so the step can be repeated.
+ 
+ @return {@code True} if body should be streamed, else {@code false}.
+ */
++ (BOOL)streamedBody {
+    return CFG_IDCLOUD_STREAMED_UPLOAD && !CFG_IDCLOUD_STAGED_UPLOAD;
+}
+
+/**
+ Serializes the JSON body into the request. Body is either streamed or built in memory and optionally gzip compressed.
+ 
+ @param json JSON body. {@code NSData} values are written as base64 strings.
+ @param request Request to be updated.
+ @param streamed Whether body should be streamed or serialized in memory.
+ @param error Error object.
+ 
+ @return {@code True} if body was successfully set, else {@code false}.
+ */
++ (BOOL)setBody:(NSDictionary *)json
+        request:(NSMutableURLRequest *)request
+       streamed:(BOOL)streamed
+          error:(NSError **)error {
+    KYCStreamedBody *body = [KYCStreamedBody bodyWithJSONObject:json error:error];
+    if (!body) {
+        return NO;
+    }
+    
+    // Compress only if backend is known to accept it.
+    body.compressed = CFG_IDCLOUD_COMPRESSED_UPLOAD && [KYCURLSessionManager sharedInstance].gzipRequestSupported;
+    if (body.compressed) {
+        [request setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+    }
+    
+    if (streamed) {
+        // Images are base64 encoded while the body is being uploaded.
+        request.HTTPBodyStream = body.inputStream;
+        if (!body.compressed) {
+            [request setValue:[NSString stringWithFormat:@"%llu", body.contentLength] forHTTPHeaderField:@"Content-Length"];
+        }
+    } else {
+        request.HTTPBody = body.serializedData;
+    }
+    
+    return YES;
+}
+
+/**
+ Selfie value used in verification JSON.
+ 
+ @param session Session.
  
- @return {@code NSURLSession} for the verification steps.
+ @return Reference to staged selfie if it was staged, otherwise selfie image data.
  */
-+ (NSURLSession *)createUrlSession {
-    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
-    configuration.HTTPAdditionalHeaders = @{
-        @"Accept"           : @"application/json",
-        @"Content-Type"     : @"application/json",
-        @"Authorization"    : [NSString stringWithFormat:@"Bearer %@", [KYCManager sharedInstance].jsonWebToken],
-        @"X-API-KEY"        : [KYCManager sharedInstance].apiKey
-    };
-    return [NSURLSession sessionWithConfiguration:configuration];
++ (id)portraitOfSession:(KYCSession *)session {
+    return [KYCBlobUploader referenceToDigest:session.portraitDigest] ?: session.portrait;
 }
 
 /**
@@ -0,0 +1,93 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Called every time a member of the root object is read.
+
+ @param root Root object read so far.
+ @param key Key of the member which was just read.
+
+ @return {@code True} to continue, {@code false} if the rest of the document is not needed.
+ */
+typedef BOOL (^KYCJSONReaderMemberHandler)(NSDictionary *root, NSString *key);
+
+/**
+ Incremental JSON reader for verification responses.
+
+ Data can be appended in chunks as they arrive. Members of the root object are reported as soon as they are read,
+ so the caller can decide based on {@code id} or {@code status} without waiting for the whole document.
+ String values on selected key paths are base64 decoded directly from the input into {@code NSData}, without
+ building an intermediate {@code NSString}, and values on skipped key paths are not stored at all.
+
+ Key path is a list of object keys joined by dot, e.g. {@code state.result.object.face.image}. Array indexes are
+ not part of the path.
+ */
+@interface KYCJSONReader : NSObject
+
+/**
+ {@code True} if the member handler stopped the reading. Root object contains only members read so far.
+ */
+@property (nonatomic, assign, readonly) BOOL stopped;
+
+/**
+ Creates a new {@code KYCJSONReader} instance.
+
+ @param base64Paths Key paths of string values which are stored as decoded {@code NSData}. Empty or invalid value is left out.
+ @param skippedPaths Key paths of string values which are dropped.
+ @param memberHandler Optional handler of root object members.
+
+ @return Instance of {@code KYCJSONReader}.
+ */
++ (instancetype)readerWithBase64Paths:(NSSet<NSString *> *)base64Paths
+                         skippedPaths:(NSSet<NSString *> *)skippedPaths
+                        memberHandler:(KYCJSONReaderMemberHandler)memberHandler;
+
+/**
+ Reads next chunk of the document.
+
+ @param data Next chunk.
+ @param error Error object.
+
+ @return {@code True} if more data are expected, {@code false} if reading is finished or failed.
+ */
+- (BOOL)appendData:(NSData *)data error:(NSError **)error;
+
+/**
+ Finishes reading and returns the document.
+
+ @param error Error object.
+
+ @return Root object or {@code nil} if the document is not valid.
+ */
+- (id)finishWithError:(NSError **)error;
+
+/**
+ Reads the whole document at once.
+
+ @param data Complete document.
+ @param error Error object.
+
+ @return Root object or {@code nil} if the document is not valid.
+ */
+- (id)readData:(NSData *)data error:(NSError **)error;
+
+@end
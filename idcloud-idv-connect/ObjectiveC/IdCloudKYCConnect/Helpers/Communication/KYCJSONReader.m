@@ -0,0 +1,447 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCJSONReader.h"
+#import "KYCCodec.h"
+
+#define kErrorDomain        @"KYCJSONReader"
+
+// Character classes are checked for each byte of the input. Keep them as plain functions.
+static inline BOOL KYCJSONIsWhitespace(uint8_t byte) {
+    return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+static inline BOOL KYCJSONIsDelimiter(uint8_t byte) {
+    return KYCJSONIsWhitespace(byte) || byte == ',' || byte == ']' || byte == '}';
+}
+
+typedef NS_ENUM(NSInteger, KYCJSONReaderState) {
+    KYCJSONReaderStateValue,        // Value expected.
+    KYCJSONReaderStateValueOrEnd,   // Value or end of array expected. Right after '['.
+    KYCJSONReaderStateKey,          // Key expected. After ',' in object.
+    KYCJSONReaderStateKeyOrEnd,     // Key or end of object expected. Right after '{'.
+    KYCJSONReaderStateColon,        // Separator between key and value expected.
+    KYCJSONReaderStateCommaOrEnd,   // Next member or end of container expected.
+    KYCJSONReaderStateString,       // Inside of string.
+    KYCJSONReaderStateEscape,       // Character after backslash inside of string.
+    KYCJSONReaderStateLiteral,      // Inside of number, true, false or null.
+    KYCJSONReaderStateDone          // Root value finished.
+};
+
+typedef NS_ENUM(NSInteger, KYCJSONReaderString) {
+    KYCJSONReaderStringKey,         // Object key.
+    KYCJSONReaderStringValue,       // Regular string value.
+    KYCJSONReaderStringBase64,      // Value decoded to NSData on the fly.
+    KYCJSONReaderStringSkipped      // Value which is not stored.
+};
+
+// MARK: - KYCJSONReaderFrame
+
+/**
+ One level of open containers.
+ */
+@interface KYCJSONReaderFrame : NSObject
+
+@property (nonatomic, strong)   id          container;
+@property (nonatomic, copy)     NSString    *path;
+@property (nonatomic, copy)     NSString    *key;
+
+@end
+
+@implementation KYCJSONReaderFrame
+
+@end
+
+// MARK: - KYCJSONReader
+
+@interface KYCJSONReader() {
+    KYCCodecBase64Decoder _decoder;
+}
+
+@property (nonatomic, copy)     NSSet<NSString *>                       *base64Paths;
+@property (nonatomic, copy)     NSSet<NSString *>                       *skippedPaths;
+@property (nonatomic, copy)     KYCJSONReaderMemberHandler              memberHandler;
+@property (nonatomic, strong)   NSMutableArray<KYCJSONReaderFrame *>    *stack;
+@property (nonatomic, strong)   id                                      root;
+@property (nonatomic, assign)   KYCJSONReaderState                      state;
+@property (nonatomic, assign)   KYCJSONReaderString                     stringType;
+@property (nonatomic, assign)   BOOL                                    stringEscaped;
+@property (nonatomic, strong)   NSMutableData                           *token;
+@property (nonatomic, strong)   NSMutableData                           *decoded;
+@property (nonatomic, assign)   NSUInteger                              offset;
+@property (nonatomic, assign)   BOOL                                    stopped;
+
+@end
+
+@implementation KYCJSONReader
+
+// MARK: - Life Cycle
+
++ (instancetype)readerWithBase64Paths:(NSSet<NSString *> *)base64Paths
+                         skippedPaths:(NSSet<NSString *> *)skippedPaths
+                        memberHandler:(KYCJSONReaderMemberHandler)memberHandler {
+    KYCJSONReader *retValue = [KYCJSONReader new];
+    retValue.base64Paths    = base64Paths;
+    retValue.skippedPaths   = skippedPaths;
+    retValue.memberHandler  = memberHandler;
+    return retValue;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.stack  = [NSMutableArray new];
+        self.token  = [NSMutableData new];
+        self.state  = KYCJSONReaderStateValue;
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (BOOL)appendData:(NSData *)data error:(NSError **)error {
+    if (_stopped) {
+        return NO;
+    }
+    
+    const uint8_t   *bytes  = data.bytes;
+    NSUInteger      length  = data.length;
+    NSUInteger      index   = 0;
+    while (index < length && !_stopped) {
+        uint8_t loopByte = bytes[index];
+        switch (_state) {
+            case KYCJSONReaderStateString:
+                // Most of the document is inside of strings. Copy whole runs instead of single bytes.
+                index = [self readString:bytes from:index length:length];
+                continue;
+            case KYCJSONReaderStateEscape:
+                [self readEscaped:loopByte];
+                break;
+            case KYCJSONReaderStateLiteral:
+                if (KYCJSONIsDelimiter(loopByte)) {
+                    // Delimiter belongs to the container. Process it again in the new state.
+                    if (![self finishLiteral:error]) {
+                        return NO;
+                    }
+                    continue;
+                }
+                [_token appendBytes:&loopByte length:1];
+                break;
+            default:
+                if (!KYCJSONIsWhitespace(loopByte) && ![self readStructural:loopByte error:error]) {
+                    return NO;
+                }
+                break;
+        }
+        
+        index++;
+        _offset++;
+    }
+    
+    return !_stopped;
+}
+
+- (id)finishWithError:(NSError **)error {
+    // Number can be the root value. There is no delimiter after it.
+    if (_state == KYCJSONReaderStateLiteral && !_stack.count && ![self finishLiteral:error]) {
+        return nil;
+    }
+    
+    if (_state != KYCJSONReaderStateDone && !_stopped) {
+        [self setError:error message:@"Unexpected end of data."];
+        return nil;
+    }
+    
+    return _root;
+}
+
+- (id)readData:(NSData *)data error:(NSError **)error {
+    NSError *appendError = nil;
+    if (![self appendData:data error:&appendError] && appendError) {
+        if (error) {
+            *error = appendError;
+        }
+        return nil;
+    }
+    
+    return [self finishWithError:error];
+}
+
+// MARK: - Private Helpers
+
+- (void)setError:(NSError **)error message:(NSString *)message {
+    if (error) {
+        NSString *description = [NSString stringWithFormat:@"%@ Offset: %lu", message, (unsigned long)_offset];
+        *error = [NSError errorWithDomain:kErrorDomain code:-1 userInfo:@{NSLocalizedDescriptionKey: description}];
+    }
+}
+
+- (NSString *)valuePath {
+    KYCJSONReaderFrame *frame = _stack.lastObject;
+    if (!frame) {
+        return @"";
+    } else if ([frame.container isKindOfClass:[NSArray class]]) {
+        return frame.path;
+    } else {
+        return frame.path.length ? [NSString stringWithFormat:@"%@.%@", frame.path, frame.key] : frame.key;
+    }
+}
+
+- (BOOL)readStructural:(uint8_t)byte error:(NSError **)error {
+    switch (_state) {
+        case KYCJSONReaderStateValue:
+        case KYCJSONReaderStateValueOrEnd:
+            if (byte == ']' && _state == KYCJSONReaderStateValueOrEnd) {
+                return [self closeContainer:byte error:error];
+            }
+            return [self openValue:byte error:error];
+        case KYCJSONReaderStateKey:
+        case KYCJSONReaderStateKeyOrEnd:
+            if (byte == '}' && _state == KYCJSONReaderStateKeyOrEnd) {
+                return [self closeContainer:byte error:error];
+            } else if (byte == '"') {
+                [self openString:KYCJSONReaderStringKey];
+                return YES;
+            }
+            break;
+        case KYCJSONReaderStateColon:
+            if (byte == ':') {
+                self.state = KYCJSONReaderStateValue;
+                return YES;
+            }
+            break;
+        case KYCJSONReaderStateCommaOrEnd:
+            if (byte == ',') {
+                BOOL array  = [_stack.lastObject.container isKindOfClass:[NSArray class]];
+                self.state  = array ? KYCJSONReaderStateValue : KYCJSONReaderStateKey;
+                return YES;
+            } else if (byte == ']' || byte == '}') {
+                return [self closeContainer:byte error:error];
+            }
+            break;
+        default:
+            break;
+    }
+
+    [self setError:error message:[NSString stringWithFormat:@"Unexpected character '%c'.", byte]];
+    return NO;
+}
+
+- (BOOL)openValue:(uint8_t)byte error:(NSError **)error {
+    if (byte == '{' || byte == '[') {
+        KYCJSONReaderFrame *frame = [KYCJSONReaderFrame new];
+        frame.container = byte == '{' ? [NSMutableDictionary new] : [NSMutableArray new];
+        frame.path      = [self valuePath];
+        
+        // Container is attached to parent right away. It's filled in place.
+        [self storeValue:frame.container];
+        [_stack addObject:frame];
+        
+        self.state = byte == '{' ? KYCJSONReaderStateKeyOrEnd : KYCJSONReaderStateValueOrEnd;
+        return YES;
+    } else if (byte == '"') {
+        NSString *path = [self valuePath];
+        if ([_base64Paths containsObject:path]) {
+            [self openString:KYCJSONReaderStringBase64];
+        } else if ([_skippedPaths containsObject:path]) {
+            [self openString:KYCJSONReaderStringSkipped];
+        } else {
+            [self openString:KYCJSONReaderStringValue];
+        }
+        return YES;
+    } else if (byte == '-' || (byte >= '0' && byte <= '9') || byte == 't' || byte == 'f' || byte == 'n') {
+        _token.length   = 0;
+        self.state      = KYCJSONReaderStateLiteral;
+        [_token appendBytes:&byte length:1];
+        return YES;
+    }
+    
+    [self setError:error message:[NSString stringWithFormat:@"Unexpected character '%c'.", byte]];
+    return NO;
+}
+
+- (BOOL)closeContainer:(uint8_t)byte error:(NSError **)error {
+    BOOL array = [_stack.lastObject.container isKindOfClass:[NSArray class]];
+    if (array != (byte == ']')) {
+        [self setError:error message:@"Mismatched container end."];
+        return NO;
+    }
+    
+    [_stack removeLastObject];
+    [self valueFinished];
+    return YES;
+}
+
+- (void)openString:(KYCJSONReaderString)type {
+    _token.length       = 0;
+    self.stringType     = type;
+    self.stringEscaped  = NO;
+    self.decoded        = type == KYCJSONReaderStringBase64 ? [NSMutableData new] : nil;
+    self.state          = KYCJSONReaderStateString;
+    KYCCodecBase64DecoderInit(&_decoder);
+}
+
+- (NSUInteger)readString:(const uint8_t *)bytes from:(NSUInteger)index length:(NSUInteger)length {
+    NSUInteger end = index + KYCCodecJSONStringRun(bytes + index, length - index);
+    
+    [self appendStringBytes:bytes + index length:end - index];
+    _offset += end - index + (end < length ? 1 : 0);
+    
+    if (end == length) {
+        return end;
+    } else if (bytes[end] == '\\') {
+        self.state = KYCJSONReaderStateEscape;
+    } else {
+        [self finishString];
+    }
+    
+    return end + 1;
+}
+
+- (void)readEscaped:(uint8_t)byte {
+    self.state = KYCJSONReaderStateString;
+    
+    switch (_stringType) {
+        case KYCJSONReaderStringBase64:
+            // JSON writers often escape slash. Anything else is line wrapping, which is not part of base64.
+            if (byte == '/') {
+                [self appendStringBytes:&byte length:1];
+            }
+            break;
+        case KYCJSONReaderStringSkipped:
+            break;
+        default: {
+            // Escape sequences are rare in responses. Keep them as is and let the system parser resolve them.
+            uint8_t backslash = '\\';
+            [_token appendBytes:&backslash length:1];
+            [_token appendBytes:&byte length:1];
+            self.stringEscaped = YES;
+            break;
+        }
+    }
+}
+
+- (void)appendStringBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    switch (_stringType) {
+        case KYCJSONReaderStringBase64:
+            [self decodeBase64:bytes length:length];
+            break;
+        case KYCJSONReaderStringSkipped:
+            break;
+        default:
+            [_token appendBytes:bytes length:length];
+            break;
+    }
+}
+
+- (void)decodeBase64:(const uint8_t *)bytes length:(NSUInteger)length {
+    // Decoded straight into the value. Line wrapping or other noise is dropped by the decoder.
+    if (_decoder.failed) {
+        return;
+    }
+    
+    NSUInteger decodedLength    = _decoded.length;
+    _decoded.length             = decodedLength + KYCCodecBase64DecoderMaxOutput(length);
+    decodedLength               += KYCCodecBase64DecoderUpdate(&_decoder, bytes, length, (uint8_t *)_decoded.mutableBytes + decodedLength);
+    _decoded.length             = decodedLength;
+}
+
+- (void)finishString {
+    switch (_stringType) {
+        case KYCJSONReaderStringKey:
+            _stack.lastObject.key   = [self stringFromToken];
+            self.state              = KYCJSONReaderStateColon;
+            return;
+        case KYCJSONReaderStringValue:
+            [self storeValue:[self stringFromToken]];
+            break;
+        case KYCJSONReaderStringBase64: {
+            // Missing padding is tolerated the same way as in the rest of the application. Single extra character is not.
+            // Value which can't be decoded is left out, same as image which can't be read. Rest of the reply is valid.
+            uint8_t     rest[2];
+            NSUInteger  restLength = KYCCodecBase64DecoderFinish(&_decoder, rest);
+            [_decoded appendBytes:rest length:restLength];
+            if (!_decoder.failed && _decoded.length) {
+                [self storeValue:_decoded];
+            }
+            self.decoded = nil;
+            break;
+        }
+        case KYCJSONReaderStringSkipped:
+            break;
+    }
+    
+    [self valueFinished];
+}
+
+- (NSString *)stringFromToken {
+    if (!_stringEscaped) {
+        return [[NSString alloc] initWithData:_token encoding:NSUTF8StringEncoding] ?: @"";
+    }
+    
+    NSMutableData *quoted = [NSMutableData dataWithBytes:"\"" length:1];
+    [quoted appendData:_token];
+    [quoted appendBytes:"\"" length:1];
+    NSString *retValue = [NSJSONSerialization JSONObjectWithData:quoted options:NSJSONReadingFragmentsAllowed error:nil];
+    
+    return [retValue isKindOfClass:[NSString class]] ? retValue : @"";
+}
+
+- (BOOL)finishLiteral:(NSError **)error {
+    id value = [NSJSONSerialization JSONObjectWithData:_token options:NSJSONReadingFragmentsAllowed error:nil];
+    if (!value || [value isKindOfClass:[NSString class]]) {
+        [self setError:error message:@"Invalid literal."];
+        return NO;
+    }
+    
+    [self storeValue:value];
+    [self valueFinished];
+    return YES;
+}
+
+- (void)storeValue:(id)value {
+    KYCJSONReaderFrame *frame = _stack.lastObject;
+    if (!frame) {
+        self.root = value;
+    } else if ([frame.container isKindOfClass:[NSArray class]]) {
+        [frame.container addObject:value];
+    } else {
+        [frame.container setObject:value forKey:frame.key];
+    }
+}
+
+- (void)valueFinished {
+    if (!_stack.count) {
+        self.state = KYCJSONReaderStateDone;
+        return;
+    }
+    
+    self.state = KYCJSONReaderStateCommaOrEnd;
+    
+    // Member of root object is complete. Let the caller decide whether the rest is needed.
+    KYCJSONReaderFrame *frame = _stack.lastObject;
+    if (_stack.count == 1 && _memberHandler && [frame.container isKindOfClass:[NSDictionary class]]) {
+        self.stopped = !_memberHandler(frame.container, frame.key);
+    }
+}
+
+@end
@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCTransport.h"
+
+/**
+ In-process stand-in for the verification backend.
+
+ Transport emulates the state machine of the backend, so the whole verification flow can be run without network
+ access. Latency, processing time and failures are simulated with seeded pseudo random generator, so the same seed
+ gives the same sequence of replies. Useful for offline runs and load testing of the client side of the flow.
+ */
+@interface KYCLoopbackTransport : NSObject <KYCTransport>
+
+/**
+ Round trip time of each request in seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval    latency;
+
+/**
+ Maximum random addition to the round trip time in seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval    jitter;
+
+/**
+ Time in seconds needed by emulated backend to process the uploaded images.
+ */
+@property (nonatomic, assign) NSTimeInterval    processingTime;
+
+/**
+ Probability of communication error. Value between 0 and 1.
+ */
+@property (nonatomic, assign) double            transportErrorRate;
+
+/**
+ Probability of failed server operation. Value between 0 and 1.
+ */
+@property (nonatomic, assign) double            failureRate;
+
+/**
+ Probability of configuration error reported by server. Value between 0 and 1.
+ */
+@property (nonatomic, assign) double            errorRate;
+
+/**
+ Verification result returned by finished operations. Default one contains passed document and face.
+ */
+@property (nonatomic, copy) NSDictionary        *result;
+
+/**
+ Number of requests received so far.
+ */
+@property (nonatomic, assign, readonly) NSInteger   requestCount;
+
+/**
+ Number of body bytes received so far.
+ */
+@property (nonatomic, assign, readonly) long long   receivedBytes;
+
+/**
+ URL handled by the transport. Any other URL results in communication error.
+ 
+ @return Base URL of emulated backend.
+ */
++ (NSString *)baseURL;
+
+/**
+ Staging area handled by the transport.
+ 
+ @return Staging area URL of emulated backend.
+ */
++ (NSString *)stagingURL;
+
+/**
+ Creates transport with default timing and without any failures.
+ 
+ @param seed Seed of pseudo random generator.
+ 
+ @return Instance of KYCLoopbackTransport class.
+ */
++ (instancetype)transportWithSeed:(uint64_t)seed;
+
+@end
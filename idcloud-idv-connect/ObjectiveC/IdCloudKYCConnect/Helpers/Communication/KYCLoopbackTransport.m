@@ -0,0 +1,336 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCLoopbackTransport.h"
+
+#define kLoopbackHost       @"loopback.invalid"
+#define kLoopbackBaseURL    @"https://loopback.invalid/api/v1/connect/verifications"
+#define kLoopbackStagingURL @"https://loopback.invalid/api/v1/connect/blobs"
+
+#define kStateWaiting       @"Waiting"
+#define kStateFinished      @"Finished"
+#define kStateFailed        @"Failed"
+#define kStateError         @"Error"
+
+#define kStepVerifyResults  @"verifyResults"
+#define kStepFaceMatch      @"faceMatch"
+
+/**
+ One emulated server operation.
+ */
+@interface KYCLoopbackOperation : NSObject
+
+@property (nonatomic, copy)     NSString    *operationId;
+@property (nonatomic, copy)     NSString    *finalStatus;
+
+@end
+
+@implementation KYCLoopbackOperation
+
+@end
+
+@interface KYCLoopbackTransport()
+
+@property (nonatomic, strong)   dispatch_queue_t                                        queue;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, KYCLoopbackOperation *> *operations;
+@property (nonatomic, strong)   NSMutableSet<NSString *>                                *blobs;
+@property (nonatomic, assign)   uint64_t                                                seed;
+@property (nonatomic, assign, readwrite) NSInteger                                      requestCount;
+@property (nonatomic, assign, readwrite) long long                                      receivedBytes;
+
+@end
+
+@implementation KYCLoopbackTransport
+
+// MARK: - Life Cycle
+
++ (NSString *)baseURL {
+    return kLoopbackBaseURL;
+}
+
++ (NSString *)stagingURL {
+    return kLoopbackStagingURL;
+}
+
++ (instancetype)transportWithSeed:(uint64_t)seed {
+    return [[KYCLoopbackTransport alloc] initWithSeed:seed];
+}
+
+- (instancetype)initWithSeed:(uint64_t)seed {
+    if (self = [super init]) {
+        self.queue          = dispatch_queue_create("com.thales.kyc.loopback", DISPATCH_QUEUE_SERIAL);
+        self.operations     = [NSMutableDictionary new];
+        self.blobs          = [NSMutableSet new];
+        self.seed           = seed;
+        self.latency        = .2;
+        self.jitter         = .1;
+        self.processingTime = 3.;
+        self.result         = [KYCLoopbackTransport defaultResult];
+    }
+    
+    return self;
+}
+
+// MARK: - KYCTransport
+
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler {
+    // Body is consumed the same way as real upload would do it. Streamed body encodes images only while being read.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        long long bodyLength = [KYCLoopbackTransport drainBody:request];
+        
+        dispatch_async(self.queue, ^{
+            self.requestCount++;
+            self.receivedBytes += bodyLength;
+            
+            NSData              *data       = nil;
+            NSHTTPURLResponse   *response   = nil;
+            NSError             *error      = nil;
+            NSTimeInterval      delay       = self.latency + self.jitter * [self nextDouble];
+            BOOL                finalStep   = NO;
+            
+            if (![request.URL.host isEqualToString:kLoopbackHost]) {
+                error = [KYCLoopbackTransport errorWithCode:NSURLErrorCannotFindHost request:request];
+            } else if ([self nextDouble] < self.transportErrorRate) {
+                error = [KYCLoopbackTransport errorWithCode:NSURLErrorNetworkConnectionLost request:request];
+            } else if ([request.URL.absoluteString hasPrefix:kLoopbackStagingURL]) {
+                data        = [NSData data];
+                response    = [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                                          statusCode:[self replyToBlobRequest:request]
+                                                         HTTPVersion:@"HTTP/1.1"
+                                                        headerFields:@{}];
+            } else {
+                data        = [NSJSONSerialization dataWithJSONObject:[self replyToRequest:request finalStep:&finalStep]
+                                                                  options:0
+                                                                    error:nil];
+                response    = [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                                          statusCode:200
+                                                         HTTPVersion:@"HTTP/1.1"
+                                                        headerFields:@{@"Content-Type": @"application/json"}];
+            }
+            
+            // Server answers the last step only after all images are processed.
+            if (finalStep) {
+                delay += self.processingTime;
+            }
+            
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                handler(data, response, error);
+            });
+        });
+    });
+}
+
+// MARK: - Private Helpers - Emulated backend
+
+/**
+ Builds reply of the emulated backend. Called on state queue.
+ 
+ @param request Incoming request.
+ @param finalStep Set to {@code true} if reply finishes the operation.
+ 
+ @return Reply JSON.
+ */
+- (NSDictionary *)replyToRequest:(NSURLRequest *)request finalStep:(BOOL *)finalStep {
+    // New verification. Server waits for the remaining steps.
+    if ([request.HTTPMethod isEqualToString:@"POST"]) {
+        KYCLoopbackOperation *operation = [KYCLoopbackOperation new];
+        operation.operationId   = [self nextIdentifier];
+        operation.finalStatus   = [self nextFinalStatus];
+        [_operations setObject:operation forKey:operation.operationId];
+        
+        return @{@"id": operation.operationId, @"status": kStateWaiting};
+    }
+    
+    // Continuation of existing one.
+    KYCLoopbackOperation *operation = [self operationForURL:request.URL];
+    if (!operation) {
+        return @{@"id": @"0", @"status": kStateFailed, @"state": @{@"result": @{@"message": @"Unknown operation."}}};
+    }
+    
+    // Document step announces whether the face step follows.
+    NSString *step = request.URL.lastPathComponent;
+    if ([step isEqualToString:kStepVerifyResults] && request.HTTPBody) {
+        NSDictionary *body = [NSJSONSerialization JSONObjectWithData:request.HTTPBody options:0 error:nil];
+        if ([body isKindOfClass:[NSDictionary class]] && [body[@"name"] isEqual:@"Connect_Verify_Document_Face"]) {
+            return @{@"id": operation.operationId, @"status": kStateWaiting};
+        }
+    } else if (![step isEqualToString:kStepFaceMatch]) {
+        return @{@"id": operation.operationId, @"status": kStateError};
+    }
+    
+    // Operation is done. Server does not keep it any longer.
+    [_operations removeObjectForKey:operation.operationId];
+    *finalStep = YES;
+    
+    if ([operation.finalStatus isEqualToString:kStateFinished]) {
+        return @{@"id": operation.operationId, @"status": kStateFinished, @"state": @{@"result": _result}};
+    } else if ([operation.finalStatus isEqualToString:kStateFailed]) {
+        return @{@"id": operation.operationId, @"status": kStateFailed, @"state": @{@"result": @{@"message": @"Internal service error."}}};
+    } else {
+        return @{@"id": operation.operationId, @"status": kStateError};
+    }
+}
+
+/**
+ Emulates the staging area. Called on state queue.
+ 
+ @param request Incoming request.
+ 
+ @return HTTP status code.
+ */
+- (NSInteger)replyToBlobRequest:(NSURLRequest *)request {
+    NSString *digest = request.URL.lastPathComponent;
+    
+    if ([request.HTTPMethod isEqualToString:@"HEAD"]) {
+        return [_blobs containsObject:digest] ? 200 : 404;
+    } else if ([request.HTTPMethod isEqualToString:@"PUT"]) {
+        [_blobs addObject:digest];
+        return 201;
+    } else {
+        return 405;
+    }
+}
+
+/**
+ Finds the operation addressed by the URL. Session appends operation id as path component of the base URL.
+ 
+ @param url Request URL.
+ 
+ @return Operation or {@code nil} if it does not exists.
+ */
+- (KYCLoopbackOperation *)operationForURL:(NSURL *)url {
+    for (NSString *loopComponent in url.pathComponents) {
+        KYCLoopbackOperation *operation = _operations[loopComponent];
+        if (operation) {
+            return operation;
+        }
+    }
+    
+    return nil;
+}
+
+/**
+ Decides how the new operation will end.
+ 
+ @return Final state of operation.
+ */
+- (NSString *)nextFinalStatus {
+    double value = [self nextDouble];
+    if (value < _errorRate) {
+        return kStateError;
+    } else if (value < _errorRate + _failureRate) {
+        return kStateFailed;
+    } else {
+        return kStateFinished;
+    }
+}
+
+// MARK: - Private Helpers - Random
+
+/**
+ SplitMix64 pseudo random generator. Simple, fast and fully determined by the seed.
+ 
+ @return Next random value.
+ */
+- (uint64_t)nextRandom {
+    uint64_t value = (_seed += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+- (double)nextDouble {
+    return (double)([self nextRandom] >> 11) / (double)(1ULL << 53);
+}
+
+- (NSString *)nextIdentifier {
+    uint64_t high   = [self nextRandom];
+    uint64_t low    = [self nextRandom];
+    return [NSString stringWithFormat:@"%08llx-%04llx-%04llx-%04llx-%012llx",
+            high >> 32, (high >> 16) & 0xFFFF, high & 0xFFFF, low >> 48, low & 0xFFFFFFFFFFFFULL];
+}
+
+// MARK: - Private Helpers - Common
+
+/**
+ Reads whole request body.
+ 
+ @param request Request.
+ 
+ @return Number of body bytes.
+ */
++ (long long)drainBody:(NSURLRequest *)request {
+    if (request.HTTPBody) {
+        return request.HTTPBody.length;
+    }
+    
+    NSInputStream *stream = request.HTTPBodyStream;
+    if (!stream) {
+        return 0;
+    }
+    
+    long long   retValue = 0;
+    uint8_t     buffer[16 * 1024];
+    NSInteger   read;
+    [stream open];
+    while ((read = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+        retValue += read;
+    }
+    [stream close];
+    
+    return retValue;
+}
+
++ (NSError *)errorWithCode:(NSInteger)code request:(NSURLRequest *)request {
+    return [NSError errorWithDomain:NSURLErrorDomain
+                               code:code
+                           userInfo:@{NSURLErrorFailingURLErrorKey: request.URL,
+                                      NSLocalizedDescriptionKey: @"Emulated communication error."}];
+}
+
+/**
+ Passed verification with all values shown in overview.
+ 
+ @return Result JSON.
+ */
++ (NSDictionary *)defaultResult {
+    return @{@"code": @0,
+             @"message": @"Success",
+             @"type": @"JSON",
+             @"object": @{@"document": @{@"verificationResults": @{@"result": @"Passed",
+                                                                   @"firstName": @"JOHN",
+                                                                   @"surname": @"SAMPLE",
+                                                                   @"gender": @"M",
+                                                                   @"nationality": @"CZE",
+                                                                   @"birthDate": @"1980-01-01",
+                                                                   @"expirationDate": @"2030-01-01",
+                                                                   @"documentNumber": @"000000000",
+                                                                   @"documentType": @"ResidencePermit",
+                                                                   @"totalVerificationsDone": @1,
+                                                                   @"numberOfImagesProcessed": @2}},
+                          @"face": @{@"result": @"Passed",
+                                     @"score": @100}}};
+}
+
+@end
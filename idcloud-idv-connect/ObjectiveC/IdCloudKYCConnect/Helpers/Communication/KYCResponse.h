@@ -62,6 +62,11 @@ Please make sure to review our IdCloud documentation, including security guideli
  */
 @property (nonatomic, strong)   KYCFace     *face;
 
+/**
+ Time of each verification step in seconds relative to the start of verification.
+ */
+@property (nonatomic, copy)     NSArray<NSDictionary *> *timeline;
+
 /**
  Creates a new {@code KYCResponse} from the JSON verification backend response.
  
@@ -71,6 +76,24 @@ Please make sure to review our IdCloud documentation, including security guideli
  */
 + (instancetype)createWithJSON:(NSDictionary *)response;
 
+/**
+ Key paths of images which can be decoded directly while the reply is being read.
+ 
+ @param prefix Key path of the response object within the server reply.
+ 
+ @return Set of key paths.
+ */
++ (NSSet<NSString *> *)imageKeyPathsWithPrefix:(NSString *)prefix;
+
+/**
+ Key paths of images which are not used by the application and can be skipped while the reply is being read.
+ 
+ @param prefix Key path of the response object within the server reply.
+ 
+ @return Set of key paths.
+ */
++ (NSSet<NSString *> *)droppedKeyPathsWithPrefix:(NSString *)prefix;
+
 /**
  Updates the {@code KYCResponse} object with the face data.
  
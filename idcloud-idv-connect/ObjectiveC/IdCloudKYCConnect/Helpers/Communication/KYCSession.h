@@ -21,6 +21,7 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCResponse.h"
+#import "KYCTrace.h"
 
 /**
  Verification session callback
@@ -30,11 +31,30 @@ Please make sure to review our IdCloud documentation, including security guideli
  */
 typedef void (^KYCResponseHandler)(KYCResponse *response, NSString *error);
 
+/**
+ Verification step which is currently being sent to the verification backend.
+ */
+typedef NS_ENUM(NSInteger, KYCSessionStep) {
+    KYCSessionStepInitial,
+    KYCSessionStepVerifyDocument,
+    KYCSessionStepVerifySelfie
+};
+
 /**
  Session with verification backend.
 */
 @interface KYCSession : NSObject
 
+/**
+ Unique local identifier of the session. Used to find persisted state after relaunch.
+ */
+@property (nonatomic, copy, readonly)   NSString        *identifier;
+
+/**
+ Verification step which is currently in progress.
+ */
+@property (nonatomic, assign)           KYCSessionStep  step;
+
 /**
  URL for document verification.
  */
@@ -50,6 +70,47 @@ typedef void (^KYCResponseHandler)(KYCResponse *response, NSString *error);
  */
 @property (nonatomic, copy, readonly)   NSData  *portrait;
 
+/**
+ Digest of the selfie image in staging area. {@code nil} if the image is sent as part of the request.
+ */
+@property (nonatomic, copy)             NSString            *portraitDigest;
+
+/**
+ Digests of all staged images referenced by the verification. They are no longer trusted to be staged if the
+ verification fails, e.g. because the staging area evicted some of them.
+ */
+@property (nonatomic, copy)             NSArray<NSString *> *stagedDigests;
+
+/**
+ Number of requests repeated after communication error.
+ */
+@property (nonatomic, assign, readonly) NSInteger           retryCount;
+
+/**
+ Number of body bytes sent again by repeated requests.
+ */
+@property (nonatomic, assign, readonly) long long           resentBytes;
+
+/**
+ Prepared selfie request. Built in background while the first step is running.
+ */
+@property (nonatomic, strong)           NSMutableURLRequest *selfieRequest;
+
+/**
+ Error which occured during selfie request preparation.
+ */
+@property (nonatomic, strong)           NSError             *selfieRequestError;
+
+/**
+ Group used to wait for selfie request preparation. {@code nil} if request is not prepared in advance.
+ */
+@property (nonatomic, strong)           dispatch_group_t    selfieRequestGroup;
+
+/**
+ Time of each verification step in seconds relative to session creation.
+ */
+@property (nonatomic, copy, readonly)   NSArray<NSDictionary *> *timeline;
+
 /**
  Creates a new {@code KYCSession} instance.
  
@@ -63,6 +124,41 @@ typedef void (^KYCResponseHandler)(KYCResponse *response, NSString *error);
                      portrait:(NSData *)portrait
                    andHandler:(KYCResponseHandler)handler;
 
+/**
+ Restores session persisted by {@code persist} method.
+ 
+ @param identifier Session identifier.
+ @param handler Callback. Original one does not survive app relaunch.
+ 
+ @return Instance of {@code KYCSession} or {@code nil} if there is no such session stored.
+ */
++ (instancetype)restoreWithIdentifier:(NSString *)identifier
+                           andHandler:(KYCResponseHandler)handler;
+
+/**
+ Returns identifiers of all persisted sessions.
+ 
+ @return Session identifiers.
+ */
++ (NSArray<NSString *> *)persistedIdentifiers;
+
+/**
+ Stores session id, current step and selfie image on disk, so verification can continue after relaunch.
+ */
+- (void)persist;
+
+/**
+ Removes persisted session state from disk.
+ */
+- (void)removePersisted;
+
+/**
+ Location of the request body file used by background upload.
+ 
+ @return File URL.
+ */
+- (NSURL *)bodyFileURL;
+
 /**
  Parses error data received from verifiatin backend.
  
@@ -73,14 +169,38 @@ typedef void (^KYCResponseHandler)(KYCResponse *response, NSString *error);
 - (NSDictionary *)parseResultAndHandleErrors:(NSData *)data;
 
 /**
- Posts the error on the main UI thread.
+ Accounts repeated request.
+ 
+ @param bytes Number of body bytes sent again.
+ */
+- (void)addRetryOfBytes:(long long)bytes;
+
+/**
+ Marks the time of the verification step in session timeline.
+ 
+ @param step Name of the step.
+ */
+- (void)markTimeline:(NSString *)step;
+
+/**
+ Starts trace span of a verification step. Spans still running when the verification ends are ended with it.
+ 
+ @param name Step name.
+ @param category Span category.
+ 
+ @return Running span or {@code nil} if tracing is disabled.
+ */
+- (KYCTraceSpan *)beginTraceSpan:(NSString *)name category:(NSString *)category;
+
+/**
+ Posts the error on the main UI thread. Ignored if the session already ended.
  
  @param error Error.
  */
 - (void)handleError:(NSString *)error;
 
 /**
- Posts the result on the main UI thread.
+ Posts the result on the main UI thread. Ignored if the session already ended.
  
  @param result Result.
  */
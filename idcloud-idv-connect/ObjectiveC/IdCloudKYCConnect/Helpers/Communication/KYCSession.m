@@ -21,18 +21,38 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCSession.h"
+#import "KYCJSONReader.h"
+#import "KYCBlobUploader.h"
 
 @interface KYCSession()
 
 @property (nonatomic, copy)     NSString            *urlBase;
 @property (nonatomic, copy)     NSString            *sessionId;
 @property (nonatomic, copy)     KYCResponseHandler  handler;
+@property (nonatomic, strong)   NSDate              *started;
+@property (nonatomic, strong)   NSMutableArray      *steps;
+@property (nonatomic, strong)   KYCTraceSpan        *traceSpan;
+@property (nonatomic, strong)   NSMutableArray      *traceSpans;
+@property (nonatomic, assign)   BOOL                completed;
 
 @end
 
+#define kPersistedState         @"state.plist"
+#define kPersistedPortrait      @"portrait.bin"
+#define kPersistedBody          @"body.json"
+
+#define kKeyUrlBase             @"urlBase"
+#define kKeySessionId           @"sessionId"
+#define kKeyStep                @"step"
+#define kKeyPortraitDigest      @"portraitDigest"
+
+#define kCommonStateFinished    @"Finished" // Check state.result for verification result.
 #define kCommonStateFailed      @"Failed"   // Check state.result for more details.
 #define kCommonStateError       @"Error"    // Configuration error. Contact Thales representative.
 
+// Key path of the verification result within the reply.
+#define kResultKeyPath          @"state.result"
+
 @implementation KYCSession
 
 // MARK: - Life Cycle
@@ -43,6 +63,30 @@ Please make sure to review our IdCloud documentation, including security guideli
     return [[KYCSession alloc] initWithURL:urlBase portrait:portrait andHandler:handler];
 }
 
++ (instancetype)restoreWithIdentifier:(NSString *)identifier
+                           andHandler:(KYCResponseHandler)handler {
+    NSURL           *directory  = [KYCSession directoryForIdentifier:identifier];
+    NSDictionary    *state      = [NSDictionary dictionaryWithContentsOfURL:[directory URLByAppendingPathComponent:kPersistedState]];
+    if (!state) {
+        return nil;
+    }
+    
+    // Portrait is stored only if it was part of the verification.
+    NSData      *portrait   = [NSData dataWithContentsOfURL:[directory URLByAppendingPathComponent:kPersistedPortrait]];
+    KYCSession  *retValue   = [[KYCSession alloc] initWithURL:state[kKeyUrlBase] portrait:portrait andHandler:handler];
+    retValue->_identifier   = [identifier copy];
+    retValue.sessionId      = state[kKeySessionId];
+    retValue.step           = [state[kKeyStep] integerValue];
+    retValue.portraitDigest = state[kKeyPortraitDigest];
+    
+    return retValue;
+}
+
++ (NSArray<NSString *> *)persistedIdentifiers {
+    NSArray *content = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:[KYCSession rootDirectory].path error:nil];
+    return content ?: @[];
+}
+
 - (instancetype)initWithURL:(NSString *)urlBase
                    portrait:(NSData *)portrait
                  andHandler:(KYCResponseHandler)handler {
@@ -50,6 +94,13 @@ Please make sure to review our IdCloud documentation, including security guideli
         _portrait       = portrait;
         self.urlBase    = urlBase;
         self.handler    = handler;
+        self.started    = [NSDate date];
+        self.steps      = [NSMutableArray new];
+        _identifier     = [[NSUUID UUID] UUIDString];
+        
+        // Whole verification is one span. Steps are traced separately within it.
+        self.traceSpan  = [KYCTrace beginSpanWithName:@"verification" category:kTraceCategoryNetwork];
+        self.traceSpans = [NSMutableArray new];
     }
     
     return self;
@@ -68,9 +119,20 @@ Please make sure to review our IdCloud documentation, including security guideli
 }
 
 - (NSDictionary *)parseResultAndHandleErrors:(NSData *)data {
-    // Parse server response and check possible errors.
+    // Parse server response and check possible errors. Only finished and failed states carry a result. For the
+    // others id and status are enough, so the rest of the reply is not read at all.
+    KYCJSONReader *reader = [KYCJSONReader readerWithBase64Paths:[KYCResponse imageKeyPathsWithPrefix:kResultKeyPath]
+                                                    skippedPaths:[KYCResponse droppedKeyPathsWithPrefix:kResultKeyPath]
+                                                   memberHandler:^BOOL(NSDictionary *root, NSString *key) {
+        NSString *status = root[@"status"];
+        return !root[@"id"] || !status || [status isEqual:kCommonStateFinished] || [status isEqual:kCommonStateFailed];
+    }];
+    
+    KYCTraceSpan    *parseSpan  = [self beginTraceSpan:@"parse" category:kTraceCategoryNetwork];
     NSError         *error      = nil;
-    NSDictionary    *retValue   = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+    NSDictionary    *retValue   = [reader readData:data error:&error];
+    [parseSpan setArgument:@(data.length) forKey:@"bytes"];
+    [parseSpan end];
     if (error) {
         [self handleError:error.localizedDescription];
         return nil;
@@ -97,16 +159,143 @@ Please make sure to review our IdCloud documentation, including security guideli
     return retValue;
 }
 
+- (void)persist {
+    NSURL *directory = [KYCSession directoryForIdentifier:_identifier];
+    [[NSFileManager defaultManager] createDirectoryAtURL:directory withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    // Portrait does not change during the session. Store it only once.
+    NSURL *portraitURL = [directory URLByAppendingPathComponent:kPersistedPortrait];
+    if (_portrait && ![portraitURL checkResourceIsReachableAndReturnError:nil]) {
+        [_portrait writeToURL:portraitURL options:NSDataWritingAtomic | NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication error:nil];
+    }
+    
+    NSMutableDictionary *state = [NSMutableDictionary new];
+    [state setObject:_urlBase forKey:kKeyUrlBase];
+    [state setObject:@(_step) forKey:kKeyStep];
+    if (_sessionId) {
+        [state setObject:_sessionId forKey:kKeySessionId];
+    }
+    if (_portraitDigest) {
+        [state setObject:_portraitDigest forKey:kKeyPortraitDigest];
+    }
+    [state writeToURL:[directory URLByAppendingPathComponent:kPersistedState] atomically:YES];
+}
+
+- (void)removePersisted {
+    [[NSFileManager defaultManager] removeItemAtURL:[KYCSession directoryForIdentifier:_identifier] error:nil];
+}
+
+- (NSURL *)bodyFileURL {
+    return [[KYCSession directoryForIdentifier:_identifier] URLByAppendingPathComponent:kPersistedBody];
+}
+
+- (void)addRetryOfBytes:(long long)bytes {
+    @synchronized (self) {
+        _retryCount++;
+        _resentBytes += bytes;
+    }
+}
+
+- (void)markTimeline:(NSString *)step {
+    // Steps are marked from network and background queues.
+    @synchronized (_steps) {
+        [_steps addObject:@{@"step": step, @"time": @([[NSDate date] timeIntervalSinceDate:_started])}];
+    }
+}
+
+- (NSArray<NSDictionary *> *)timeline {
+    @synchronized (_steps) {
+        return [_steps copy];
+    }
+}
+
+- (KYCTraceSpan *)beginTraceSpan:(NSString *)name category:(NSString *)category {
+    KYCTraceSpan *retValue = _traceSpan ? [KYCTrace beginSpanWithName:name category:category] : nil;
+    if (retValue) {
+        @synchronized (_traceSpans) {
+            [_traceSpans addObject:retValue];
+        }
+    }
+    
+    return retValue;
+}
+
 - (void)handleError:(NSString *)error {
+    if (![self complete]) {
+        return;
+    }
+    
+    [self endTrace:error];
+    [self removePersisted];
+    if (_stagedDigests) {
+        [[KYCBlobUploader sharedInstance] forgetDigests:_stagedDigests];
+    }
+    
     dispatch_async(dispatch_get_main_queue(), ^{
         self.handler(nil, error);
     });
 }
 
 - (void)handleResult:(KYCResponse *)result {
+    if (![self complete]) {
+        return;
+    }
+    
+    [self markTimeline:@"finished"];
+    [self endTrace:nil];
+    [self removePersisted];
+    result.timeline = self.timeline;
+    
     dispatch_async(dispatch_get_main_queue(), ^{
         self.handler(result, nil);
     });
 }
 
+// MARK: - Private Helpers
+
+/**
+ Marks the session as ended. Only the first result or error is reported.
+ 
+ @return {@code True} if the session was still running, else {@code false}.
+ */
+- (BOOL)complete {
+    @synchronized (self) {
+        if (_completed) {
+            return NO;
+        }
+        _completed = YES;
+    }
+    
+    return YES;
+}
+
+- (void)endTrace:(NSString *)error {
+    KYCTraceSpan *traceSpan = _traceSpan;
+    if (!traceSpan) {
+        return;
+    }
+    self.traceSpan = nil;
+    
+    // Steps which did not finish on their own end together with the verification.
+    @synchronized (_traceSpans) {
+        [_traceSpans makeObjectsPerformSelector:@selector(end)];
+        [_traceSpans removeAllObjects];
+    }
+    
+    [traceSpan setArgument:@(_step) forKey:@"step"];
+    [traceSpan setArgument:@(_retryCount) forKey:@"retries"];
+    [traceSpan setArgument:@(_resentBytes) forKey:@"resentBytes"];
+    [traceSpan setArgument:error forKey:@"error"];
+    [traceSpan end];
+}
+
++ (NSURL *)rootDirectory {
+    NSURL *support = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+    return [support URLByAppendingPathComponent:@"KYCSessions" isDirectory:YES];
+}
+
++ (NSURL *)directoryForIdentifier:(NSString *)identifier {
+    return [[KYCSession rootDirectory] URLByAppendingPathComponent:identifier isDirectory:YES];
+}
+
 @end
@@ -0,0 +1,78 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ HTTP body which is produced on the fly instead of being fully serialized in memory.
+ 
+ JSON envelope is written exactly as {@code NSJSONSerialization} would do it, but every {@code NSData} leaf is
+ base64 encoded in small chunks directly into the bound stream. Peak memory stays close to the size of raw images
+ and upload can start before the encoding is finished.
+ */
+@interface KYCStreamedBody : NSObject
+
+/**
+ Exact length of the uncompressed body in bytes. Can be used as {@code Content-Length} header value.
+ */
+@property (nonatomic, assign, readonly) unsigned long long contentLength;
+
+/**
+ Compress the body with gzip while it's being produced. Length of compressed body is not known in advance, so
+ {@code Content-Length} must not be set and request is sent with chunked transfer encoding.
+ */
+@property (nonatomic, assign)           BOOL               compressed;
+
+/**
+ Creates a new {@code KYCStreamedBody} instance.
+ 
+ @param json JSON object. Supported values are {@code NSDictionary}, {@code NSArray}, {@code NSString},
+ {@code NSNumber}, {@code NSNull} and {@code NSData}, which is written as base64 string.
+ @param error Error object.
+ 
+ @return Instance of {@code KYCStreamedBody} or {@code nil} if JSON object is not valid.
+ */
++ (instancetype)bodyWithJSONObject:(NSDictionary *)json error:(NSError **)error;
+
+/**
+ Creates a new stream with the whole body. Each call returns an independent stream, so it can be used for
+ {@code URLSession:task:needNewBodyStream:} as well.
+ 
+ @return Unopened input stream.
+ */
+- (NSInputStream *)inputStream;
+
+/**
+ Returns body which created given stream.
+ 
+ @param stream Stream returned by {@code inputStream}.
+ 
+ @return Instance of {@code KYCStreamedBody} or {@code nil} if stream was not created by any body.
+ */
++ (instancetype)bodyOfStream:(NSInputStream *)stream;
+
+/**
+ Builds the whole body in memory. Used only for debugging and stand-in server comparison.
+ 
+ @return Complete body.
+ */
+- (NSData *)serializedData;
+
+@end
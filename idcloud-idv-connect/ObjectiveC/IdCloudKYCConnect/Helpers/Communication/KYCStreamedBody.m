@@ -0,0 +1,439 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCStreamedBody.h"
+#import "KYCCodec.h"
+#import <zlib.h>
+#import <objc/runtime.h>
+
+// Must be dividable by 3 so base64 chunks can be simple concatenated without padding in the middle.
+#define kErrorDomain        @"KYCStreamedBody"
+
+#define kBase64ChunkSize    (48 * 1024)
+#define kBoundBufferSize    (64 * 1024)
+#define kDeflateBufferSize  (16 * 1024)
+
+// Base64 text of JPEG data does not compress much. Higher levels only burn CPU time.
+#define kCompressionLevel   Z_BEST_SPEED
+
+// Window bits for gzip header and trailer instead of raw zlib format.
+#define kGzipWindowBits     (15 + 16)
+
+// Associated object key. Each stream keeps reference to the body it was created from.
+static char kStreamBodyKey;
+
+/**
+ Produces the body in small chunks on demand. Every stream of the body has its own producer.
+ */
+@interface KYCBodyProducer : NSObject {
+    z_stream _deflateStream;
+}
+
+// Mix of NSData segments shared with the body. Position of the next chunk.
+@property (nonatomic, strong) NSArray       *segments;
+@property (nonatomic, assign) NSUInteger    segmentIndex;
+@property (nonatomic, assign) NSUInteger    segmentOffset;
+// Compression state. Finished once gzip trailer was produced or deflate failed.
+@property (nonatomic, assign) BOOL          compressed;
+@property (nonatomic, assign) BOOL          deflateReady;
+@property (nonatomic, assign) BOOL          finished;
+
+- (instancetype)initWithSegments:(NSArray *)segments compressed:(BOOL)compressed;
+
+/**
+ Returns next part of the body.
+
+ @return Body bytes or {@code nil} once whole body was produced.
+ */
+- (NSData *)nextChunk;
+
+@end
+
+/**
+ Feeds single bound stream pair from the shared writer thread. Bytes are produced only when the reader made space
+ in the bound buffer, so no thread is blocked while NSURLSession waits for network.
+ */
+@interface KYCBodyWriter : NSObject <NSStreamDelegate>
+
+@property (nonatomic, strong) NSOutputStream    *output;
+@property (nonatomic, strong) KYCBodyProducer   *producer;
+@property (nonatomic, strong) NSData            *pending;
+@property (nonatomic, assign) NSUInteger        pendingOffset;
+
+/**
+ Thread with run loop on which all body streams are written.
+ 
+ @return Shared writer thread.
+ */
++ (NSThread *)writerThread;
+
+/**
+ Opens the output stream and starts writing once there is space in the bound buffer. Must run on writer thread.
+ */
+- (void)start;
+
+@end
+
+@interface KYCStreamedBody()
+
+// Mix of NSData segments. Raw JSON fragments are stored as they are, images are wrapped in NSArray.
+@property (nonatomic, strong) NSMutableArray    *segments;
+
+@end
+
+@implementation KYCStreamedBody
+
+// MARK: - Life Cycle
+
++ (instancetype)bodyWithJSONObject:(NSDictionary *)json error:(NSError **)error {
+    KYCStreamedBody *retValue = [[KYCStreamedBody alloc] init];
+    if (![retValue appendObject:json error:error]) {
+        return nil;
+    }
+    
+    return retValue;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.segments   = [NSMutableArray new];
+        _contentLength  = 0;
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (NSInputStream *)inputStream {
+    CFReadStreamRef     readStream;
+    CFWriteStreamRef    writeStream;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, kBoundBufferSize);
+    
+    KYCBodyWriter *writer   = [KYCBodyWriter new];
+    writer.output           = CFBridgingRelease(writeStream);
+    writer.producer         = [[KYCBodyProducer alloc] initWithSegments:[_segments copy] compressed:_compressed];
+    
+    // All uploads share one writer thread. Write fails once the reader is closed. Most probably task was cancelled.
+    [writer performSelector:@selector(start) onThread:[KYCBodyWriter writerThread] withObject:nil waitUntilDone:NO];
+    
+    NSInputStream *retValue = CFBridgingRelease(readStream);
+    objc_setAssociatedObject(retValue, &kStreamBodyKey, self, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    
+    return retValue;
+}
+
++ (instancetype)bodyOfStream:(NSInputStream *)stream {
+    return stream ? objc_getAssociatedObject(stream, &kStreamBodyKey) : nil;
+}
+
+- (NSData *)serializedData {
+    NSMutableData   *retValue   = [NSMutableData dataWithCapacity:_compressed ? 0 : (NSUInteger)_contentLength];
+    KYCBodyProducer *producer   = [[KYCBodyProducer alloc] initWithSegments:_segments compressed:_compressed];
+    for (NSData *chunk = [producer nextChunk]; chunk; chunk = [producer nextChunk]) {
+        [retValue appendData:chunk];
+    }
+    
+    return retValue;
+}
+
+// MARK: - Private Helpers - Building
+
+- (BOOL)appendObject:(id)object error:(NSError **)error {
+    if ([object isKindOfClass:[NSDictionary class]]) {
+        [self appendFragment:@"{"];
+        BOOL first = YES;
+        for (NSString *loopKey in object) {
+            if (!first) {
+                [self appendFragment:@","];
+            }
+            first = NO;
+            
+            if (![self appendScalar:loopKey error:error]) {
+                return NO;
+            }
+            [self appendFragment:@":"];
+            if (![self appendObject:object[loopKey] error:error]) {
+                return NO;
+            }
+        }
+        [self appendFragment:@"}"];
+        return YES;
+    } else if ([object isKindOfClass:[NSArray class]]) {
+        [self appendFragment:@"["];
+        for (NSUInteger index = 0; index < [object count]; index++) {
+            if (index) {
+                [self appendFragment:@","];
+            }
+            if (![self appendObject:object[index] error:error]) {
+                return NO;
+            }
+        }
+        [self appendFragment:@"]"];
+        return YES;
+    } else if ([object isKindOfClass:[NSData class]]) {
+        // Base64 alphabet does not need any escaping, so quotes are enough.
+        NSData *data = object;
+        [self appendFragment:@"\""];
+        [_segments addObject:@[data]];
+        _contentLength += KYCCodecBase64EncodedLength(data.length);
+        [self appendFragment:@"\""];
+        return YES;
+    } else {
+        return [self appendScalar:object error:error];
+    }
+}
+
+- (BOOL)appendScalar:(id)scalar error:(NSError **)error {
+    // Serializer throws on unsupported types instead of returning error.
+    if (![NSJSONSerialization isValidJSONObject:@[scalar]]) {
+        if (error) {
+            NSString *description = [NSString stringWithFormat:@"Unsupported JSON value of type %@.", NSStringFromClass([scalar class])];
+            *error = [NSError errorWithDomain:kErrorDomain code:-1 userInfo:@{NSLocalizedDescriptionKey: description}];
+        }
+        return NO;
+    }
+    
+    // Let the system serializer handle escaping. Wrap value in array and strip brackets.
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@[scalar] options:0 error:error];
+    if (!data) {
+        return NO;
+    }
+    
+    [self appendData:[data subdataWithRange:NSMakeRange(1, data.length - 2)]];
+    return YES;
+}
+
+- (void)appendFragment:(NSString *)fragment {
+    [self appendData:[fragment dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)appendData:(NSData *)data {
+    // Merge consecutive fragments to keep number of writes low.
+    NSMutableData *last = [_segments lastObject];
+    if ([last isKindOfClass:[NSMutableData class]]) {
+        [last appendData:data];
+    } else {
+        [_segments addObject:[data mutableCopy]];
+    }
+    _contentLength += data.length;
+}
+
+@end
+
+@implementation KYCBodyProducer
+
+// MARK: - Life Cycle
+
+- (instancetype)initWithSegments:(NSArray *)segments compressed:(BOOL)compressed {
+    if (self = [super init]) {
+        _segments   = segments;
+        _compressed = compressed;
+        
+        if (compressed) {
+            memset(&_deflateStream, 0, sizeof(_deflateStream));
+            _deflateReady   = deflateInit2(&_deflateStream, kCompressionLevel, Z_DEFLATED, kGzipWindowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+            _finished       = !_deflateReady;
+        }
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    if (_deflateReady) {
+        deflateEnd(&_deflateStream);
+    }
+}
+
+// MARK: - Public API
+
+- (NSData *)nextChunk {
+    if (!_compressed) {
+        return [self nextPlainChunk];
+    }
+    
+    // Every produced chunk is compressed right away. Neither plain nor compressed body is ever kept whole.
+    NSMutableData *retValue = [NSMutableData data];
+    while (!retValue.length && !_finished) {
+        NSData  *plain  = [self nextPlainChunk];
+        int     flush   = plain ? Z_NO_FLUSH : Z_FINISH;
+        if (![self deflate:plain flush:flush output:retValue] || !plain) {
+            _finished = YES;
+        }
+    }
+    
+    return retValue.length ? retValue : nil;
+}
+
+// MARK: - Private Helpers
+
+- (NSData *)nextPlainChunk {
+    while (_segmentIndex < _segments.count) {
+        id segment = _segments[_segmentIndex];
+        
+        // Raw JSON fragment.
+        if (![segment isKindOfClass:[NSArray class]]) {
+            _segmentIndex++;
+            return segment;
+        }
+        
+        // Image is base64 encoded chunk by chunk. Encoded straight into the returned chunk without temporary copies.
+        NSData *data = [segment firstObject];
+        if (_segmentOffset < data.length) {
+            NSUInteger      length      = MIN(kBase64ChunkSize, data.length - _segmentOffset);
+            NSMutableData   *retValue   = [NSMutableData dataWithLength:KYCCodecBase64EncodedLength(length)];
+            KYCCodecBase64Encode((const uint8_t *)data.bytes + _segmentOffset, length, retValue.mutableBytes);
+            _segmentOffset += length;
+            return retValue;
+        }
+        
+        _segmentIndex++;
+        _segmentOffset = 0;
+    }
+    
+    return nil;
+}
+
+- (BOOL)deflate:(NSData *)input flush:(int)flush output:(NSMutableData *)output {
+    uint8_t buffer[kDeflateBufferSize];
+    _deflateStream.next_in  = (Bytef *)input.bytes;
+    _deflateStream.avail_in = (uInt)input.length;
+    
+    // Drain all output. With Z_FINISH continue until gzip trailer is written.
+    int result;
+    do {
+        _deflateStream.next_out     = buffer;
+        _deflateStream.avail_out    = kDeflateBufferSize;
+        result                      = deflate(&_deflateStream, flush);
+        if (result == Z_STREAM_ERROR) {
+            return NO;
+        }
+        
+        [output appendBytes:buffer length:kDeflateBufferSize - _deflateStream.avail_out];
+    } while (_deflateStream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    
+    return YES;
+}
+
+@end
+
+@implementation KYCBodyWriter
+
+// MARK: - Static Helpers
+
++ (NSThread *)writerThread {
+    static NSThread         *sThread = nil;
+    static dispatch_once_t  onceToken;
+    dispatch_once(&onceToken, ^{
+        sThread = [[NSThread alloc] initWithBlock:^{
+            // Port keeps the run loop alive while there is nothing to write.
+            [[NSRunLoop currentRunLoop] addPort:[NSMachPort port] forMode:NSDefaultRunLoopMode];
+            while (YES) {
+                @autoreleasepool {
+                    [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+                }
+            }
+        }];
+        sThread.name                = @"KYCStreamedBody";
+        sThread.qualityOfService    = NSQualityOfServiceUtility;
+        [sThread start];
+    });
+    
+    return sThread;
+}
+
++ (NSMutableSet<KYCBodyWriter *> *)activeWriters {
+    // Stream keeps only weak reference to its delegate. Accessed only from writer thread.
+    static NSMutableSet     *sWriters = nil;
+    static dispatch_once_t  onceToken;
+    dispatch_once(&onceToken, ^{
+        sWriters = [NSMutableSet new];
+    });
+    
+    return sWriters;
+}
+
+// MARK: - Public API
+
+- (void)start {
+    [[KYCBodyWriter activeWriters] addObject:self];
+    
+    _output.delegate = self;
+    [_output scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    [_output open];
+}
+
+// MARK: - NSStreamDelegate
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode {
+    switch (eventCode) {
+        case NSStreamEventHasSpaceAvailable:
+            [self writeAvailable];
+            break;
+        case NSStreamEventErrorOccurred:
+        case NSStreamEventEndEncountered:
+            [self finish];
+            break;
+        default:
+            break;
+    }
+}
+
+// MARK: - Private Helpers
+
+- (void)writeAvailable {
+    while (_output.hasSpaceAvailable) {
+        // Produce next chunk only once the previous one was consumed.
+        if (_pendingOffset >= _pending.length) {
+            @autoreleasepool {
+                self.pending = [_producer nextChunk];
+            }
+            self.pendingOffset = 0;
+            
+            if (!_pending) {
+                [self finish];
+                return;
+            }
+            continue;
+        }
+        
+        NSInteger written = [_output write:(const uint8_t *)_pending.bytes + _pendingOffset
+                                 maxLength:_pending.length - _pendingOffset];
+        if (written <= 0) {
+            [self finish];
+            return;
+        }
+        _pendingOffset += written;
+    }
+}
+
+- (void)finish {
+    [_output close];
+    [_output removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    _output.delegate    = nil;
+    self.pending        = nil;
+    
+    [[KYCBodyWriter activeWriters] removeObject:self];
+}
+
+@end
@@ -0,0 +1,47 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+@class KYCSession;
+
+/**
+ Transport completion handler. Same signature as regular {@code NSURLSession} data task handler.
+ */
+typedef void (^KYCTransportHandler)(NSData *data, NSURLResponse *response, NSError *error);
+
+/**
+ Delivers verification requests to the backend. {@code KYCCommunication} sends all verification steps through it,
+ so the backend can be replaced by a different transport without changes in the verification flow.
+ */
+@protocol KYCTransport <NSObject>
+
+/**
+ Sends the request.
+
+ @param request Request to be sent.
+ @param session Session which owns the request.
+ @param handler Callback. Called on background queue.
+ */
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler;
+
+@end
@@ -0,0 +1,211 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCURLSessionManager.h"
+#import "KYCCommunication.h"
+#import "KYCStreamedBody.h"
+
+#define kKeyGzipRequestHosts @"KYCGzipRequestHosts"
+
+static KYCURLSessionManager *sInstance = nil;
+
+@interface KYCURLSessionManager() <NSURLSessionTaskDelegate>
+
+@property (nonatomic, strong)   NSURLSession    *currentSession;
+@property (nonatomic, copy)     NSString        *currentCredentials;
+// Streamed bodies of running tasks. NSURLSession asks for a new stream when it has to send the body again.
+@property (nonatomic, strong)   NSMapTable<NSURLSessionTask *, KYCStreamedBody *>  *streamedBodies;
+
+@end
+
+@implementation KYCURLSessionManager
+
+// MARK: - Static Helpers
+
++ (instancetype)sharedInstance {
+    @synchronized (self) {
+        if (!sInstance) {
+            sInstance = [[KYCURLSessionManager alloc] init];
+        }
+        
+        return sInstance;
+    }
+}
+
++ (void)end {
+    @synchronized (self) {
+        [sInstance.currentSession finishTasksAndInvalidate];
+        sInstance = nil;
+    }
+}
+
+// MARK: - Life Cycle
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _streamedBodies = [NSMapTable strongToStrongObjectsMapTable];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (NSURLSession *)session {
+    KYCManager  *manager        = [KYCManager sharedInstance];
+    NSString    *credentials    = [NSString stringWithFormat:@"%@:%@", manager.apiKey, manager.jsonWebToken];
+    
+    @synchronized (self) {
+        // Credentials are part of the session configuration. Build new session only when they change.
+        if (!_currentSession || ![_currentCredentials isEqualToString:credentials]) {
+            // Let already running tasks finish with the old configuration.
+            [_currentSession finishTasksAndInvalidate];
+            
+            self.currentSession     = [self createUrlSession:manager];
+            self.currentCredentials = credentials;
+        }
+        
+        return _currentSession;
+    }
+}
+
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler {
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request completionHandler:handler];
+    [self registerBodyOfTask:task request:request];
+    [task resume];
+}
+
+- (void)resetMetrics {
+    @synchronized (self) {
+        _transactionCount       = 0;
+        _reusedConnectionCount  = 0;
+    }
+}
+
+- (BOOL)gzipRequestSupported {
+    // Capability is stored per host and survives app restart, so even the first upload can be compressed.
+    NSString        *host   = [NSURL URLWithString:[KYCCommunication baseURL]].host;
+    NSDictionary    *hosts  = [[NSUserDefaults standardUserDefaults] dictionaryForKey:kKeyGzipRequestHosts];
+    return host && [hosts[host] boolValue];
+}
+
+- (void)updateCapabilitiesWithMetrics:(NSURLSessionTaskMetrics *)metrics {
+    for (NSURLSessionTaskTransactionMetrics *loopTransaction in metrics.transactionMetrics) {
+        NSHTTPURLResponse   *response   = (NSHTTPURLResponse *)loopTransaction.response;
+        NSString            *host       = loopTransaction.request.URL.host;
+        if (![response isKindOfClass:[NSHTTPURLResponse class]] || !host) {
+            continue;
+        }
+        
+        // Server lists accepted request encodings in response header (RFC 7694).
+        // Unsupported Media Type for compressed request means server does not handle it at all.
+        NSString    *acceptEncoding = response.allHeaderFields[@"Accept-Encoding"];
+        BOOL        rejected        = response.statusCode == 415 &&
+                                      [[loopTransaction.request valueForHTTPHeaderField:@"Content-Encoding"] isEqualToString:@"gzip"];
+        if (acceptEncoding) {
+            [self setGzipRequestSupported:[acceptEncoding.lowercaseString containsString:@"gzip"] host:host];
+        } else if (rejected) {
+            [self setGzipRequestSupported:NO host:host];
+        }
+    }
+}
+
+// MARK: - Private Helpers
+
+- (void)registerBodyOfTask:(NSURLSessionTask *)task request:(NSURLRequest *)request {
+    KYCStreamedBody *body = [KYCStreamedBody bodyOfStream:request.HTTPBodyStream];
+    if (body) {
+        @synchronized (self) {
+            [_streamedBodies setObject:body forKey:task];
+        }
+    }
+}
+
+- (void)setGzipRequestSupported:(BOOL)supported host:(NSString *)host {
+    @synchronized (self) {
+        NSUserDefaults      *defaults   = [NSUserDefaults standardUserDefaults];
+        NSMutableDictionary *hosts      = [[defaults dictionaryForKey:kKeyGzipRequestHosts] mutableCopy] ?: [NSMutableDictionary new];
+        if ([hosts[host] boolValue] != supported) {
+            hosts[host] = @(supported);
+            [defaults setObject:hosts forKey:kKeyGzipRequestHosts];
+        }
+    }
+}
+
+- (NSURLSession *)createUrlSession:(KYCManager *)manager {
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+    configuration.HTTPAdditionalHeaders = @{
+        @"Accept"           : @"application/json",
+        @"Content-Type"     : @"application/json",
+        @"Authorization"    : [NSString stringWithFormat:@"Bearer %@", manager.jsonWebToken],
+        @"X-API-KEY"        : manager.apiKey
+    };
+    
+    // All requests go to the same host. Keep them on one connection.
+    configuration.HTTPMaximumConnectionsPerHost = 1;
+    
+    return [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:nil];
+}
+
+// MARK: - NSURLSessionTaskDelegate
+
+- (void)URLSession:(NSURLSession *)session
+              task:(NSURLSessionTask *)task
+ needNewBodyStream:(void (^)(NSInputStream *bodyStream))completionHandler {
+    // Redirect, authentication or retry on a stale connection. Stream already read can't be rewound.
+    KYCStreamedBody *body;
+    @synchronized (self) {
+        body = [_streamedBodies objectForKey:task];
+    }
+    
+    completionHandler(body.inputStream);
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [self updateCapabilitiesWithMetrics:metrics];
+    
+    @synchronized (self) {
+        // Metrics are the last callback of the task. Body is not needed anymore.
+        [_streamedBodies removeObjectForKey:task];
+        
+        // Ignore metrics from sessions which were already replaced.
+        if (session != _currentSession) {
+            return;
+        }
+        
+        for (NSURLSessionTaskTransactionMetrics *loopTransaction in metrics.transactionMetrics) {
+            // Only network transactions are interesting. Skip local cache.
+            if (loopTransaction.resourceFetchType != NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad) {
+                continue;
+            }
+            
+            _transactionCount++;
+            if (loopTransaction.isReusedConnection) {
+                _reusedConnectionCount++;
+            }
+        }
+    }
+}
+
+@end
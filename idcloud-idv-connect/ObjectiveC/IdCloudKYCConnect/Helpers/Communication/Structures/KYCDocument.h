@@ -33,19 +33,19 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (nonatomic, strong)   KYCVerificationResult   *vericitaionResult;
 
 /**
- Selfie image.
+ Selfie image. Decoded on first access.
  */
-@property (nonatomic, copy)     NSData                  *portrait;
+@property (nonatomic, copy, readonly)   NSData          *portrait;
 
 /**
- Front image of document.
+ Front image of document. Decoded on first access.
  */
-@property (nonatomic, copy)     NSData                  *imageWhiteBack;
+@property (nonatomic, copy, readonly)   NSData          *imageWhiteBack;
 
 /**
- Back image of document.
+ Back image of document. Decoded on first access.
  */
-@property (nonatomic, copy)     NSData                  *imageWhiteFront;
+@property (nonatomic, copy, readonly)   NSData          *imageWhiteFront;
 
 /**
  Creates a new instance of {@code KYCDocument}.
@@ -21,7 +21,15 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCDocument.h"
-#import "KYCCommunication.h"
+#import "KYCLazyImage.h"
+
+@interface KYCDocument()
+
+@property (nonatomic, strong)   KYCLazyImage    *lazyPortrait;
+@property (nonatomic, strong)   KYCLazyImage    *lazyImageWhiteBack;
+@property (nonatomic, strong)   KYCLazyImage    *lazyImageWhiteFront;
+
+@end
 
 @implementation KYCDocument
 
@@ -32,14 +40,30 @@ Please make sure to review our IdCloud documentation, including security guideli
 - (instancetype)initWithJSON:(NSDictionary *)response {
     if (response && (self = [super init])) {
         self.vericitaionResult      = [KYCVerificationResult createWithJSON:response[@"verificationResults"]];
-        self.portrait               = [IdCloudHelper imageFromBase64:response[@"portrait"]];
-        self.imageWhiteBack         = [IdCloudHelper imageFromBase64:response[@"backWhiteImage"]];
-        self.imageWhiteFront        = [IdCloudHelper imageFromBase64:response[@"frontWhiteImage"]];
+        self.lazyPortrait           = [KYCLazyImage imageWithJSONValue:response[@"portrait"]];
+#if !CFG_IDCLOUD_DROP_ECHOED_IMAGES
+        self.lazyImageWhiteBack     = [KYCLazyImage imageWithJSONValue:response[@"backWhiteImage"]];
+        self.lazyImageWhiteFront    = [KYCLazyImage imageWithJSONValue:response[@"frontWhiteImage"]];
+#endif
     }
     
     return self;
 }
 
+// MARK: - Public API
+
+- (NSData *)portrait {
+    return _lazyPortrait.data;
+}
+
+- (NSData *)imageWhiteBack {
+    return _lazyImageWhiteBack.data;
+}
+
+- (NSData *)imageWhiteFront {
+    return _lazyImageWhiteFront.data;
+}
+
 - (NSString *)description {
     NSMutableString *retValue = [NSMutableString stringWithFormat:@"%@:\n", NSStringFromClass([self class])];
     
@@ -36,9 +36,9 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (nonatomic, copy)     NSString    *result;
 
 /**
- Image data.
+ Image data. Decoded on first access.
  */
-@property (nonatomic, copy)     NSData      *image;
+@property (nonatomic, copy, readonly) NSData *image;
 
 /**
  Face match score.
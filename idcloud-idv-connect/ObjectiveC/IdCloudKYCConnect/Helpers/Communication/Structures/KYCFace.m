@@ -21,7 +21,13 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCFace.h"
-#import "KYCCommunication.h"
+#import "KYCLazyImage.h"
+
+@interface KYCFace()
+
+@property (nonatomic, strong) KYCLazyImage *lazyImage;
+
+@end
 
 @implementation KYCFace
 
@@ -32,12 +38,20 @@ Please make sure to review our IdCloud documentation, including security guideli
 - (instancetype)initWithJSON:(NSDictionary *)response {
     if (response && (self = [super init])) {
         self.result = response[@"result"];
-        self.image  = [IdCloudHelper imageFromBase64:response[@"image"]];
         self.score  = [response[@"score"] integerValue];
+#if !CFG_IDCLOUD_DROP_ECHOED_IMAGES
+        self.lazyImage = [KYCLazyImage imageWithJSONValue:response[@"image"]];
+#endif
     }
     
     return self;
 }
 
+// MARK: - Public API
+
+- (NSData *)image {
+    return _lazyImage.data;
+}
+
 @end
 
@@ -22,32 +22,35 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 #import "KYCNameValue.h"
 
+/**
+ Fields extracted from the document. Arrays are parsed on first access.
+ */
 @interface KYCFields : NSObject
 
 /**
  OCR - readable texts.
  */
-@property (nonatomic, strong)   NSArray<KYCNameValue *> *ocr;
+@property (nonatomic, strong, readonly) NSArray<KYCNameValue *> *ocr;
 
 /**
  Fields from the machine Readable Zone.
  */
-@property (nonatomic, strong)   NSArray<KYCNameValue *> *mrz;
+@property (nonatomic, strong, readonly) NSArray<KYCNameValue *> *mrz;
 
 /**
  Magstripe data.
  */
-@property (nonatomic, strong)   NSArray<KYCNameValue *> *magstripe;
+@property (nonatomic, strong, readonly) NSArray<KYCNameValue *> *magstripe;
 
 /**
  2D barcode data.
  */
-@property (nonatomic, strong)   NSArray<KYCNameValue *> *barcode2d;
+@property (nonatomic, strong, readonly) NSArray<KYCNameValue *> *barcode2d;
 
 /**
  Non-latin version of the field.
  */
-@property (nonatomic, strong)   NSArray<KYCNameValue *> *native;
+@property (nonatomic, strong, readonly) NSArray<KYCNameValue *> *native;
 
 /**
  Creates a new {@code KYCFields} instance.
@@ -24,6 +24,14 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 #import "KYCFields.h"
 
+@interface KYCFields()
+
+// Raw fields from parsed response. Arrays are built only for keys which are really used.
+@property (nonatomic, strong) NSDictionary                                                *response;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<KYCNameValue *> *>  *parsed;
+
+@end
+
 @implementation KYCFields
 
 + (instancetype)createWithJSON:(NSDictionary *)response {
@@ -32,16 +40,49 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 - (instancetype)initWithDocumentJSON:(NSDictionary *)response {
     if (response && (self = [super init])) {
-        self.ocr        = [KYCFields parseNameValueArray:response key:@"OCR"];
-        self.mrz        = [KYCFields parseNameValueArray:response key:@"MRZ"];
-        self.magstripe  = [KYCFields parseNameValueArray:response key:@"MAGSTRIPE"];
-        self.barcode2d  = [KYCFields parseNameValueArray:response key:@"BARCODE_2D"];
-        self.native     = [KYCFields parseNameValueArray:response key:@"NATIVE"];
+        self.response   = response;
+        self.parsed     = [NSMutableDictionary new];
     }
     
     return self;
 }
 
+// MARK: - Public API
+
+- (NSArray<KYCNameValue *> *)ocr {
+    return [self nameValueArrayForKey:@"OCR"];
+}
+
+- (NSArray<KYCNameValue *> *)mrz {
+    return [self nameValueArrayForKey:@"MRZ"];
+}
+
+- (NSArray<KYCNameValue *> *)magstripe {
+    return [self nameValueArrayForKey:@"MAGSTRIPE"];
+}
+
+- (NSArray<KYCNameValue *> *)barcode2d {
+    return [self nameValueArrayForKey:@"BARCODE_2D"];
+}
+
+- (NSArray<KYCNameValue *> *)native {
+    return [self nameValueArrayForKey:@"NATIVE"];
+}
+
+// MARK: - Private Helpers
+
+- (NSArray<KYCNameValue *> *)nameValueArrayForKey:(NSString *)key {
+    @synchronized (self) {
+        NSArray<KYCNameValue *> *retValue = _parsed[key];
+        if (!retValue) {
+            retValue = [KYCFields parseNameValueArray:_response key:key];
+            [_parsed setObject:retValue forKey:key];
+        }
+        
+        return retValue;
+    }
+}
+
 + (NSArray<KYCNameValue *> *)parseNameValueArray:(NSDictionary *)response key:(NSString *)key {
     NSMutableArray *retValue = [NSMutableArray new];
     for (NSDictionary *loopNameValue in response[key]) {
@@ -54,11 +95,11 @@ Please make sure to review our IdCloud documentation, including security guideli
 - (NSString *)description {
     NSMutableString *retValue = [NSMutableString stringWithFormat:@"%@:\n", NSStringFromClass([self class])];
     
-    [retValue appendFormat:@"ocr: %@\n", _ocr];
-    [retValue appendFormat:@"mrz: %@\n", _mrz];
-    [retValue appendFormat:@"magstripe: %@\n", _magstripe];
-    [retValue appendFormat:@"barcode2d: %@\n", _barcode2d];
-    [retValue appendFormat:@"native: %@\n", _native];
+    [retValue appendFormat:@"ocr: %@\n", self.ocr];
+    [retValue appendFormat:@"mrz: %@\n", self.mrz];
+    [retValue appendFormat:@"magstripe: %@\n", self.magstripe];
+    [retValue appendFormat:@"barcode2d: %@\n", self.barcode2d];
+    [retValue appendFormat:@"native: %@\n", self.native];
 
     return retValue;
 }
@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Base64 encoded image received from the server, decoded on first access.
+
+ Only reference to the string from parsed response is kept, so there is no copy until the image is really needed.
+ Once decoded, the string is released and only binary data remain. Images already decoded by {@code KYCJSONReader}
+ are kept as they are.
+ */
+@interface KYCLazyImage : NSObject
+
+/**
+ Decoded image data or {@code nil} if the string is not valid base64.
+ */
+@property (nonatomic, strong, readonly) NSData *data;
+
+/**
+ Creates a new {@code KYCLazyImage} instance.
+ 
+ @param value JSON value. Either base64 encoded {@code NSString} or already decoded {@code NSData}.
+ 
+ @return Instance of {@code KYCLazyImage} or {@code nil} if there is no image.
+ */
++ (instancetype)imageWithJSONValue:(id)value;
+
+@end
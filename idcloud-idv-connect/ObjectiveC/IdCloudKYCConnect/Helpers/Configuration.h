@@ -23,6 +23,44 @@
 // IdCloud demo endpoint url.
 #define CFG_IDCLOUD_BASE_URL @""
 
+// Stream verification body and encode images on the fly instead of building whole JSON in memory.
+#define CFG_IDCLOUD_STREAMED_UPLOAD 1
+
+// Compress verification body with gzip once the backend announces support for it. Opt-in.
+#define CFG_IDCLOUD_COMPRESSED_UPLOAD 0
+
+// Prepare selfie request in parallel with document upload and continue with next step directly from network queue.
+#define CFG_IDCLOUD_PIPELINED_UPLOAD 1
+
+// Send verification requests through background URL session, so upload and processing continue while app is suspended.
+#define CFG_IDCLOUD_BACKGROUND_UPLOAD 1
+
+// Upload each image only once to content-addressed staging area and reference it by digest in verification steps.
+// Repeated steps then do not send the images again. Requires backend with staging support. Opt-in.
+#define CFG_IDCLOUD_STAGED_UPLOAD 0
+
+// Staging area URL. Images are stored as <url>/<digest>.
+#define CFG_IDCLOUD_STAGING_URL @""
+
+// Number of seconds the staging area is known to keep images. Older images are checked again before they are used.
+#define CFG_IDCLOUD_STAGING_RETENTION_SEC 600
+
+// Number of times a verification step is repeated after communication error which kept the request from the server.
+#define CFG_IDCLOUD_STEP_RETRY_COUNT 2
+
+// Do not keep document and selfie images echoed back in verification result. Application shows only extracted portrait.
+#define CFG_IDCLOUD_DROP_ECHOED_IMAGES 1
+
+// Trace duration of capture, image processing and verification steps. Spans are visible in Instruments as signposts
+// and every finished verification is exported as Chrome trace JSON to Documents/kyc-trace.json. Opt-in.
+#define CFG_IDCLOUD_TRACE 0
+
+// Replace verification backend with in-process emulation. Whole flow runs offline, useful for demos and load testing.
+#define CFG_IDCLOUD_LOOPBACK 0
+
+// Seed of emulated backend. Same seed gives same sequence of latencies and failures.
+#define CFG_IDCLOUD_LOOPBACK_SEED 1
+
 // Acuant account username.
 #define CFG_ACUANT_USERNAME @""
 
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Immutable captured image shared between scanner, overview and upload.
+
+ Encoded bytes are stored once and handed over by reference. Display does not decode the full resolution image,
+ but only a downsampled thumbnail, which is created on first use and cached.
+ */
+@interface KYCImageBuffer : NSObject
+
+/**
+ Encoded image (JPEG or PNG). Same instance is used for display and upload.
+ */
+@property (nonatomic, strong, readonly) NSData      *data;
+
+/**
+ Number of times the encoded bytes were copied. Zero if capture output was taken over without copy.
+ */
+@property (nonatomic, assign, readonly) NSUInteger  copyCount;
+
+/**
+ Number of times the image was decoded for display.
+ */
+@property (nonatomic, assign, readonly) NSUInteger  decodeCount;
+
+/**
+ Creates a new {@code KYCImageBuffer} instance.
+
+ @param data Encoded image. Immutable data is retained without copy, mutable one is copied once.
+
+ @return Instance of {@code KYCImageBuffer} or {@code nil} if there is no data.
+ */
++ (instancetype)bufferWithData:(NSData *)data;
+
+/**
+ Returns downsampled image for display. Image is decoded directly to requested size and cached.
+
+ @param maxPixelSize Maximum width or height in pixels.
+
+ @return Decoded thumbnail or {@code nil} if data are not a valid image.
+ */
+- (UIImage *)thumbnailWithMaxPixelSize:(CGFloat)maxPixelSize;
+
+@end
@@ -0,0 +1,92 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCImageBuffer.h"
+#import <ImageIO/ImageIO.h>
+
+@interface KYCImageBuffer()
+
+@property (nonatomic, strong) UIImage   *thumbnail;
+@property (nonatomic, assign) CGFloat   thumbnailSize;
+
+@end
+
+@implementation KYCImageBuffer
+
+// MARK: - Life Cycle
+
++ (instancetype)bufferWithData:(NSData *)data {
+    if (!data) {
+        return nil;
+    }
+    
+    return [[KYCImageBuffer alloc] initWithData:data];
+}
+
+- (instancetype)initWithData:(NSData *)data {
+    if (self = [super init]) {
+        // Copy of immutable data returns the same instance. Only mutable data, which producer could still change,
+        // are really copied.
+        _data       = [data copy];
+        _copyCount  = _data == data ? 0 : 1;
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (UIImage *)thumbnailWithMaxPixelSize:(CGFloat)maxPixelSize {
+    @synchronized (self) {
+        // Bigger thumbnail can be used for smaller views as well.
+        if (_thumbnail && _thumbnailSize >= maxPixelSize) {
+            return _thumbnail;
+        }
+        
+        // Image source reads directly from shared data. JPEG decoder can skip details not needed for target size.
+        CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)_data, NULL);
+        if (!source) {
+            return nil;
+        }
+        
+        NSDictionary *options = @{
+            (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways   : @YES,
+            (__bridge NSString *)kCGImageSourceCreateThumbnailWithTransform     : @YES,
+            (__bridge NSString *)kCGImageSourceShouldCacheImmediately           : @YES,
+            (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize            : @(maxPixelSize)
+        };
+        CGImageRef image = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+        CFRelease(source);
+        if (!image) {
+            return nil;
+        }
+        
+        self.thumbnail      = [UIImage imageWithCGImage:image];
+        self.thumbnailSize  = maxPixelSize;
+        _decodeCount++;
+        CGImageRelease(image);
+        
+        return _thumbnail;
+    }
+}
+
+@end
@@ -22,6 +22,8 @@
 
 #define kZeroDelay nil
 
+#import "KYCImageBuffer.h"
+
 #define kNotificationDataLayerChanged @"kNotificationDataLayerChanged"
 
 typedef void (^FaceIdCompletion)(BOOL success, NSString *error);
@@ -42,11 +44,12 @@ typedef NSArray<NSArray <IdCloudOption *> *> OptionArray;
 @property (nonatomic, copy, readonly)   NSString                *jsonWebToken;
 @property (nonatomic, copy, readonly)   NSString                *apiKey;
 @property (nonatomic, assign, readonly) NSInteger               maxImageWidth;
+@property (nonatomic, assign)           NSInteger               imageSizeBudget;
 
 // Scanned elements
-@property (nonatomic, strong) NSData                            *scannedDocFront;
-@property (nonatomic, strong) NSData                            *scannedDocBack;
-@property (nonatomic, strong) NSData                            *scannedPortrait;
+@property (nonatomic, strong) KYCImageBuffer                    *scannedDocFront;
+@property (nonatomic, strong) KYCImageBuffer                    *scannedDocBack;
+@property (nonatomic, strong) KYCImageBuffer                    *scannedPortrait;
 
 /**
  Common method to get KYCManager singletone.
@@ -36,6 +36,7 @@
 // GeneralSettings
 #define KEY_FACIAL_RECOGNITION      @"KycPreferenceKeyFacalRecognition"
 #define KEY_MAX_PICTURE_WIDTH       @"MaxPictureWidth"
+#define KEY_IMAGE_SIZE_BUDGET       @"ImageSizeBudget"
 #define KEY_JSON_WEB_TOKEN          @"JsonWebTokenV2"
 #define KEY_API_KEY                 @"ApiKeyV2"
 
@@ -84,6 +85,7 @@ static KYCManager *sInstance = nil;
              
              // GeneralSettings
              KEY_MAX_PICTURE_WIDTH        : [NSNumber numberWithInt:1024],
+             KEY_IMAGE_SIZE_BUDGET        : [NSNumber numberWithInt:300],
              KEY_FACIAL_RECOGNITION       : [NSNumber numberWithBool:YES],
          }];
         
@@ -98,6 +100,13 @@ static KYCManager *sInstance = nil;
                                  target:self
                             selectorGet:@selector(facialRecognition)
                             selectorSet:@selector(setFacialRecognition:)],
+                [IdCloudOption number:TRANSLATE(@"STRING_KYC_OPTION_IMAGE_SIZE_BUDGET_CAP")
+                          description:TRANSLATE(@"STRING_KYC_OPTION_IMAGE_SIZE_BUDGET_DES")
+                              section:IdCloudOptionSectionGeneral
+                               target:self
+                          selectorGet:@selector(imageSizeBudget)
+                          selectorSet:@selector(setImageSizeBudget:)
+                             minValue:0 maxValue:2000],
             ],
             
             // Version
@@ -167,6 +176,14 @@ static KYCManager *sInstance = nil;
     return [[NSUserDefaults standardUserDefaults] boolForKey:KEY_FACIAL_RECOGNITION];
 }
 
+- (void)setImageSizeBudget:(NSInteger)imageSizeBudget {
+    [[NSUserDefaults standardUserDefaults] setInteger:imageSizeBudget forKey:KEY_IMAGE_SIZE_BUDGET];
+}
+
+- (NSInteger)imageSizeBudget {
+    return [[NSUserDefaults standardUserDefaults] integerForKey:KEY_IMAGE_SIZE_BUDGET];
+}
+
 // MARK: - Public API
 
 - (void)displayQRcodeScannerForInit {
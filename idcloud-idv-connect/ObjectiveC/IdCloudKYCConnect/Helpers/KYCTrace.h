@@ -0,0 +1,191 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+@class KYCTraceSpan;
+
+// Span categories used across the application.
+#define kTraceCategoryCapture   @"capture"
+#define kTraceCategoryImage     @"image"
+#define kTraceCategoryNetwork   @"network"
+
+/**
+ Receiver of trace spans. Called on the thread which began or ended the span.
+ */
+@protocol KYCTraceSink <NSObject>
+
+/**
+ Span was ended. Duration and arguments are final.
+
+ @param span Finished span.
+ */
+- (void)traceSpanEnded:(KYCTraceSpan *)span;
+
+@optional
+
+/**
+ Span was started.
+
+ @param span Running span. Only name, category, identifier and start time are valid.
+ */
+- (void)traceSpanBegan:(KYCTraceSpan *)span;
+
+@end
+
+/**
+ Single measured interval of the verification flow. Span can be ended on different thread than it was started.
+ */
+@interface KYCTraceSpan : NSObject
+
+@property (nonatomic, copy, readonly)   NSString                        *name;
+@property (nonatomic, copy, readonly)   NSString                        *category;
+@property (nonatomic, assign, readonly) uint64_t                        identifier;
+@property (nonatomic, assign, readonly) uint64_t                        threadId;
+
+/**
+ Start and end in nanoseconds of system uptime. End is {@code 0} until the span is ended.
+ */
+@property (nonatomic, assign, readonly) uint64_t                        startTime;
+@property (nonatomic, assign, readonly) uint64_t                        endTime;
+
+/**
+ Additional values like poll count or data size. Exported together with the span.
+ */
+@property (nonatomic, copy, readonly)   NSDictionary<NSString *, id>    *arguments;
+
+/**
+ Attach additional value to the span.
+
+ @param value Value. Should be {@code NSString} or {@code NSNumber}.
+ @param key Argument name.
+ */
+- (void)setArgument:(id)value forKey:(NSString *)key;
+
+/**
+ End the span and pass it to all sinks. Any further call is ignored.
+ */
+- (void)end;
+
+@end
+
+/**
+ Lightweight tracing of the verification flow.
+
+ While tracing is disabled {@code beginSpanWithName:category:} returns {@code nil}, so all other calls on the span are
+ messages to {@code nil}. With {@code CFG_IDCLOUD_TRACE} turned off the check is resolved at compile time.
+ */
+@interface KYCTrace : NSObject
+
+/**
+ Turns tracing on or off. Spans which are already running are still delivered.
+ */
++ (void)setEnabled:(BOOL)enabled;
++ (BOOL)isEnabled;
+
+/**
+ Register sink receiving spans.
+
+ @param sink Sink. It's retained until removed.
+ */
++ (void)addSink:(id<KYCTraceSink>)sink;
+
+/**
+ Unregister sink.
+
+ @param sink Previously added sink.
+ */
++ (void)removeSink:(id<KYCTraceSink>)sink;
+
+/**
+ Starts a new span.
+
+ @param name Name of the measured step. E.g. {@code upload}.
+ @param category Group of related steps. E.g. {@code network}.
+
+ @return Running span or {@code nil} if tracing is disabled.
+ */
++ (KYCTraceSpan *)beginSpanWithName:(NSString *)name category:(NSString *)category;
+
+@end
+
+/**
+ Forwards spans as os_signpost intervals, so they are visible in Instruments next to system activity.
+ Signposts are available since iOS 12. Sink does nothing on older systems.
+ */
+@interface KYCTraceSignpostSink : NSObject <KYCTraceSink>
+
+/**
+ Creates a new {@code KYCTraceSignpostSink} instance.
+
+ @param subsystem Log subsystem. Usually bundle identifier.
+
+ @return Instance of {@code KYCTraceSignpostSink}.
+ */
++ (instancetype)sinkWithSubsystem:(NSString *)subsystem;
+
+@end
+
+/**
+ Keeps the last finished spans in memory and exports them in Chrome trace format, which can be opened
+ in {@code chrome://tracing} or Perfetto UI.
+ */
+@interface KYCTraceRecorder : NSObject <KYCTraceSink>
+
+/**
+ Common method to get KYCTraceRecorder singletone.
+ 
+ @return Instance of KYCTraceRecorder class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Release singletone together with all recorded spans.
+ */
++ (void)end;
+
+/**
+ Default export location. {@code kyc-trace.json} in application documents.
+ */
++ (NSURL *)defaultURL;
+
+/**
+ Recorded spans in Chrome trace JSON format.
+ 
+ @return JSON data.
+ */
+- (NSData *)chromeTraceData;
+
+/**
+ Writes recorded spans in Chrome trace JSON format.
+ 
+ @param url Destination file.
+ @param error Error if write failed.
+ 
+ @return {@code True} if file was written.
+ */
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error;
+
+/**
+ Drop all recorded spans.
+ */
+- (void)reset;
+
+@end
@@ -21,6 +21,11 @@
  */
 
 #import "AppDelegate.h"
+#import "KYCSubmissionQueue.h"
+#import "KYCTrace.h"
+#import "KYCCommunication.h"
+#import "KYCLoopbackTransport.h"
+#import "KYCLoopbackChecks.h"
 
 @interface AppDelegate()
 
@@ -41,6 +46,30 @@
     // Load proper VC based on SDK state.
     [KYCManager.sharedInstance updateRootViewController];
     
+    // Spans are recorded only when tracing is compiled in.
+    if (CFG_IDCLOUD_TRACE) {
+        [KYCTrace addSink:[KYCTraceSignpostSink sinkWithSubsystem:[NSBundle mainBundle].bundleIdentifier]];
+        [KYCTrace addSink:[KYCTraceRecorder sharedInstance]];
+        [KYCTrace setEnabled:YES];
+    }
+    
+    // Verification backend is emulated in process. Must be set before any pending verification is resumed.
+    if (CFG_IDCLOUD_LOOPBACK) {
+        [KYCCommunication setTransport:[KYCLoopbackTransport transportWithSeed:CFG_IDCLOUD_LOOPBACK_SEED]];
+        [KYCCommunication setBaseURL:[KYCLoopbackTransport baseURL]];
+    }
+    
+    // Checks use their own emulated backend and restore the transport once done.
+    // Stored verifications wait for them, so they are not sent to the emulated backend.
+    if (CFG_IDCLOUD_LOOPBACK_CHECKS) {
+        [KYCLoopbackChecks runWithCompletionHandler:^(NSArray<NSString *> *failures) {
+            NSCAssert(!failures.count, @"Loopback checks failed. %@", [failures componentsJoinedByString:@" "]);
+            [AppDelegate resumeSubmissionQueue];
+        }];
+    } else {
+        [AppDelegate resumeSubmissionQueue];
+    }
+    
     return YES;
 }
 
@@ -67,6 +96,15 @@
 
 // MARK: - Private Helpers
 
+/**
+ Picks up verifications stored before the application was terminated.
+ */
++ (void)resumeSubmissionQueue {
+    if (CFG_IDCLOUD_SUBMISSION_QUEUE) {
+        [[KYCSubmissionQueue sharedInstance] resume];
+    }
+}
+
 #define kWindowBlurViewTag 326598
 
 /**
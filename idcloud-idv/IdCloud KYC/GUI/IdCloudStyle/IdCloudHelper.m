@@ -79,12 +79,4 @@ Please make sure to review our IdCloud documentation, including security guideli
     }
 }
 
-+ (NSData *)imageFromBase64:(NSString *)base64 {
-    if (base64 && base64.length) {
-        return [[NSData alloc] initWithBase64EncodedString:base64 options:0];
-    } else {
-        return nil;
-    }
-}
-
 @end
@@ -57,6 +57,13 @@
     [IdCloudHelper animateView:_buttonNext inParent:self.view withDelay:kZeroDelay];
 }
 
+- (void)viewDidAppear:(BOOL)animated {
+    [super viewDidAppear:animated];
+    
+    // Document scanner is next. Initialize capture SDK while user reads the tutorial.
+    [[KYCManager sharedInstance] warmUpDocumentCapture];
+}
+
 - (void)viewDidLayoutSubviews {
     [super viewDidLayoutSubviews];
     
@@ -22,6 +22,9 @@
 
 #import "KYCFaceIdScannerViewController.h"
 #import "KYCScannerNotification.h"
+#import "KYCImageScaler.h"
+#import "KYCTrace.h"
+#import <MobileCoreServices/MobileCoreServices.h>
 
 #define kImageOverlay_Red           @"KYC_Overlay_Red"
 #define kImageOverlay_Orange        @"KYC_Overlay_Orange"
@@ -29,6 +32,15 @@
 #define kImageOverlay_GreenLight    @"KYC_Overlay_GreenLight"
 #define kImageOverlay_Gray          @"KYC_Overlay_Gray"
 
+// Lossy portrait quality. Face matching is not sensitive to mild compression artifacts.
+#define kPortraitQuality            .9f
+
+// Space around detected face kept in the cropped portrait relative to face size.
+#define kPortraitCropMargin         .5f
+
+// Uniform type identifier of HEIC. There is no system constant for it before iOS 14.
+#define kPortraitTypeHeic           @"public.heic"
+
 @interface KYCFaceIdScannerViewController () <FaceCaptureViewDelegate>
 
 @property (nonatomic, weak)     IBOutlet FaceCaptureView    *captureView;
@@ -38,9 +50,14 @@
 @property (nonatomic, weak)     IBOutlet IdCloudButton      *buttonRetry;
 @property (nonatomic, assign)   NSInteger                   lastLivenessAction;
 @property (nonatomic, assign)   CGRect                      lastLivenessRect;
+@property (nonatomic, assign)   NSInteger                   portraitRequest;
 @property (nonatomic, weak)     IBOutlet UILabel            *labelLiveness;
 @property (nonatomic, weak)     IBOutlet UIProgressView     *progressLiveness;
 @property (nonatomic, strong)   KYCScannerNotification      *kycNotification;
+@property (nonatomic, strong)   KYCTraceSpan                *captureSpan;
+// Time from appearance until first camera frame and until face is detected.
+@property (nonatomic, strong)   KYCTraceSpan                *firstFrameSpan;
+@property (nonatomic, strong)   KYCTraceSpan                *firstDetectionSpan;
 
 @end
 
@@ -70,6 +87,9 @@
 - (void)viewDidAppear:(BOOL)animated {
     [super viewDidAppear:animated];
     
+    self.firstFrameSpan     = [KYCTrace beginSpanWithName:@"timeToFirstFrame" category:kTraceCategoryCapture];
+    self.firstDetectionSpan = [KYCTrace beginSpanWithName:@"timeToFirstDetection" category:kTraceCategoryCapture];
+    
     // Make sure, that SDK is properly initialized.
     [[KYCManager sharedInstance] initializeFaceIdLicense:^(BOOL success, NSError *error) {
         if (success) {
@@ -160,10 +180,49 @@
     [_captureView setLivenessThreshold:manager.faceLivenessThreshold];
     [_captureView startCapture];
     
+    [_captureSpan end];
+    self.captureSpan = [KYCTrace beginSpanWithName:@"faceCapture" category:kTraceCategoryCapture];
+    
     _captureView.hidden = NO;
     _imageResult.image  = nil;
 }
 
+- (void)encodePortrait:(UIImage *)image faceRect:(CGRect)faceRect completion:(KYCImageScalerCompletion)completion {
+    KYCManager  *manager    = [KYCManager sharedInstance];
+    NSString    *type       = (__bridge NSString *)kUTTypeJPEG;
+    switch (manager.portraitEncoding) {
+        case PortraitEncodingPng:
+            type = (__bridge NSString *)kUTTypePNG;
+            break;
+        case PortraitEncodingHeic:
+            // Older devices can't encode HEIC. Stay with JPEG there.
+            if ([KYCImageScaler isTypeSupported:kPortraitTypeHeic]) {
+                type = kPortraitTypeHeic;
+            }
+            break;
+        default:
+            break;
+    }
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+#if CFG_IDCLOUD_PORTRAIT_CROP
+        KYCTraceSpan *cropSpan = [KYCTrace beginSpanWithName:@"portraitCrop" category:kTraceCategoryImage];
+        UIImage *portrait = [KYCImageScaler cropImage:image toRect:faceRect margin:kPortraitCropMargin];
+        [cropSpan end];
+#else
+        UIImage *portrait = image;
+#endif
+        KYCTraceSpan *encodeSpan = [KYCTrace beginSpanWithName:@"portraitEncode" category:kTraceCategoryImage];
+        NSData *data = [KYCImageScaler encodeImage:portrait type:type maxWidth:.0 quality:kPortraitQuality];
+        [encodeSpan setArgument:type forKey:@"type"];
+        [encodeSpan setArgument:@(data.length) forKey:@"bytes"];
+        [encodeSpan end];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(data);
+        });
+    });
+}
+
 - (void)scheduleNotificationHide {
     [self performSelector:@selector(notificationHide) withObject:nil afterDelay:3.f];
     
@@ -181,20 +240,30 @@
 // MARK: - FaceCaptureViewDelegate
 
 - (void)onFaceVerificationSuccess:(UIImage *)image yaw:(float)yaw pitch:(float)pitch rect:(CGRect)boundingRect {
-    
-    // Store image.
-    KYCManager *manager = [KYCManager sharedInstance];
-    [manager setScannedPortrait:UIImagePNGRepresentation(image)];
+    [_captureSpan end];
     
     _imageResult.image          = image;
-    _buttonOk.hidden            = NO;
     _buttonRetry.hidden         = NO;
     _captureView.hidden         = YES;
     
     [self livenessMeterVisible:NO];
+    
+    // Portrait is encoded on background. Continue is possible only once it's stored.
+    NSInteger request = ++_portraitRequest;
+    [self encodePortrait:image faceRect:boundingRect completion:^(NSData *data) {
+        // Retry was pressed meanwhile. Result belongs to the old capture.
+        if (request != self.portraitRequest) {
+            return;
+        }
+        
+        [[KYCManager sharedInstance] setScannedPortrait:[KYCImageBuffer bufferWithData:data]];
+        self.buttonOk.hidden = !data;
+    }];
 }
 
 - (void)onFaceVerificationFailed:(NSError *)error {
+    [_captureSpan setArgument:error.localizedDescription forKey:@"error"];
+    [_captureSpan end];
     [_kycNotification displayErrorIfExists:error];
     [self livenessMeterVisible:NO];
 
@@ -204,9 +273,16 @@
 
 - (void)onFaceCaptureInfo:(FaceCaptureInfo)info {
     
+    [_firstFrameSpan end];
+    self.firstFrameSpan = nil;
+    
     _progressLiveness.progress = 1.f - (CGFloat)info.mLivenessScore / 100.f;
     
     BOOL detected = !CGRectEqualToRect(info.mBoundingRect, CGRectZero);
+    if (detected) {
+        [_firstDetectionSpan end];
+        self.firstDetectionSpan = nil;
+    }
     if (!CGRectEqualToRect(info.mBoundingRect, _lastLivenessRect)) {
         [self livenessMeterVisible:detected];
         _imageOverlay.image = [UIImage imageNamed:detected ? kImageOverlay_Green : kImageOverlay_Gray];
@@ -283,6 +359,9 @@
 }
 
 - (IBAction)onButtonPressedRetry:(IdCloudButton *)sender {
+    // Drop portrait which might still be encoding.
+    _portraitRequest++;
+    
     // Hide action buttons.
     _buttonOk.hidden    = YES;
     _buttonRetry.hidden = YES;
@@ -53,6 +53,9 @@
     _imageTutorialHand.alpha = .0f;
     
     _imageBad.delegate = self;
+    
+    // Face scanner is next. Make sure it does not have to wait for license.
+    [[KYCManager sharedInstance] warmUpFaceCapture];
 }
 
 - (void)viewDidLayoutSubviews {
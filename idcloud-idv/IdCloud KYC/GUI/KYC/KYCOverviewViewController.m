@@ -22,6 +22,11 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 #import "KYCOverviewViewController.h"
 #import "KYCCommunication.h"
+#import "KYCSubmissionQueue.h"
+#import "KYCTrace.h"
+
+// Fallback size of thumbnails in points. Used before the layout is finished.
+#define kThumbnailMinSize 128.f
 
 @interface KYCOverviewViewController()
 
@@ -37,12 +42,18 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (weak, nonatomic) IBOutlet UIStackView    *stackResults;
 
 @property (assign, nonatomic) BOOL                  finished;
+@property (strong, nonatomic) KYCSession            *session;
 @end
 
 @implementation KYCOverviewViewController
 
 // MARK: - Life Cycle
 
+- (void)dealloc {
+    // Nobody is waiting for the result any more. Stop uploads and polls.
+    [_session cancel];
+}
+
 - (void)viewWillAppear:(BOOL)animated {
     [super viewWillAppear:animated];
  
@@ -58,6 +69,13 @@ Please make sure to review our IdCloud documentation, including security guideli
     
     // This property switch button behaviour.
     _finished = NO;
+    
+    // Result of verification submitted from the queue after the original request was released.
+    // Unregistration is done in base class.
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(onSubmissionFinished:)
+                                                 name:kNotificationSubmissionFinished
+                                               object:nil];
 }
 
 // MARK: - MainViewController
@@ -80,8 +98,11 @@ Please make sure to review our IdCloud documentation, including security guideli
     } completion:nil];
 }
 
-- (void)loadOrHideImage:(NSData *)image view:(UIImageView *)view {
-    [view setImage:[UIImage imageWithData:image]];
+- (void)loadOrHideImage:(KYCImageBuffer *)image view:(UIImageView *)view {
+    // Decode only what is displayed. Full resolution image stays encoded for upload.
+    CGSize  size            = view.bounds.size;
+    CGFloat maxPixelSize    = MAX(MAX(size.width, size.height), kThumbnailMinSize) * [UIScreen mainScreen].scale;
+    [view setImage:[image thumbnailWithMaxPixelSize:maxPixelSize]];
     [view setHidden:!image];
 }
 
@@ -132,7 +153,7 @@ Please make sure to review our IdCloud documentation, including security guideli
     _imageStatus.tintColor  = [UIColor greenColor];
 
     // Update extracted portrait.
-    [self loadOrHideImage:response.document.portrait view:self.imagePortraitExtracted];
+    [self loadOrHideImage:[KYCImageBuffer bufferWithData:response.document.portrait] view:self.imagePortraitExtracted];
     
     // Animate result part.
     [self showOrHideResultArea:YES animated:YES];
@@ -161,6 +182,32 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 }
 
+- (void)displayResponse:(KYCResponse *)response error:(NSString *)error {
+    // Hide loading indicator and unblock UI.
+    [self loadingIndicatorHide];
+    
+    // Timeline of the whole flow is exported after each verification.
+    if ([KYCTrace isEnabled]) {
+        [[KYCTraceRecorder sharedInstance] writeToURL:[KYCTraceRecorder defaultURL] error:nil];
+    }
+    
+    if (response) {
+        [self displayResult:response];
+    } else {
+        // No response? Display error if we have one, otherwise some generict err message.
+        if (!error) {
+            [self displayError:@"Failed to get valid response from server." response:nil];
+        } else {
+            [self displayError:error.description response:nil];
+        }
+    }
+}
+
+- (void)onSubmissionFinished:(NSNotification *)notification {
+    [self displayResponse:notification.userInfo[kNotificationSubmissionFinishedResponse]
+                    error:notification.userInfo[kNotificationSubmissionFinishedError]];
+}
+
 - (void)appendResultString:(NSMutableString *)retCaption
                   revValue:(NSMutableString *)retValue
                    caption:(NSString *)caption
@@ -203,29 +250,27 @@ Please make sure to review our IdCloud documentation, including security guideli
     
     // Send data to server and wait for response.
     __weak __typeof(self) weakSelf = self;
-    [KYCCommunication verifyDocumentFront:manager.scannedDocFront
-                             documentBack:manager.scannedDocBack
-                                   selfie:manager.scannedPortrait
-                        completionHandler:^(KYCResponse *response, NSString *error) {
+    KYCResponseHandler handler = ^(KYCResponse *response, NSString *error) {
         // UI is already gone.
         if (!weakSelf) {
             return;
         }
         
-        // Hide loading indicator and unblock UI.
-        [weakSelf loadingIndicatorHide];
-        
-        if (response) {
-            [weakSelf displayResult:response];
-        } else {
-            // No response? Display error if we have one, otherwise some generict err message.
-            if (!error) {
-                [weakSelf displayError:@"Failed to get valid response from server." response:nil];
-            } else {
-                [weakSelf displayError:error.description response:nil];
-            }
-        }
-    }];
+        [weakSelf displayResponse:response error:error];
+    };
+    
+    if (CFG_IDCLOUD_SUBMISSION_QUEUE) {
+        // Data are stored first, so the verification is not lost without connection.
+        [[KYCSubmissionQueue sharedInstance] submitDocumentFront:manager.scannedDocFront.data
+                                                    documentBack:manager.scannedDocBack.data
+                                                          selfie:manager.scannedPortrait.data
+                                               completionHandler:handler];
+    } else {
+        self.session = [KYCCommunication verifyDocumentFront:manager.scannedDocFront.data
+                                                documentBack:manager.scannedDocBack.data
+                                                      selfie:manager.scannedPortrait.data
+                                           completionHandler:handler];
+    }
 }
 
 @end
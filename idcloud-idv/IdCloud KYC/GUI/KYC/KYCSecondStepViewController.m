@@ -42,6 +42,22 @@
     [IdCloudHelper animateView:_buttonPassport inParent:self.view withDelay:&delay];
 }
 
+- (void)viewDidAppear:(BOOL)animated {
+    [super viewDidAppear:animated];
+    
+    // Both document types continue to the document scanner. Start capture SDK initialization already.
+    [[KYCManager sharedInstance] warmUpDocumentCapture];
+}
+
+- (void)viewWillDisappear:(BOOL)animated {
+    [super viewWillDisappear:animated];
+    
+    // User left the document flow. Do not keep capture SDK running for a scanner which will not be shown.
+    if (self.isMovingFromParentViewController || self.navigationController.isBeingDismissed) {
+        [[KYCManager sharedInstance] releaseWarmDocumentCapture];
+    }
+}
+
 - (void)prepareForSegue:(UIStoryboardSegue *)segue sender:(id)sender {
     // Remove all current images.
     KYCManager *manager = [KYCManager sharedInstance];
@@ -26,6 +26,20 @@
 
 @property (nonatomic, assign) KYCDocumentType type;
 
+/**
+ Number of layout constraints installed in the scanner view hierarchy. Debug helper to verify, that rotations and step
+ changes do not add new constraints.
+ */
+@property (nonatomic, assign, readonly) NSUInteger activeConstraintCount;
+
+/**
+ Creates capture view from the scanner storyboard scene, so it's set up exactly like the one scanner loads itself.
+ Used to initialize document capture SDK before the scanner is displayed.
+ 
+ @return Capture view without superview. SDK is not initialized yet.
+ */
++ (CaptureInterface *)instantiateCaptureView;
+
 - (void)startScanning;
 
 @end
@@ -23,12 +23,40 @@
 #import "KYCScannerViewController.h"
 #import "KYCScannerStepView.h"
 #import "KYCScannerStepDetailView.h"
+#import "KYCTrace.h"
+#import "KYCViewIndex.h"
+#import "KYCCaptureReplay.h"
 
 #define kZonePercentage     .8f
 #define kZoneAspect         1.4204
 #define kSegueFaceScanner   @"sequeScannerFaceId"
 #define kSegueKYCOverview   @"sequeKYCOverview"
 
+// Displayed warning is unknown. Next update is always applied.
+#define kWarningInvalid     -2
+// No warning is displayed.
+#define kWarningNone        -1
+
+/**
+ Presentation of single detection warning.
+ */
+typedef struct {
+    DetectionWarning                warning;
+    __unsafe_unretained NSString    *icon;
+    __unsafe_unretained NSString    *caption;
+} KYCWarningPresentation;
+
+// Ordered by priority. When more warnings are reported, the first one is displayed.
+static const KYCWarningPresentation kWarningPresentations[] = {
+    {Blur,              @"KYC_ScanOverlay_Focus",       @"STRING_KYC_DOC_SCAN_WARNING_BLUR"},
+    {LowLight,          @"KYC_ScanOverlay_Light",       @"STRING_KYC_DOC_SCAN_WARNING_LIGHT"},
+    {LowContrast,       @"KYC_ScanOverlay_Contrast",    @"STRING_KYC_DOC_SCAN_WARNING_CONTRAST"},
+    {Hotspot,           @"KYC_ScanOverlay_Hotspot",     @"STRING_KYC_DOC_SCAN_WARNING_HOTSPOT"},
+    {FocusInProgress,   @"KYC_ScanOverlay_Focus",       @"STRING_KYC_DOC_SCAN_WARNING_FOCUSING"},
+    {FitDocument,       @"KYC_ScanOverlay_Fit",         @"STRING_KYC_DOC_SCAN_WARNING_FIT"}
+};
+#define kWarningPresentationCount (sizeof(kWarningPresentations) / sizeof(kWarningPresentations[0]))
+
 @interface AVCameraDetectedLineView : UIView
 
 @end
@@ -37,10 +65,12 @@
 
 @end
 
-@interface KYCScannerViewController() <CaptureDelegate, DetectionWarningDelegate, KYCScannerStepProtocol>
+@interface KYCScannerViewController() <CaptureDelegate, DetectionWarningDelegate, KYCScannerStepProtocol, KYCCaptureReplayTarget>
 
 @property (nonatomic, strong)   IBOutlet CaptureInterface   *captureView;
 @property (nonatomic, strong)   UIView                      *captureZoneOverlay;
+// Subviews of capture view by class. Built once per capture view.
+@property (nonatomic, strong)   KYCViewIndex                *captureViewIndex;
 
 @property (nonatomic, weak)     IBOutlet UIButton           *buttonBack;
 @property (nonatomic, weak)     IBOutlet UIView             *viewTutorialSteps;
@@ -65,6 +95,37 @@
 @property (nonatomic, assign) DetectionWarning              lastWarning;
 // Custom notification bar for face scanning.
 @property (nonatomic, strong) KYCScannerNotification        *kycNotification;
+// Time from camera start until both sides are captured.
+@property (nonatomic, strong) KYCTraceSpan                  *captureSpan;
+// Applies latest SDK warning once per display refresh.
+@property (nonatomic, strong) CADisplayLink                 *warningDisplayLink;
+// Latest warning reported by SDK and not yet applied. Guarded by self.
+@property (nonatomic, assign) DetectionWarning              pendingWarning;
+@property (nonatomic, assign) BOOL                          warningPending;
+// Icons and captions of kWarningPresentations. Resolved only once.
+@property (nonatomic, strong) NSArray<UIImage *>            *warningIcons;
+@property (nonatomic, strong) NSArray<NSString *>           *warningCaptions;
+// Index of kWarningPresentations currently on screen and notification type used to display it.
+@property (nonatomic, assign) NSInteger                     displayedWarning;
+@property (nonatomic, assign) NotifyType                    displayedType;
+// Number of SDK warning callbacks against number of actual UI updates.
+@property (nonatomic, assign) NSInteger                     warningCallbackCount;
+@property (nonatomic, assign) NSInteger                     warningUpdateCount;
+// Layout of both orientations. Created once, only one of them is active.
+@property (nonatomic, strong) NSArray<NSLayoutConstraint *> *portraitConstraints;
+@property (nonatomic, strong) NSArray<NSLayoutConstraint *> *landscapeConstraints;
+@property (nonatomic, strong) NSArray<NSLayoutConstraint *> *activeConstraints;
+// Constraints depending on safe area. Only their constant is updated.
+@property (nonatomic, strong) NSLayoutConstraint            *portraitStepsHeight;
+@property (nonatomic, strong) NSLayoutConstraint            *portraitStackTop;
+@property (nonatomic, strong) NSLayoutConstraint            *landscapeStepsWidth;
+@property (nonatomic, strong) NSLayoutConstraint            *landscapeStackLeft;
+// Records live session or replays the recorded one instead of camera.
+@property (nonatomic, strong) KYCCaptureRecorder            *captureRecorder;
+@property (nonatomic, strong) KYCCaptureReplay              *captureReplay;
+// Time from scanning start until first SDK callback and until document is in view. Guarded by self.
+@property (nonatomic, strong) KYCTraceSpan                  *firstFrameSpan;
+@property (nonatomic, strong) KYCTraceSpan                  *firstDetectionSpan;
 
 
 @end
@@ -73,6 +134,17 @@
 
 // MARK: - Life Cycle
 
++ (CaptureInterface *)instantiateCaptureView {
+    UIStoryboard                *storyboard = [UIStoryboard storyboardWithName:@"KYCDoc" bundle:nil];
+    KYCScannerViewController    *scanner    = [storyboard instantiateViewControllerWithIdentifier:@"KYCScannerViewController"];
+    [scanner loadViewIfNeeded];
+    
+    // Controller is not used any more. View is taken over by whoever asked for it.
+    CaptureInterface *retValue = scanner.captureView;
+    [retValue removeFromSuperview];
+    return retValue;
+}
+
 - (void)viewDidLoad {
     [super viewDidLoad];
     
@@ -88,6 +160,23 @@
         [self.view addSubview:_kycNotification];
     }
     
+    // Warning assets are looked up for each camera frame. Resolve them just once.
+    NSMutableArray *icons       = [NSMutableArray new];
+    NSMutableArray *captions    = [NSMutableArray new];
+    for (NSUInteger index = 0; index < kWarningPresentationCount; index++) {
+        [icons      addObject:[UIImage imageNamed:kWarningPresentations[index].icon]];
+        [captions   addObject:TRANSLATE(kWarningPresentations[index].caption)];
+    }
+    self.warningIcons       = icons;
+    self.warningCaptions    = captions;
+    self.displayedWarning   = kWarningInvalid;
+    
+    // Capture view initialized in advance on previous screens replaces the storyboard one.
+    CaptureInterface *warmCapture = [KYCManager sharedInstance].warmDocumentCapture;
+    if (warmCapture && _captureView) {
+        [self replaceCaptureView:warmCapture];
+    }
+    
     // Camera view is automatically turned off when you put application to background.
     // We want to re-start camera once app become active again.
     [[NSNotificationCenter defaultCenter] addObserver:self
@@ -115,10 +204,15 @@
     // BW Photo copy
     [_captureView setBWPhotocopyQAEnabled:manager.bwPhotoCopyQA];
     
+    // SDK views are searched several times during step transitions. Traverse them just once.
+    if (!_captureViewIndex) {
+        self.captureViewIndex = [KYCViewIndex indexWithRootView:_captureView];
+    }
+    
     // Remove strange overlay which does not work with rest of the UI.
     // TODO: Make sure, that 640x480 is always just that overlay and it works on all devices.
     if (!_reused) {
-        for (UIImageView *loopImage in [KYCManager getClassesFromSubviews:[UIImageView class] parent:_captureView]) {
+        for (UIImageView *loopImage in [_captureViewIndex viewsOfClass:[UIImageView class]]) {
             // Check size and subview position to make sure we have the right one.
             if (CGSizeEqualToSize(loopImage.image.size, CGSizeMake(640, 480)) && loopImage.superview.superview == _captureView) {
                 [loopImage setAlpha:.0f];
@@ -134,7 +228,7 @@
         
         // With setDetectionZoneSpace SDK display some broken lines.
         if (!_reused) {
-            [KYCManager removeClassFromSubviews:[AVCameraDetectedLineView class] parent:_captureView];
+            [_captureViewIndex removeViewsOfClass:[AVCameraDetectedLineView class]];
         }
     }
     
@@ -153,15 +247,34 @@
     // Stard SDK.
     [self startScanning];
     
+    // SDK reports warnings for every camera frame. UI follows display refresh instead.
+    [_warningDisplayLink invalidate];
+    self.warningDisplayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(onDisplayRefresh:)];
+    [_warningDisplayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    
     // Make sure, that next time we will not update same UI part as now.
     self.reused = YES;
 }
 
+- (void)viewWillDisappear:(BOOL)animated {
+    [super viewWillDisappear:animated];
+    
+    // Display link retains the controller. Stop it together with the camera.
+    [_warningDisplayLink invalidate];
+    self.warningDisplayLink = nil;
+    
+    [_captureReplay cancel];
+    self.captureReplay = nil;
+}
+
 - (void)viewDidDisappear:(BOOL)animated {
     [super viewDidDisappear:animated];
     
     // Release capture view ONLY if this VC will be destroyed otherwise we might still need it.
     if (!self.presentedViewController) {
+        [_captureViewIndex invalidate];
+        self.captureViewIndex = nil;
+        [[KYCManager sharedInstance] cancelDocumentCaptureInitialization:_captureView];
         [self.captureView releaseMemory];
         self.captureView = nil;
     }
@@ -172,7 +285,7 @@
     
     BOOL portrait = [KYCManager sharedInstance].cameraOrientation;
     
-    // Visual is different in both orientations. We can't solve that with static constraints.
+    // Visual is different in both orientations. Constraints for both are created once and swapped.
     CGFloat offset = .0f;
     if (portrait) {
         offset = [self layoutForPortrait];
@@ -210,8 +323,54 @@
 // MARK: - Public API
 
 - (void)startScanning {
+    // Scanning is restarted when app returns from background. Measure only the last attempt.
+    [_captureSpan end];
+    self.captureSpan = [KYCTrace beginSpanWithName:@"documentCapture" category:kTraceCategoryCapture];
+    @synchronized (self) {
+        self.warningCallbackCount   = 0;
+        self.warningUpdateCount     = 0;
+    }
+    
+    // Recorded session replaces camera. Fall back to camera if there is no valid recording.
+    if (CFG_IDCLOUD_CAPTURE_REPLAY.length) {
+        [_captureReplay cancel];
+        self.captureReplay = [KYCCaptureReplay replayWithURL:[[KYCCaptureReplay recordingsURL] URLByAppendingPathComponent:CFG_IDCLOUD_CAPTURE_REPLAY]];
+        if (_captureReplay) {
+            _captureReplay.speed = CFG_IDCLOUD_CAPTURE_REPLAY_SPEED;
+            [_captureReplay startWithTarget:self completion:^(KYCCaptureReplay *replay, NSError *error) {
+                // Replay is a regression check of the scanner flow. Make the failure impossible to miss.
+                NSCAssert(!error, @"Capture replay failed. %@", error.localizedDescription);
+            }];
+            return;
+        }
+    }
+    
+    if (CFG_IDCLOUD_CAPTURE_RECORD) {
+        NSDateFormatter     *formatter  = [NSDateFormatter new];
+        formatter.dateFormat            = @"yyyyMMdd-HHmmss";
+        KYCCaptureRecorder  *recorder   = [KYCCaptureRecorder recorderWithURL:[[KYCCaptureReplay recordingsURL] URLByAppendingPathComponent:[formatter stringFromDate:[NSDate date]]]];
+        // Warnings are recorded from SDK thread.
+        @synchronized (self) {
+            self.captureRecorder = recorder;
+        }
+    }
+    
+    // Perceived startup latency. Warmed capture view skips SDK init.
+    BOOL            warm                = _captureView == [KYCManager sharedInstance].warmDocumentCapture;
+    KYCTraceSpan    *firstFrameSpan     = [KYCTrace beginSpanWithName:@"timeToFirstFrame" category:kTraceCategoryCapture];
+    KYCTraceSpan    *firstDetectionSpan = [KYCTrace beginSpanWithName:@"timeToFirstDetection" category:kTraceCategoryCapture];
+    [firstFrameSpan setArgument:@(warm) forKey:@"warm"];
+    [firstDetectionSpan setArgument:@(warm) forKey:@"warm"];
+    @synchronized (self) {
+        self.firstFrameSpan     = firstFrameSpan;
+        self.firstDetectionSpan = firstDetectionSpan;
+    }
+    
     // Init the SDK with success completion
-    [_captureView initWithCompletion:^(BOOL isCompleted, int errorCode) {
+    KYCTraceSpan *initSpan = [KYCTrace beginSpanWithName:@"sdkInit" category:kTraceCategoryCapture];
+    [initSpan setArgument:@(warm) forKey:@"warm"];
+    [[KYCManager sharedInstance] initializeDocumentCapture:_captureView completion:^(BOOL isCompleted, int errorCode) {
+        [initSpan end];
         if(isCompleted) {
             [self.captureView start:self];
         } else {
@@ -232,25 +391,90 @@
 
 // MARK: - Private Helpers
 
+/**
+ Puts capture view in place of the storyboard one. Layout of the storyboard view, including views aligned to it,
+ is moved to the new view.
+ 
+ @param captureView New capture view. Must not be in any view hierarchy.
+ */
+- (void)replaceCaptureView:(CaptureInterface *)captureView {
+    UIView                               *oldView     = _captureView;
+    NSMutableArray<NSLayoutConstraint *> *constraints = [NSMutableArray new];
+    
+    // Constraints to other views are held by common ancestor, size constraints by the view itself. Installed ones are
+    // all active. Constraints within the old view belong to its own subviews and are dropped with it.
+    for (UIView *loopView = oldView; loopView; loopView = loopView.superview) {
+        for (NSLayoutConstraint *loopConstraint in loopView.constraints) {
+            if ([loopConstraint class] != [NSLayoutConstraint class] ||
+                (loopConstraint.firstItem != oldView && loopConstraint.secondItem != oldView) ||
+                [KYCScannerViewController item:loopConstraint.firstItem isInsideView:oldView] ||
+                [KYCScannerViewController item:loopConstraint.secondItem isInsideView:oldView]) {
+                continue;
+            }
+            
+            id                  firstItem   = loopConstraint.firstItem == oldView ? captureView : loopConstraint.firstItem;
+            id                  secondItem  = loopConstraint.secondItem == oldView ? captureView : loopConstraint.secondItem;
+            NSLayoutConstraint  *constraint = [NSLayoutConstraint constraintWithItem:firstItem
+                                                                           attribute:loopConstraint.firstAttribute
+                                                                           relatedBy:loopConstraint.relation
+                                                                              toItem:secondItem
+                                                                           attribute:loopConstraint.secondAttribute
+                                                                          multiplier:loopConstraint.multiplier
+                                                                            constant:loopConstraint.constant];
+            constraint.priority     = loopConstraint.priority;
+            constraint.identifier   = loopConstraint.identifier;
+            [constraints addObject:constraint];
+        }
+    }
+    
+    captureView.frame                                       = oldView.frame;
+    captureView.translatesAutoresizingMaskIntoConstraints   = oldView.translatesAutoresizingMaskIntoConstraints;
+    [oldView.superview insertSubview:captureView aboveSubview:oldView];
+    [oldView removeFromSuperview];
+    [NSLayoutConstraint activateConstraints:constraints];
+    
+    self.captureView = captureView;
+}
+
+/**
+ Whether layout item is part of the view content.
+ 
+ @param item View or layout guide. Optional.
+ @param view Container view.
+ 
+ @return {@code True} if item is subview of the view or guide owned by the view or its subview.
+ */
++ (BOOL)item:(id)item isInsideView:(UIView *)view {
+    if ([item isKindOfClass:[UILayoutGuide class]]) {
+        return [((UILayoutGuide *)item).owningView isDescendantOfView:view];
+    }
+    
+    return [item isKindOfClass:[UIView class]] && item != view && [item isDescendantOfView:view];
+}
+
 - (CGFloat)layoutForLandscape {
     CGFloat safeAreaHeight = self.view.safeAreaInsets.left ? 32.f : .0f;
     
-    _viewTutorialSteps.translatesAutoresizingMaskIntoConstraints = NO;
-    [_viewTutorialSteps.widthAnchor constraintEqualToConstant:96.f + safeAreaHeight].active = YES;
-    [_viewTutorialSteps.topAnchor constraintEqualToAnchor:self.view.topAnchor].active = YES;
-    [_viewTutorialSteps.leftAnchor constraintEqualToAnchor:self.view.leftAnchor].active = YES;
-    [_viewTutorialSteps.bottomAnchor constraintEqualToAnchor:self.view.bottomAnchor].active = YES;
+    if (!_landscapeConstraints) {
+        self.landscapeStepsWidth    = [_viewTutorialSteps.widthAnchor constraintEqualToConstant:96.f + safeAreaHeight];
+        self.landscapeStackLeft     = [_stackTutorialSteps.leftAnchor constraintEqualToAnchor:_viewTutorialSteps.leftAnchor constant:safeAreaHeight];
+        self.landscapeConstraints   = @[_landscapeStepsWidth,
+                                        [_viewTutorialSteps.topAnchor constraintEqualToAnchor:self.view.topAnchor],
+                                        [_viewTutorialSteps.leftAnchor constraintEqualToAnchor:self.view.leftAnchor],
+                                        [_viewTutorialSteps.bottomAnchor constraintEqualToAnchor:self.view.bottomAnchor],
+                                        _landscapeStackLeft,
+                                        [_stackTutorialSteps.rightAnchor constraintEqualToAnchor:_viewTutorialSteps.rightAnchor],
+                                        [_stackTutorialSteps.topAnchor constraintEqualToAnchor:_buttonBack.bottomAnchor],
+                                        [_stackTutorialSteps.bottomAnchor constraintEqualToAnchor:_viewTutorialSteps.bottomAnchor],
+                                        [_buttonShutter.centerYAnchor constraintEqualToAnchor:self.view.centerYAnchor],
+                                        [_buttonShutter.rightAnchor constraintEqualToAnchor:self.view.rightAnchor constant:-24.f]];
+    }
     
-    _stackTutorialSteps.axis = UILayoutConstraintAxisVertical;
-    _stackTutorialSteps.translatesAutoresizingMaskIntoConstraints = NO;
-    [_stackTutorialSteps.leftAnchor constraintEqualToAnchor:_viewTutorialSteps.leftAnchor constant:safeAreaHeight].active = YES;
-    [_stackTutorialSteps.rightAnchor constraintEqualToAnchor:_viewTutorialSteps.rightAnchor].active = YES;
-    [_stackTutorialSteps.topAnchor constraintEqualToAnchor:_buttonBack.bottomAnchor].active = YES;
-    [_stackTutorialSteps.bottomAnchor constraintEqualToAnchor:_viewTutorialSteps.bottomAnchor].active = YES;
+    // Safe area is not known during first layout passes.
+    _landscapeStepsWidth.constant   = 96.f + safeAreaHeight;
+    _landscapeStackLeft.constant    = safeAreaHeight;
     
-    _buttonShutter.translatesAutoresizingMaskIntoConstraints = NO;
-    [_buttonShutter.centerYAnchor constraintEqualToAnchor:self.view.centerYAnchor].active = YES;
-    [_buttonShutter.rightAnchor constraintEqualToAnchor:self.view.rightAnchor constant:-24.f].active = YES;
+    [self activateConstraints:_landscapeConstraints axis:UILayoutConstraintAxisVertical];
     
     return safeAreaHeight + 96.f;
 }
@@ -258,29 +482,66 @@
 - (CGFloat)layoutForPortrait {
     CGFloat safeAreaHeight = self.view.safeAreaInsets.top ? 32.f : .0f;
     
-    _viewTutorialSteps.translatesAutoresizingMaskIntoConstraints = NO;
-    [_viewTutorialSteps.heightAnchor constraintEqualToConstant:96.f + safeAreaHeight].active = YES;
-    [_viewTutorialSteps.topAnchor constraintEqualToAnchor:self.view.topAnchor].active = YES;
-    [_viewTutorialSteps.leftAnchor constraintEqualToAnchor:self.view.leftAnchor].active = YES;
-    [_viewTutorialSteps.rightAnchor constraintEqualToAnchor:self.view.rightAnchor].active = YES;
+    if (!_portraitConstraints) {
+        self.portraitStepsHeight    = [_viewTutorialSteps.heightAnchor constraintEqualToConstant:96.f + safeAreaHeight];
+        self.portraitStackTop       = [_stackTutorialSteps.topAnchor constraintEqualToAnchor:_viewTutorialSteps.topAnchor constant:safeAreaHeight];
+        self.portraitConstraints    = @[_portraitStepsHeight,
+                                        [_viewTutorialSteps.topAnchor constraintEqualToAnchor:self.view.topAnchor],
+                                        [_viewTutorialSteps.leftAnchor constraintEqualToAnchor:self.view.leftAnchor],
+                                        [_viewTutorialSteps.rightAnchor constraintEqualToAnchor:self.view.rightAnchor],
+                                        [_stackTutorialSteps.leftAnchor constraintEqualToAnchor:_buttonBack.rightAnchor],
+                                        [_stackTutorialSteps.rightAnchor constraintEqualToAnchor:_viewTutorialSteps.rightAnchor constant:-16.f],
+                                        _portraitStackTop,
+                                        [_stackTutorialSteps.bottomAnchor constraintEqualToAnchor:_viewTutorialSteps.bottomAnchor],
+                                        [_buttonShutter.centerXAnchor constraintEqualToAnchor:self.view.centerXAnchor],
+                                        [_buttonShutter.bottomAnchor constraintEqualToAnchor:self.view.bottomAnchor constant:-16.f]];
+    }
     
-    _stackTutorialSteps.axis = UILayoutConstraintAxisHorizontal;
-    _stackTutorialSteps.translatesAutoresizingMaskIntoConstraints = NO;
-    [_stackTutorialSteps.leftAnchor constraintEqualToAnchor:_buttonBack.rightAnchor].active = YES;
-    [_stackTutorialSteps.rightAnchor constraintEqualToAnchor:_viewTutorialSteps.rightAnchor constant:-16.f].active = YES;
-    [_stackTutorialSteps.topAnchor constraintEqualToAnchor:_viewTutorialSteps.topAnchor constant:safeAreaHeight].active = YES;
-    [_stackTutorialSteps.bottomAnchor constraintEqualToAnchor:_viewTutorialSteps.bottomAnchor].active = YES;
+    // Safe area is not known during first layout passes.
+    _portraitStepsHeight.constant   = 96.f + safeAreaHeight;
+    _portraitStackTop.constant      = safeAreaHeight;
     
-    _buttonShutter.translatesAutoresizingMaskIntoConstraints = NO;
-    [_buttonShutter.centerXAnchor constraintEqualToAnchor:self.view.centerXAnchor].active = YES;
-    [_buttonShutter.bottomAnchor constraintEqualToAnchor:self.view.bottomAnchor constant:-16.f].active = YES;
+    [self activateConstraints:_portraitConstraints axis:UILayoutConstraintAxisHorizontal];
     
     return safeAreaHeight + 96.f;
 }
 
+- (void)activateConstraints:(NSArray<NSLayoutConstraint *> *)constraints axis:(UILayoutConstraintAxis)axis {
+    // Layout pass with unchanged orientation does not touch constraints at all.
+    if (_activeConstraints == constraints) {
+        return;
+    }
+    
+    if (_activeConstraints) {
+        [NSLayoutConstraint deactivateConstraints:_activeConstraints];
+    }
+    
+    _viewTutorialSteps.translatesAutoresizingMaskIntoConstraints    = NO;
+    _stackTutorialSteps.translatesAutoresizingMaskIntoConstraints   = NO;
+    _buttonShutter.translatesAutoresizingMaskIntoConstraints        = NO;
+    _stackTutorialSteps.axis                                        = axis;
+    [NSLayoutConstraint activateConstraints:constraints];
+    self.activeConstraints = constraints;
+}
+
+- (NSUInteger)activeConstraintCount {
+    return [self constraintCountOfView:self.view];
+}
+
+- (NSUInteger)constraintCountOfView:(UIView *)view {
+    NSUInteger retValue = view.constraints.count;
+    
+    for (UIView *loopView in view.subviews) {
+        retValue += [self constraintCountOfView:loopView];
+    }
+    
+    return retValue;
+}
+
 - (void)loadScannerConfig {
     // No overlay at the beginning.
-    _imageOverlayStatus.image = nil;
+    _imageOverlayStatus.image   = nil;
+    _displayedWarning           = kWarningInvalid;
     
     if (_type == KYCDocumentTypeIdCard) {
         [self.captureView setCaptureDocuments:[Document getDocumentModeICAO]];
@@ -324,10 +585,10 @@
         _blurOverlay.alpha              = .0f;
         
         // Make all basic views transparent
-        for (UIView *loopView in [KYCManager getClassesFromSubviews:[UIView class] parent:self.captureView]) {
+        for (UIView *loopView in [_captureViewIndex viewsOfClass:[UIView class]]) {
             loopView.backgroundColor = [UIColor clearColor];
         }
-        for (AVCameraPreviewView *loopPreivew in [KYCManager getClassesFromSubviews:[AVCameraPreviewView class] parent:self.captureView]) {
+        for (AVCameraPreviewView *loopPreivew in [_captureViewIndex viewsOfClass:[AVCameraPreviewView class]]) {
             // Insert it just above capture view.
             [loopPreivew addSubview:_blurOverlay];
             // iPhone X and bigger does not have full screen preview. At least make background black.
@@ -383,7 +644,7 @@
     _disableCustomOverlays = disable;
     
     // Disable SDK auto behaviour.
-    for (AVCameraDetectedLineView *loopLine in [KYCManager getClassesFromSubviews:[AVCameraDetectedLineView class] parent:self.captureView]) {
+    for (AVCameraDetectedLineView *loopLine in [_captureViewIndex viewsOfClass:[AVCameraDetectedLineView class]]) {
         [loopLine setAlpha:disable ? .0f : 1.f];
     }
     if (disable) {
@@ -399,6 +660,7 @@
     
     if (disable) {
         [_kycNotification hide];
+        _displayedWarning = kWarningInvalid;
     }
     
     // Cancel all current animations
@@ -415,42 +677,31 @@
 }
 
 - (void)updateNotification:(BOOL)includingOverlay type:(NotifyType)type {
-    NSString *iconName;
-    NSString *caption;
-    
-    if ((_lastWarning & FitDocument) == FitDocument) {
-        iconName    = @"KYC_ScanOverlay_Fit";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_FIT");
-    }
-    if ((_lastWarning & FocusInProgress) == FocusInProgress) {
-        iconName    = @"KYC_ScanOverlay_Focus";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_FOCUSING");
-    }
-    if ((_lastWarning & Hotspot) == Hotspot) {
-        iconName    = @"KYC_ScanOverlay_Hotspot";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_HOTSPOT");
-    }
-    if ((_lastWarning & LowContrast) == LowContrast) {
-        iconName    = @"KYC_ScanOverlay_Contrast";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_CONTRAST");
-    }
-    if ((_lastWarning & LowLight) == LowLight) {
-        iconName    = @"KYC_ScanOverlay_Light";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_LIGHT");
-    }
-    if ((_lastWarning & Blur) == Blur) {
-        iconName    = @"KYC_ScanOverlay_Focus";
-        caption     = TRANSLATE(@"STRING_KYC_DOC_SCAN_WARNING_BLUR");
+    NSInteger warning = kWarningNone;
+    for (NSUInteger index = 0; index < kWarningPresentationCount; index++) {
+        if ((_lastWarning & kWarningPresentations[index].warning) == kWarningPresentations[index].warning) {
+            warning = index;
+            break;
+        }
     }
     
-    if (iconName && includingOverlay) {
-        _imageOverlayStatus.image = [UIImage imageNamed:iconName];
+    // Redisplaying the same notification would only restart its animation.
+    if (warning == _displayedWarning && type == _displayedType) {
+        return;
     }
-    if (caption) {
-        [_kycNotification display:caption type:type];
-    } else {
+    self.displayedWarning   = warning;
+    self.displayedType      = type;
+    self.warningUpdateCount++;
+    
+    if (warning == kWarningNone) {
         [_kycNotification hide];
+        return;
     }
+    
+    if (includingOverlay) {
+        _imageOverlayStatus.image = _warningIcons[warning];
+    }
+    [_kycNotification display:_warningCaptions[warning] type:type];
 }
 
 - (void)fixBeggierScreenPreview:(BOOL)portrait {
@@ -495,7 +746,7 @@
         [self activeStep:_step + 1];
     } else {
         [self setDisableCustomOverlays:NO];
-        [self detectionWarnings:_lastWarning];
+        [self updateNotification:YES type:NotifyTypeInfo];
     }
 }
 
@@ -506,16 +757,29 @@
 }
 
 - (void) onSuccess:(CaptureResult *) captureResult {
+    // Recording is written only for complete scan. Failure just means there is nothing to replay.
+    [_captureRecorder finishWithSide1:captureResult.side1 side2:captureResult.side2 error:nil];
+
+    [self onReplaySuccess:captureResult.side1 side:captureResult.side2];
+}
+
+- (void)onReplaySuccess:(NSData *)side1 side:(NSData *)side2 {
     // Hide overlays.
     [self setDisableCustomOverlays:YES];
     
     // Stop capture view before dismiss to prevent any strange autorotation.
     [self.captureView stop];
     
-    // Store scanned documents
+    [_captureSpan setArgument:@(side1.length + side2.length) forKey:@"bytes"];
+    [_captureSpan setArgument:@(_warningCallbackCount) forKey:@"warningCallbacks"];
+    [_captureSpan setArgument:@(_warningUpdateCount) forKey:@"warningUpdates"];
+    [_captureSpan setArgument:@(self.activeConstraintCount) forKey:@"layoutConstraints"];
+    [_captureSpan end];
+    
+    // Store scanned documents. Buffer copies capture output only if it's mutable.
     KYCManager *manager = [KYCManager sharedInstance];
-    [manager setScannedDocFront:[captureResult.side1 copy]];
-    [manager setScannedDocBack:[captureResult.side2 copy]];
+    [manager setScannedDocFront:[KYCImageBuffer bufferWithData:side1]];
+    [manager setScannedDocBack:[KYCImageBuffer bufferWithData:side2]];
     
     
     if ([KYCManager sharedInstance].facialRecognition) {
@@ -531,6 +795,7 @@
         if (screen == OutResultOK) {
             [self activeStep:self.step + 1];
         }
+        [self.captureRecorder recordScreen:screen step:self.step];
         
         // Disable overlay on any other than capturng screen.
         if (screen != InDetecting && screen != OutResultKO) {
@@ -547,26 +812,51 @@
 // MARK: - DetectionWarningDelegate
 
 - (void)detectionWarnings:(DetectionWarning)warnings {
-    dispatch_async(dispatch_get_main_queue(), ^{
-        
-        // Preserve current warning so we can use that in swithing steps.
-        self.lastWarning = warnings;
+    // Called for every camera frame. Keep only the latest value, display refresh will pick it up.
+    @synchronized (self) {
+        [_captureRecorder recordWarnings:warnings];
         
-        // This way we know that camera is fully loaded and working.
-        // We do not want to display first step while sdk is loading.
-        if (self.initialStep) {
-            [self activeStep:0];
-            self.initialStep = NO;
-            return;
+        // First processed camera frame and first frame with document in view.
+        [_firstFrameSpan end];
+        _firstFrameSpan = nil;
+        if ((warnings & FitDocument) != FitDocument) {
+            [_firstDetectionSpan end];
+            _firstDetectionSpan = nil;
         }
         
-        // Ignore any notification from SDK while explaining current step.
-        if (self.disableCustomOverlays) {
+        _pendingWarning = warnings;
+        _warningPending = YES;
+        _warningCallbackCount++;
+    }
+}
+
+- (void)onDisplayRefresh:(CADisplayLink *)displayLink {
+    DetectionWarning warnings;
+    @synchronized (self) {
+        if (!_warningPending) {
             return;
         }
-        
-        [self updateNotification:YES type:NotifyTypeInfo];
-    });
+        _warningPending = NO;
+        warnings        = _pendingWarning;
+    }
+    
+    // Preserve current warning so we can use that in swithing steps.
+    self.lastWarning = warnings;
+    
+    // This way we know that camera is fully loaded and working.
+    // We do not want to display first step while sdk is loading.
+    if (self.initialStep) {
+        [self activeStep:0];
+        self.initialStep = NO;
+        return;
+    }
+    
+    // Ignore any notification from SDK while explaining current step.
+    if (self.disableCustomOverlays) {
+        return;
+    }
+    
+    [self updateNotification:YES type:NotifyTypeInfo];
 }
 
 // MARK: - User Interface
@@ -0,0 +1,219 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#include "KYCCodec.h"
+
+#include <string.h>
+
+// Value of padding character in the decoding table.
+#define kPadding        0xFE
+
+// Bits which are set only for characters outside of the alphabet in the decoding table.
+#define kNoValueMask    0xC0
+
+// Byte patterns used to search eight bytes at once.
+#define kOnes           0x0101010101010101ull
+#define kHighBits       0x8080808080808080ull
+
+static const uint8_t kEncodingTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Value of each character. Base64 alphabet maps to 0-63. Characters outside of the alphabet are 0xFF.
+static const uint8_t kDecodingTable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// MARK: - Base64 Encoding
+
+size_t KYCCodecBase64EncodedLength(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+size_t KYCCodecBase64Encode(const uint8_t *input, size_t length, uint8_t *output) {
+    uint8_t *start = output;
+    
+    // Whole triplets.
+    size_t index = 0;
+    for (; index + 3 <= length; index += 3) {
+        uint32_t triplet = (uint32_t)input[index] << 16 | (uint32_t)input[index + 1] << 8 | input[index + 2];
+        *output++ = kEncodingTable[triplet >> 18];
+        *output++ = kEncodingTable[triplet >> 12 & 0x3F];
+        *output++ = kEncodingTable[triplet >> 6 & 0x3F];
+        *output++ = kEncodingTable[triplet & 0x3F];
+    }
+    
+    // Rest with padding.
+    if (index < length) {
+        uint32_t triplet = (uint32_t)input[index] << 16;
+        if (index + 1 < length) {
+            triplet |= (uint32_t)input[index + 1] << 8;
+        }
+        *output++ = kEncodingTable[triplet >> 18];
+        *output++ = kEncodingTable[triplet >> 12 & 0x3F];
+        *output++ = index + 1 < length ? kEncodingTable[triplet >> 6 & 0x3F] : '=';
+        *output++ = '=';
+    }
+    
+    return (size_t)(output - start);
+}
+
+// MARK: - Base64 Decoding
+
+void KYCCodecBase64DecoderInit(KYCCodecBase64Decoder *decoder) {
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+size_t KYCCodecBase64DecoderMaxOutput(size_t length) {
+    // Up to 3 sextets can be left from the previous update.
+    return (length + 3) / 4 * 3;
+}
+
+/**
+ Writes bytes of incomplete quadruplet. Two sextets make one byte, three sextets make two bytes.
+ */
+static size_t KYCCodecBase64DecoderFlush(KYCCodecBase64Decoder *decoder, uint8_t *output) {
+    size_t retValue = 0;
+    if (decoder->count == 2) {
+        output[retValue++] = (uint8_t)(decoder->bits >> 4);
+    } else if (decoder->count == 3) {
+        output[retValue++] = (uint8_t)(decoder->bits >> 10);
+        output[retValue++] = (uint8_t)(decoder->bits >> 2);
+    } else if (decoder->count == 1) {
+        decoder->failed = true;
+    }
+    
+    decoder->bits   = 0;
+    decoder->count  = 0;
+    return retValue;
+}
+
+size_t KYCCodecBase64DecoderUpdate(KYCCodecBase64Decoder *decoder, const uint8_t *input, size_t length, uint8_t *output) {
+    if (decoder->failed) {
+        return 0;
+    }
+    
+    uint8_t     *start  = output;
+    uint32_t    bits    = decoder->bits;
+    unsigned    count   = decoder->count;
+    for (size_t index = 0; index < length;) {
+        // Whole quadruplets without noise are decoded at once. That's almost all of the text.
+        if (!count && !decoder->padded && index + 4 <= length) {
+            uint32_t first  = kDecodingTable[input[index]];
+            uint32_t second = kDecodingTable[input[index + 1]];
+            uint32_t third  = kDecodingTable[input[index + 2]];
+            uint32_t fourth = kDecodingTable[input[index + 3]];
+            if (!((first | second | third | fourth) & kNoValueMask)) {
+                uint32_t triplet = first << 18 | second << 12 | third << 6 | fourth;
+                *output++   = (uint8_t)(triplet >> 16);
+                *output++   = (uint8_t)(triplet >> 8);
+                *output++   = (uint8_t)triplet;
+                index       += 4;
+                continue;
+            }
+        }
+        
+        uint8_t value = kDecodingTable[input[index++]];
+        if (value < 64 && !decoder->padded) {
+            bits = bits << 6 | value;
+            if (++count == 4) {
+                *output++   = (uint8_t)(bits >> 16);
+                *output++   = (uint8_t)(bits >> 8);
+                *output++   = (uint8_t)bits;
+                bits        = 0;
+                count       = 0;
+            }
+        } else if (value == kPadding) {
+            // First padding character completes the quadruplet. Only the rest of padding can follow.
+            if (!decoder->padded) {
+                decoder->bits       = bits;
+                decoder->count      = count;
+                decoder->padding    = count ? 4 - count : 0;
+                decoder->padded     = true;
+                output              += KYCCodecBase64DecoderFlush(decoder, output);
+                bits                = 0;
+                count               = 0;
+            }
+            if (!decoder->padding) {
+                decoder->failed = true;
+            } else {
+                decoder->padding--;
+            }
+        } else if (value < 64) {
+            // Data after padding.
+            decoder->failed = true;
+        }
+        
+        if (decoder->failed) {
+            return 0;
+        }
+    }
+    
+    decoder->bits   = bits;
+    decoder->count  = count;
+    return (size_t)(output - start);
+}
+
+size_t KYCCodecBase64DecoderFinish(KYCCodecBase64Decoder *decoder, uint8_t *output) {
+    if (decoder->failed) {
+        return 0;
+    }
+    
+    return KYCCodecBase64DecoderFlush(decoder, output);
+}
+
+// MARK: - JSON Scanning
+
+/**
+ Returns non-zero if any byte of the word is zero.
+ */
+static inline uint64_t KYCCodecHasZeroByte(uint64_t word) {
+    return (word - kOnes) & ~word & kHighBits;
+}
+
+size_t KYCCodecJSONStringRun(const uint8_t *bytes, size_t length) {
+    // Eight bytes per round. Checking both characters in one pass keeps escaped base64 linear.
+    size_t index = 0;
+    for (; index + 8 <= length; index += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + index, sizeof(word));
+        if (KYCCodecHasZeroByte(word ^ ('"' * kOnes)) || KYCCodecHasZeroByte(word ^ ('\\' * kOnes))) {
+            break;
+        }
+    }
+    for (; index < length && bytes[index] != '"' && bytes[index] != '\\'; index++);
+    
+    return index;
+}
@@ -21,13 +21,101 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCSession.h"
+#import "KYCTransport.h"
 
 @interface KYCCommunication : NSObject
 
-+ (void)verifyDocumentFront:(NSData *)docFront
-               documentBack:(NSData *)docBack
-                     selfie:(NSData *)selfie
-          completionHandler:(KYCResponseHandler)handler;
+/**
+ Replaces transport used for all verification requests. E.g. with {@code KYCLoopbackTransport} for offline runs.
+ 
+ @param transport Transport or {@code nil} to restore the default one.
+ */
++ (void)setTransport:(id<KYCTransport>)transport;
+
+/**
+ Transport used for verification requests.
+ 
+ @return Custom transport if set, otherwise the default one.
+ */
++ (id<KYCTransport>)transport;
+
+/**
+ Replaces verification backend URL for new verifications.
+ 
+ @param baseURL Backend URL or {@code nil} to restore {@code CFG_IDCLOUD_BASE_URL}.
+ */
++ (void)setBaseURL:(NSString *)baseURL;
+
+/**
+ Verification backend URL used for new verifications.
+ 
+ @return Custom URL if set, otherwise {@code CFG_IDCLOUD_BASE_URL}.
+ */
++ (NSString *)baseURL;
+
+/**
+ Starts the verification.
+ 
+ @param docFront Front side of the document.
+ @param docBack Back side of the document. Optional.
+ @param selfie Selfie image. Optional.
+ @param handler Called once on main thread with the result or error. Not called if the verification is cancelled.
+ 
+ @return Session of the verification. Can be used to cancel it.
+ */
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler;
+
+/**
+ Same as above, but failure to deliver the verification is reported separately.
+ 
+ @param uploadFailedHandler Called instead of {@code handler} if the verification request did not reach the server
+ or the server did not answer in time, so the caller can keep the data and try again later. Optional.
+ */
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler
+                uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler;
+
+/**
+ Same as above. Caller also learns the server side identifier of the verification as soon as the server accepts it,
+ so it can wait for the result again with {@code resumeVerification:completionHandler:uploadFailedHandler:} instead
+ of sending the same images again.
+ 
+ @param uploadedHandler Called once on background thread with server side identifier of the verification. Optional.
+ */
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler
+                    uploadedHandler:(KYCUploadedHandler)uploadedHandler
+                uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler;
+
+/**
+ Waits for the result of verification already accepted by the server, e.g. after application restart.
+ 
+ @param sessionId Server side identifier of the verification.
+ @param handler Called once on main thread with the result or error. Not called if the verification is cancelled.
+ @param uploadFailedHandler Called instead of {@code handler} if the server could not be reached or did not answer
+ in time. Optional.
+ 
+ @return Session of the verification. Can be used to cancel it.
+ */
++ (KYCSession *)resumeVerification:(NSString *)sessionId
+                 completionHandler:(KYCResponseHandler)handler
+               uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler;
+
+/**
+ Whether the error was raised before any part of the request could reach the server.
+ 
+ @param error Communication error.
+ 
+ @return {@code True} if it's safe to send the request again, else {@code false}.
+ */
++ (BOOL)isUnsentRequestError:(NSError *)error;
 
 
 @end
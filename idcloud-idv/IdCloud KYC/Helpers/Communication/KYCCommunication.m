@@ -21,46 +21,139 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 #import "KYCCommunication.h"
 #import "KYCSession.h"
+#import "KYCStreamedBody.h"
+#import "KYCURLSessionManager.h"
+#import "KYCResultStream.h"
+#import "KYCJSONReader.h"
+
+// Key path of the verification result within the status reply.
+#define kResultKeyPath @"state.result"
+
+static id<KYCTransport> sTransport  = nil;
+static NSString         *sBaseURL   = nil;
 
 @implementation KYCCommunication
 
 // MARK: - Public API
 
-+ (void)verifyDocumentFront:(NSData *)docFront
-               documentBack:(NSData *)docBack
-                     selfie:(NSData *)selfie
-          completionHandler:(KYCResponseHandler)handler {
++ (void)setTransport:(id<KYCTransport>)transport {
+    @synchronized (self) {
+        sTransport = transport;
+    }
+}
+
++ (id<KYCTransport>)transport {
+    @synchronized (self) {
+        if (sTransport) {
+            return sTransport;
+        }
+    }
+    
+    return [KYCURLSessionManager sharedInstance];
+}
+
++ (void)setBaseURL:(NSString *)baseURL {
+    @synchronized (self) {
+        sBaseURL = [baseURL copy];
+    }
+}
+
++ (NSString *)baseURL {
+    @synchronized (self) {
+        return sBaseURL ?: CFG_IDCLOUD_BASE_URL;
+    }
+}
+
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler {
+    return [KYCCommunication verifyDocumentFront:docFront
+                             documentBack:docBack
+                                   selfie:selfie
+                        completionHandler:handler
+                      uploadFailedHandler:nil];
+}
+
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler
+                uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler {
+    return [KYCCommunication verifyDocumentFront:docFront
+                             documentBack:docBack
+                                   selfie:selfie
+                        completionHandler:handler
+                          uploadedHandler:nil
+                      uploadFailedHandler:uploadFailedHandler];
+}
+
++ (KYCSession *)verifyDocumentFront:(NSData *)docFront
+                       documentBack:(NSData *)docBack
+                             selfie:(NSData *)selfie
+                  completionHandler:(KYCResponseHandler)handler
+                    uploadedHandler:(KYCUploadedHandler)uploadedHandler
+                uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler {
     assert(handler);
     
     // Prepare session.
-    KYCSession *session = [KYCSession createWithURL:CFG_IDCLOUD_BASE_URL andHandler:handler];
+    KYCSession *session         = [KYCSession createWithURL:[KYCCommunication baseURL] andHandler:handler];
+    session.uploadFailedHandler = uploadFailedHandler;
     
-    // Build request.
+    // Build request. With streamed upload images are base64 encoded later as part of the upload.
+    KYCTraceSpan *buildSpan = [session beginTraceSpan:@"buildBody" category:kTraceCategoryNetwork];
     NSError *error;
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:session.url];
     request.HTTPMethod  = @"POST";
-    request.HTTPBody    = [KYCCommunication createVerificationJSON:docFront
+    NSDictionary *json  = [KYCCommunication createVerificationJSON:docFront
                                                       documentBack:docBack
-                                                            selfie:selfie
-                                                             error:&error];
+                                                            selfie:selfie];
+    
+    // Compress only if backend is known to accept it.
+    KYCStreamedBody *body   = [KYCStreamedBody bodyWithJSONObject:json error:&error];
+    body.compressed         = CFG_IDCLOUD_COMPRESSED_UPLOAD && [KYCURLSessionManager sharedInstance].gzipRequestSupported;
+    if (body.compressed) {
+        [request setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+    }
+    
+    if (CFG_IDCLOUD_STREAMED_UPLOAD) {
+        // Images are base64 encoded while the body is being uploaded.
+        request.HTTPBodyStream = body.inputStream;
+        if (!body.compressed) {
+            [request setValue:[NSString stringWithFormat:@"%llu", body.contentLength] forHTTPHeaderField:@"Content-Length"];
+        }
+    } else {
+        request.HTTPBody = body.serializedData;
+    }
+    [buildSpan setArgument:@(body.contentLength) forKey:@"bytes"];
+    [buildSpan end];
     
     // Failed to build verification JSON. No reason to continue.
     if (error) {
         [session handleError:error.localizedDescription];
-        return;
+        return session;
     }
     
     // Execute request.
-    [[[KYCCommunication createUrlSession] dataTaskWithRequest:request
-                                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+    KYCTraceSpan *uploadSpan = [session beginTraceSpan:@"upload" category:kTraceCategoryNetwork];
+    [[KYCCommunication transport] sendRequest:request
+                                      session:session
+                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [uploadSpan end];
+        
         // Something went wrong during communication. Return error from SDK.
         if (error) {
-            [session handleError:error.localizedDescription];
+            [session handleUploadError:error];
             return;
         }
         
-        // Parse server response and get session id.
-        NSDictionary    *res        = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
+        // Parse server response and get session id. Nothing else is needed, so stop reading right after it.
+        KYCJSONReader   *reader     = [KYCJSONReader readerWithBase64Paths:nil
+                                                              skippedPaths:nil
+                                                             memberHandler:^BOOL(NSDictionary *root, NSString *key) {
+            return ![key isEqualToString:@"id"];
+        }];
+        NSDictionary    *res        = [reader readData:data error:&error];
         NSString        *sessionId  = [res objectForKey:@"id"];
         
         // Failed to get valid operation session id.
@@ -71,93 +164,215 @@ Please make sure to review our IdCloud documentation, including security guideli
     
         // Pass getted session id to current session and continue.
         [session updateWithSessionId:sessionId];
-        dispatch_async(dispatch_get_main_queue(), ^{
-            [KYCCommunication performSelector:@selector(verifyDocumentSecondStep:) withObject:session afterDelay:CFG_IDCLOUD_RETRY_DELAY_SEC];
-        });
+        if (uploadedHandler) {
+            uploadedHandler(sessionId);
+        }
+        [KYCCommunication scheduleSecondStep:session response:response];
         
-    }] resume];
+    }];
+    
+    return session;
+}
+
++ (KYCSession *)resumeVerification:(NSString *)sessionId
+                 completionHandler:(KYCResponseHandler)handler
+               uploadFailedHandler:(KYCUploadFailedHandler)uploadFailedHandler {
+    assert(handler && sessionId);
+    
+    // Server already has the images. Only the polling part of the verification is repeated.
+    KYCSession *session         = [KYCSession createWithURL:[KYCCommunication baseURL] andHandler:handler];
+    session.uploadFailedHandler = uploadFailedHandler;
+    [session updateWithSessionId:sessionId];
+    [KYCCommunication verifyDocumentSecondStep:session];
+    
+    return session;
+}
+
++ (BOOL)isUnsentRequestError:(NSError *)error {
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    
+    switch (error.code) {
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorDNSLookupFailed:
+        case NSURLErrorNotConnectedToInternet:
+        case NSURLErrorSecureConnectionFailed:
+            return YES;
+        default:
+            return NO;
+    }
 }
 
 // MARK: - Private Helpers
 
 + (void)verifyDocumentSecondStep:(KYCSession *)session {
+    // Verification was cancelled while waiting for this attempt.
+    if (session.isCancelled) {
+        return;
+    }
+    
     // Build request.
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:session.urlWithSessionId];
     request.HTTPMethod = @"GET";
     
+    // Stream needs a real connection. Custom transports are always polled.
+    if (CFG_IDCLOUD_RESULT_STREAM && [KYCCommunication transport] == [KYCURLSessionManager sharedInstance]) {
+        [KYCCommunication verifyDocumentSecondStepStream:session request:request];
+        return;
+    }
+    
     // Execute request.
-    [[[KYCCommunication createUrlSession] dataTaskWithRequest:request
-                                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        NSDictionary    *res    = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
-        NSString        *status = res[@"status"];
+    KYCTraceSpan *pollSpan = [session beginTraceSpan:@"poll" category:kTraceCategoryNetwork];
+    [pollSpan setArgument:@(session.tryCount) forKey:@"attempt"];
+    [[KYCCommunication transport] sendRequest:request
+                                      session:session
+                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [pollSpan end];
+        
+        // Server state is unknown. Same as failed upload, the caller may try again later.
+        if (error) {
+            [session handleUploadError:error];
+            return;
+        }
+        
+        KYCTraceSpan    *parseSpan  = [session beginTraceSpan:@"parse" category:kTraceCategoryNetwork];
+        NSDictionary    *res        = [[KYCCommunication resultReader] readData:data error:&error];
+        [parseSpan setArgument:@(data.length) forKey:@"bytes"];
+        [parseSpan end];
         
         // Server operation is still running.
-        if ([status isEqualToString:@"Running"]) {
-            // Make sure we will not create infinite loop.
-            if (session.tryCount <= CFG_IDCLOUD_NUMBER_OF_RETRIES) {
-                session.tryCount++;
-                dispatch_async(dispatch_get_main_queue(), ^{
-                    [KYCCommunication performSelector:@selector(verifyDocumentSecondStep:) withObject:session afterDelay:CFG_IDCLOUD_RETRY_DELAY_SEC];
-                });
-            } else {
-                // Already pass number of retries. We can end here.
-                [session handleError:@"Failed to get server response in time."];
-            }
-        } else if ([status isEqualToString:@"Finished"]) {
-            // Server operation finished.
-            KYCResponse *response = [KYCResponse responseWithJSON:[[res objectForKey:@"state"] objectForKey:@"result"]];
-            if (response) {
-                [session handleResult:response];
-            } else {
-                [session handleError:@"Failed to parse server response."];
-            }
-        } else if ([status isEqualToString:@"Failure"]) {
-            // Server operation failed.
-            NSDictionary    *result     = res[@"state"][@"result"];
-            NSString        *message    = result[@"message"];
-            NSInteger       code        = [result[@"code"] integerValue];
-            
-            // Messages looks like "[5eb47d75-71f7-4b36-a273-8ddfe7e985bc] Internal service error". Strip down first ID part.
-            NSRange range = [message rangeOfString:@"] "];
-            if (range.length == 2) {
-                message = [message substringFromIndex:range.location + 2];
-            }
-            
-            // Return to handler.
-            [session handleError:[NSString stringWithFormat:@"Error Code: %ld, Error Message: %@", (long)code, message]];
+        if ([KYCCommunication handleState:res session:session]) {
+            [KYCCommunication scheduleSecondStep:session response:response];
+        }
+    }];
+}
+
++ (void)verifyDocumentSecondStepStream:(KYCSession *)session request:(NSURLRequest *)request {
+    // Keep connection open and let server push state changes. Never wait longer than session deadline.
+    NSTimeInterval timeout = MIN([session.deadline timeIntervalSinceNow], CFG_IDCLOUD_RESULT_STREAM_TIMEOUT_SEC);
+    
+    session.resultStream = [KYCResultStream streamWithRequest:request
+                                                      timeout:MAX(timeout, 1.)
+                                                      handler:^BOOL(NSDictionary *state, NSURLResponse *response) {
+        return [KYCCommunication handleState:state session:session];
+    } completion:^(BOOL finished, NSError *error) {
+        session.resultStream = nil;
+        
+        // Server closed the stream without final state or does not support streaming at all.
+        // Fall back to regular delay before next attempt.
+        if (!finished) {
+            [KYCCommunication scheduleSecondStep:session response:nil];
+        }
+    }];
+}
+
++ (KYCJSONReader *)resultReader {
+    // Images are decoded straight from the reply. Running state does not carry anything else worth reading.
+    return [KYCJSONReader readerWithBase64Paths:[KYCResponse imageKeyPathsWithPrefix:kResultKeyPath]
+                                   skippedPaths:[KYCResponse droppedKeyPathsWithPrefix:kResultKeyPath]
+                                  memberHandler:^BOOL(NSDictionary *root, NSString *key) {
+        return ![root[@"status"] isEqual:@"Running"];
+    }];
+}
+
++ (BOOL)handleState:(NSDictionary *)res session:(KYCSession *)session {
+    NSString *status = res[@"status"];
+    
+    if ([status isEqualToString:@"Running"]) {
+        // Server operation is still running. Caller will decide how to wait for next state.
+        return YES;
+    } else if ([status isEqualToString:@"Finished"]) {
+        // Server operation finished.
+        KYCResponse *response = [KYCResponse responseWithJSON:[[res objectForKey:@"state"] objectForKey:@"result"]];
+        if (response) {
+            [session handleResult:response];
         } else {
-            // Unknown state. Not handled response type.
-            [session handleError:@"Unexpected server response."];
+            [session handleError:@"Failed to parse server response."];
+        }
+    } else if ([status isEqualToString:@"Failure"]) {
+        // Server operation failed.
+        NSDictionary    *result     = res[@"state"][@"result"];
+        NSString        *message    = result[@"message"];
+        NSInteger       code        = [result[@"code"] integerValue];
+        
+        // Messages looks like "[5eb47d75-71f7-4b36-a273-8ddfe7e985bc] Internal service error". Strip down first ID part.
+        NSRange range = [message rangeOfString:@"] "];
+        if (range.length == 2) {
+            message = [message substringFromIndex:range.location + 2];
         }
         
-    }] resume];
+        // Return to handler.
+        [session handleError:[NSString stringWithFormat:@"Error Code: %ld, Error Message: %@", (long)code, message]];
+    } else {
+        // Unknown state. Not handled response type.
+        [session handleError:@"Unexpected server response."];
+    }
+    
+    return NO;
 }
 
-+ (NSURLSession *)createUrlSession {
-    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
-    configuration.HTTPAdditionalHeaders = @{
-        @"Accept"           : @"application/json",
-        @"Content-Type"     : @"application/json",
-        @"Authorization"    : [NSString stringWithFormat:@"Bearer %@", [KYCManager sharedInstance].jsonWebToken],
-        @"X-API-KEY"        : [KYCManager sharedInstance].apiKey
-    };
-    return [NSURLSession sessionWithConfiguration:configuration];
++ (void)scheduleSecondStep:(KYCSession *)session response:(NSURLResponse *)response {
+    NSTimeInterval delay        = [session.pollStrategy delayForAttempt:session.tryCount
+                                                             serverHint:[KYCCommunication retryAfter:response]];
+    NSTimeInterval remaining    = [session.deadline timeIntervalSinceNow];
+    
+    // Make sure we will not create infinite loop.
+    if (remaining <= .0) {
+        [session handleTimeout];
+        return;
+    }
+    
+    // Last attempt is done right at the deadline.
+    delay = MIN(delay, remaining);
+    session.tryCount++;
+    
+    // Waiting is done off the main thread. UI is not involved until the final result.
+    // Session drops the attempt if it is cancelled in the meantime.
+    [session dispatchAfter:delay block:^{
+        [KYCCommunication verifyDocumentSecondStep:session];
+    }];
 }
 
-+ (NSData *)createVerificationJSON:(NSData *)docFront
-                      documentBack:(NSData *)docBack
-                            selfie:(NSData *)selfie
-                             error:(NSError **)error {
++ (NSTimeInterval)retryAfter:(NSURLResponse *)response {
+    if (![response isKindOfClass:[NSHTTPURLResponse class]]) {
+        return .0;
+    }
+    
+    NSString *value = ((NSHTTPURLResponse *)response).allHeaderFields[@"Retry-After"];
+    if (!value.length) {
+        return .0;
+    }
+    
+    // Retry-After is either number of seconds or HTTP date.
+    NSScanner   *scanner = [NSScanner scannerWithString:value];
+    double      seconds;
+    if ([scanner scanDouble:&seconds] && scanner.isAtEnd) {
+        return MAX(seconds, .0);
+    }
+    
+    NSDateFormatter *formatter  = [NSDateFormatter new];
+    formatter.locale            = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.dateFormat        = @"EEE, dd MMM yyyy HH:mm:ss zzz";
+    return MAX([[formatter dateFromString:value] timeIntervalSinceNow], .0);
+}
+
++ (NSDictionary *)createVerificationJSON:(NSData *)docFront
+                            documentBack:(NSData *)docBack
+                                  selfie:(NSData *)selfie {
+    // Images are kept as raw data. They are base64 encoded during serialization.
+    
     // Build document node with front and back side.
     NSMutableDictionary *document = [NSMutableDictionary new];
     [document setObject:@"SDK" forKey:@"captureMethod"];
     [document setObject:@"Residence_Permit" forKey:@"type"];
     [document setObject:@"TD1" forKey:@"size"];
     if (docFront) {
-        [document setObject:[docFront base64EncodedStringWithOptions:0] forKey:@"front"];
+        [document setObject:docFront forKey:@"front"];
     }
     if (docBack) {
-        [document setObject:[docBack base64EncodedStringWithOptions:0] forKey:@"back"];
+        [document setObject:docBack forKey:@"back"];
     }
         
     // Input is object containing document and optionaly face.
@@ -167,7 +382,7 @@ Please make sure to review our IdCloud documentation, including security guideli
     // Build selfie node.
     if (selfie) {
         NSMutableDictionary *face = [NSMutableDictionary new];
-        [face setObject:[selfie base64EncodedStringWithOptions:0] forKey:@"image"];
+        [face setObject:selfie forKey:@"image"];
         [input setObject:face forKey:@"face"];
     }
     
@@ -176,7 +391,7 @@ Please make sure to review our IdCloud documentation, including security guideli
     [json setObject:selfie ? @"Verify_Document_Face" : @"Verify_Document" forKey:@"name"];
     [json setObject:input forKey:@"input"];
     
-    return [NSJSONSerialization dataWithJSONObject:json options:0 error:error];
+    return json;
 }
 
 @end
@@ -0,0 +1,42 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import <Foundation/Foundation.h>
+
+typedef void (^KYCLoopbackChecksHandler)(NSArray<NSString *> *failures);
+
+/**
+ Self checks of the verification flow run against {@code KYCLoopbackTransport}.
+
+ Every check installs its own transport instance, so request counters are not shared with the application or other
+ checks. Checks run one after another. Transport and base URL used by the application are restored afterwards.
+ Application should not start any verification while the checks are running.
+ */
+@interface KYCLoopbackChecks : NSObject
+
+/**
+ Runs all checks.
+
+ @param handler Called on main thread once all checks are done. Contains description of each failed check.
+ */
++ (void)runWithCompletionHandler:(KYCLoopbackChecksHandler)handler;
+
+@end
@@ -0,0 +1,298 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCLoopbackChecks.h"
+#import "KYCLoopbackTransport.h"
+#import "KYCCommunication.h"
+#import "KYCVerificationEngine.h"
+#import "KYCSubmissionQueue.h"
+
+// Size of emulated images. Content does not matter to the emulated backend.
+#define kImageSize          (64 * 1024)
+
+// Round trip of the emulated backend used by the checks.
+#define kLatency            .1
+
+// Time needed by request handed over to the transport right before cancel to be counted.
+#define kHandoverTime       (2 * kLatency)
+
+// Time in which any leaked poll would be sent. Polls are never further apart than the retry delay.
+#define kSettleTime         (2 * CFG_IDCLOUD_RETRY_DELAY_SEC + 1.)
+
+// Load run of the verification engine.
+#define kLoadJobCount       120
+#define kLoadConcurrency    16
+#define kLoadGroupCount     4
+#define kLoadTimeout        CFG_IDCLOUD_VERIFICATION_DEADLINE_SEC
+
+// Server processing time of verification interrupted by emulated crash.
+#define kRecoveryProcessing 3.
+
+typedef void (^KYCLoopbackCheckHandler)(NSString *failure);
+typedef void (^KYCLoopbackCheck)(KYCLoopbackTransport *transport, KYCLoopbackCheckHandler handler);
+
+@interface KYCLoopbackChecks()
+
+@property (nonatomic, strong)   NSMutableArray<NSString *>          *names;
+@property (nonatomic, strong)   NSMutableArray<KYCLoopbackCheck>    *checks;
+@property (nonatomic, strong)   NSMutableArray<NSString *>          *failures;
+@property (nonatomic, strong)   id<KYCTransport>                    savedTransport;
+@property (nonatomic, copy)     NSString                            *savedBaseURL;
+@property (nonatomic, copy)     KYCLoopbackChecksHandler            handler;
+
+@end
+
+@implementation KYCLoopbackChecks
+
+// MARK: - Public API
+
++ (void)runWithCompletionHandler:(KYCLoopbackChecksHandler)handler {
+    assert(handler);
+    
+    KYCLoopbackChecks *checks   = [KYCLoopbackChecks new];
+    checks.names                = [NSMutableArray new];
+    checks.checks               = [NSMutableArray new];
+    checks.failures             = [NSMutableArray new];
+    checks.savedTransport       = [KYCCommunication transport];
+    checks.savedBaseURL         = [KYCCommunication baseURL];
+    checks.handler              = handler;
+    
+    [checks addCheck:@"Cancel before upload" block:^(KYCLoopbackTransport *transport, KYCLoopbackCheckHandler handler) {
+        [KYCLoopbackChecks checkCancelBeforeUpload:transport handler:handler];
+    }];
+    [checks addCheck:@"Cancel while polling" block:^(KYCLoopbackTransport *transport, KYCLoopbackCheckHandler handler) {
+        [KYCLoopbackChecks checkCancelWhilePolling:transport handler:handler];
+    }];
+    [checks addCheck:@"Engine load" block:^(KYCLoopbackTransport *transport, KYCLoopbackCheckHandler handler) {
+        [KYCLoopbackChecks checkEngineLoad:transport handler:handler];
+    }];
+    [checks addCheck:@"Crash recovery" block:^(KYCLoopbackTransport *transport, KYCLoopbackCheckHandler handler) {
+        [KYCLoopbackChecks checkCrashRecovery:transport handler:handler];
+    }];
+    
+    [checks runNext];
+}
+
+// MARK: - Private Helpers
+
+- (void)addCheck:(NSString *)name block:(KYCLoopbackCheck)check {
+    [_names addObject:name];
+    [_checks addObject:check];
+}
+
+/**
+ Runs first remaining check with new transport or finishes the run. Called on main thread.
+ */
+- (void)runNext {
+    if (!_checks.count) {
+        [KYCCommunication setTransport:_savedTransport];
+        [KYCCommunication setBaseURL:_savedBaseURL];
+        _handler(_failures);
+        return;
+    }
+    
+    NSString            *name   = _names.firstObject;
+    KYCLoopbackCheck    check   = _checks.firstObject;
+    [_names removeObjectAtIndex:0];
+    [_checks removeObjectAtIndex:0];
+    
+    KYCLoopbackTransport *transport = [KYCLoopbackTransport transportWithSeed:CFG_IDCLOUD_LOOPBACK_SEED];
+    transport.latency   = kLatency;
+    transport.jitter    = .0;
+    [KYCCommunication setTransport:transport];
+    [KYCCommunication setBaseURL:[KYCLoopbackTransport baseURL]];
+    
+    check(transport, ^(NSString *failure) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (failure) {
+                [self.failures addObject:[NSString stringWithFormat:@"%@: %@", name, failure]];
+            }
+            [self runNext];
+        });
+    });
+}
+
+// MARK: - Static Helpers - Checks
+
+/**
+ Verification cancelled right after the start must not send anything.
+ */
++ (void)checkCancelBeforeUpload:(KYCLoopbackTransport *)transport handler:(KYCLoopbackCheckHandler)handler {
+    __block BOOL    completed   = NO;
+    KYCSession      *session    = [KYCLoopbackChecks verifyWithHandler:^(KYCResponse *response, NSString *error) {
+        completed = YES;
+    }];
+    [session cancel];
+    
+    [KYCLoopbackChecks after:kSettleTime block:^{
+        if (transport.requestCount) {
+            handler([NSString stringWithFormat:@"%ld requests were sent after cancel.", (long)transport.requestCount]);
+        } else if (completed) {
+            handler(@"Handler was called after cancel.");
+        } else {
+            handler(nil);
+        }
+    }];
+}
+
+/**
+ Verification cancelled while waiting for the result must not send any further poll.
+ */
++ (void)checkCancelWhilePolling:(KYCLoopbackTransport *)transport handler:(KYCLoopbackCheckHandler)handler {
+    // Server keeps processing during the whole check, so polling would go on without cancel.
+    transport.processingTime = 10 * kSettleTime;
+    
+    __block BOOL    completed   = NO;
+    KYCSession      *session    = [KYCLoopbackChecks verifyWithHandler:^(KYCResponse *response, NSString *error) {
+        completed = YES;
+    }];
+    
+    // Upload is done after one round trip. Some polls follow.
+    [KYCLoopbackChecks after:CFG_IDCLOUD_RETRY_DELAY_SEC + 1. block:^{
+        [session cancel];
+        
+        [KYCLoopbackChecks after:kHandoverTime block:^{
+            NSInteger requestCount = transport.requestCount;
+            if (requestCount < 2) {
+                handler(@"Verification did not start polling before cancel.");
+                return;
+            }
+            
+            [KYCLoopbackChecks after:kSettleTime block:^{
+                NSInteger leaked = transport.requestCount - requestCount;
+                if (leaked) {
+                    handler([NSString stringWithFormat:@"%ld requests were sent after cancel.", (long)leaked]);
+                } else if (completed) {
+                    handler(@"Handler was called after cancel.");
+                } else {
+                    handler(nil);
+                }
+            }];
+        }];
+    }];
+}
+
+/**
+ Engine completes more than hundred verifications without exceeding its concurrency limit.
+ */
++ (void)checkEngineLoad:(KYCLoopbackTransport *)transport handler:(KYCLoopbackCheckHandler)handler {
+    transport.processingTime = 1.;
+    
+    KYCVerificationEngine   *engine     = [KYCVerificationEngine engineWithMaxConcurrent:kLoadConcurrency];
+    NSData                  *image      = [NSMutableData dataWithLength:kImageSize];
+    __block NSInteger       remaining   = kLoadJobCount;
+    __block BOOL            reported    = NO;
+    
+    for (NSInteger loopIndex = 0; loopIndex < kLoadJobCount; loopIndex++) {
+        NSString *group = [NSString stringWithFormat:@"%ld", (long)(loopIndex % kLoadGroupCount)];
+        [engine submitDocumentFront:image documentBack:image selfie:image group:group completionHandler:^(KYCVerificationJob *job) {
+            if (--remaining || reported) {
+                return;
+            }
+            reported = YES;
+            
+            // Every verification needs at least upload and one poll.
+            KYCVerificationEngineStatistics *statistics = [engine statistics];
+            if (statistics.finishedCount != kLoadJobCount) {
+                handler([NSString stringWithFormat:@"%ld of %d verifications finished.", (long)statistics.finishedCount, kLoadJobCount]);
+            } else if (statistics.peakRunningCount != kLoadConcurrency) {
+                handler([NSString stringWithFormat:@"%ld verifications ran at once instead of %d.",
+                         (long)statistics.peakRunningCount, kLoadConcurrency]);
+            } else if (transport.requestCount < 2 * kLoadJobCount) {
+                handler([NSString stringWithFormat:@"Only %ld requests were sent.", (long)transport.requestCount]);
+            } else {
+                handler(nil);
+            }
+        }];
+    }
+    
+    [KYCLoopbackChecks after:kLoadTimeout block:^{
+        if (reported) {
+            return;
+        }
+        reported = YES;
+        
+        [engine cancelAll];
+        handler([NSString stringWithFormat:@"%ld verifications did not finish in time.", (long)remaining]);
+    }];
+}
+
+/**
+ Submission interrupted after the server accepted it is finished after restart without being uploaded again.
+ Recovery time is measured from the restart to the result.
+ */
++ (void)checkCrashRecovery:(KYCLoopbackTransport *)transport handler:(KYCLoopbackCheckHandler)handler {
+    transport.processingTime = kRecoveryProcessing;
+    
+    NSString            *name       = [NSString stringWithFormat:@"KYCLoopbackChecks-%@", [NSUUID UUID].UUIDString];
+    NSURL               *directory  = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:name] isDirectory:YES];
+    NSData              *image      = [NSMutableData dataWithLength:kImageSize];
+    KYCSubmissionQueue  *queue      = [KYCSubmissionQueue queueWithDirectory:directory];
+    
+    // Result must not arrive before the crash. Server is still processing.
+    __block NSString *failure = nil;
+    [queue submitDocumentFront:image documentBack:image selfie:image completionHandler:^(KYCResponse *response, NSString *error) {
+        failure = @"Submission ended before the crash.";
+    }];
+    
+    // Crash once the upload is accepted. Store is left as it is, nothing else is sent by the old instance.
+    [KYCLoopbackChecks after:kRecoveryProcessing / 2. block:^{
+        [queue stop];
+        if (failure || transport.verificationCount != 1) {
+            handler(failure ?: @"Submission did not reach the server before the crash.");
+            [[NSFileManager defaultManager] removeItemAtURL:directory error:nil];
+            return;
+        }
+        
+        // Restart. Submitting the same images again takes over the stored submission.
+        NSDate              *restartDate    = [NSDate date];
+        KYCSubmissionQueue  *restarted      = [KYCSubmissionQueue queueWithDirectory:directory];
+        [restarted resume];
+        [restarted submitDocumentFront:image documentBack:image selfie:image completionHandler:^(KYCResponse *response, NSString *error) {
+            NSTimeInterval recoveryTime = -[restartDate timeIntervalSinceNow];
+            [restarted stop];
+            [[NSFileManager defaultManager] removeItemAtURL:directory error:nil];
+            
+            if (!response) {
+                handler([NSString stringWithFormat:@"Submission failed after restart. %@", error]);
+            } else if (transport.verificationCount != 1) {
+                handler(@"Submission was uploaded again after restart.");
+            } else if (recoveryTime > kRecoveryProcessing + kSettleTime) {
+                handler([NSString stringWithFormat:@"Recovery took %.1f seconds.", recoveryTime]);
+            } else {
+                handler(nil);
+            }
+        }];
+    }];
+}
+
+// MARK: - Static Helpers - Common
+
++ (KYCSession *)verifyWithHandler:(KYCResponseHandler)handler {
+    NSData *image = [NSMutableData dataWithLength:kImageSize];
+    return [KYCCommunication verifyDocumentFront:image documentBack:image selfie:image completionHandler:handler];
+}
+
++ (void)after:(NSTimeInterval)delay block:(dispatch_block_t)block {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), block);
+}
+
+@end
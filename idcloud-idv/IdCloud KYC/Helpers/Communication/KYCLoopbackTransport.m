@@ -0,0 +1,297 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCLoopbackTransport.h"
+#import "KYCSession.h"
+
+#define kLoopbackBaseURL    @"https://loopback.invalid/api/v1/verifications"
+
+#define kStateRunning       @"Running"
+#define kStateFinished      @"Finished"
+#define kStateFailure       @"Failure"
+#define kStateError         @"Error"
+
+/**
+ One emulated server operation.
+ */
+@interface KYCLoopbackOperation : NSObject
+
+@property (nonatomic, copy)     NSString    *operationId;
+@property (nonatomic, strong)   NSDate      *finishDate;
+@property (nonatomic, copy)     NSString    *finalStatus;
+
+@end
+
+@implementation KYCLoopbackOperation
+
+@end
+
+@interface KYCLoopbackTransport()
+
+@property (nonatomic, strong)   dispatch_queue_t                                        queue;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, KYCLoopbackOperation *> *operations;
+@property (nonatomic, assign)   uint64_t                                                seed;
+@property (nonatomic, assign, readwrite) NSInteger                                      requestCount;
+@property (nonatomic, assign, readwrite) NSInteger                                      verificationCount;
+@property (nonatomic, assign, readwrite) long long                                      receivedBytes;
+
+@end
+
+@implementation KYCLoopbackTransport
+
+// MARK: - Life Cycle
+
++ (NSString *)baseURL {
+    return kLoopbackBaseURL;
+}
+
++ (instancetype)transportWithSeed:(uint64_t)seed {
+    return [[KYCLoopbackTransport alloc] initWithSeed:seed];
+}
+
+- (instancetype)initWithSeed:(uint64_t)seed {
+    if (self = [super init]) {
+        self.queue          = dispatch_queue_create("com.thales.kyc.loopback", DISPATCH_QUEUE_SERIAL);
+        self.operations     = [NSMutableDictionary new];
+        self.seed           = seed;
+        self.latency        = .2;
+        self.jitter         = .1;
+        self.processingTime = 3.;
+        self.result         = [KYCLoopbackTransport defaultResult];
+    }
+    
+    return self;
+}
+
+// MARK: - KYCTransport
+
+- (void)sendRequest:(NSURLRequest *)request
+            session:(KYCSession *)session
+  completionHandler:(KYCTransportHandler)handler {
+    // Body is consumed the same way as real upload would do it. Streamed body encodes images only while being read.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        // Cancelled request never reaches the server.
+        if (session.isCancelled) {
+            return;
+        }
+        
+        long long bodyLength = [KYCLoopbackTransport drainBody:request];
+        
+        dispatch_async(self.queue, ^{
+            self.requestCount++;
+            self.receivedBytes += bodyLength;
+            
+            NSData              *data       = nil;
+            NSHTTPURLResponse   *response   = nil;
+            NSError             *error      = nil;
+            NSTimeInterval      delay       = self.latency + self.jitter * [self nextDouble];
+            
+            if (![request.URL.absoluteString hasPrefix:kLoopbackBaseURL]) {
+                error = [KYCLoopbackTransport errorWithCode:NSURLErrorCannotFindHost request:request];
+            } else if ([self nextDouble] < self.transportErrorRate) {
+                error = [KYCLoopbackTransport errorWithCode:NSURLErrorNetworkConnectionLost request:request];
+            } else {
+                data        = [NSJSONSerialization dataWithJSONObject:[self replyToRequest:request] options:0 error:nil];
+                response    = [[NSHTTPURLResponse alloc] initWithURL:request.URL
+                                                          statusCode:200
+                                                         HTTPVersion:@"HTTP/1.1"
+                                                        headerFields:@{@"Content-Type": @"application/json"}];
+            }
+            
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                           dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                // Same as cancelled task, reply of cancelled session is not delivered.
+                if (!session.isCancelled) {
+                    handler(data, response, error);
+                }
+            });
+        });
+    });
+}
+
+// MARK: - Private Helpers - Emulated backend
+
+/**
+ Builds reply of the emulated backend. Called on state queue.
+ 
+ @param request Incoming request.
+ 
+ @return Reply JSON.
+ */
+- (NSDictionary *)replyToRequest:(NSURLRequest *)request {
+    // New verification.
+    if ([request.HTTPMethod isEqualToString:@"POST"]) {
+        KYCLoopbackOperation *operation = [KYCLoopbackOperation new];
+        operation.operationId   = [self nextIdentifier];
+        operation.finishDate    = [NSDate dateWithTimeIntervalSinceNow:self.processingTime];
+        operation.finalStatus   = [self nextFinalStatus];
+        [_operations setObject:operation forKey:operation.operationId];
+        self.verificationCount++;
+        
+        return @{@"id": operation.operationId, @"status": kStateRunning};
+    }
+    
+    // Status of existing one.
+    KYCLoopbackOperation *operation = [self operationForURL:request.URL];
+    if (!operation) {
+        return @{@"status": kStateFailure, @"state": @{@"result": @{@"code": @404, @"message": @"[0] Unknown operation"}}};
+    }
+    
+    if ([operation.finishDate timeIntervalSinceNow] > .0) {
+        return @{@"id": operation.operationId, @"status": kStateRunning};
+    }
+    
+    // Operation is done. Server does not keep it any longer.
+    [_operations removeObjectForKey:operation.operationId];
+    
+    if ([operation.finalStatus isEqualToString:kStateFinished]) {
+        return @{@"id": operation.operationId, @"status": kStateFinished, @"state": @{@"result": _result}};
+    } else if ([operation.finalStatus isEqualToString:kStateFailure]) {
+        NSString *message = [NSString stringWithFormat:@"[%@] Internal service error", operation.operationId];
+        return @{@"id": operation.operationId, @"status": kStateFailure, @"state": @{@"result": @{@"code": @500, @"message": message}}};
+    } else {
+        return @{@"id": operation.operationId, @"status": kStateError};
+    }
+}
+
+/**
+ Finds the operation addressed by the URL. Session appends operation id as path component of the base URL.
+ 
+ @param url Request URL.
+ 
+ @return Operation or {@code nil} if it does not exists.
+ */
+- (KYCLoopbackOperation *)operationForURL:(NSURL *)url {
+    for (NSString *loopComponent in url.pathComponents) {
+        KYCLoopbackOperation *operation = _operations[loopComponent];
+        if (operation) {
+            return operation;
+        }
+    }
+    
+    return nil;
+}
+
+/**
+ Decides how the new operation will end.
+ 
+ @return Final state of operation.
+ */
+- (NSString *)nextFinalStatus {
+    double value = [self nextDouble];
+    if (value < _errorRate) {
+        return kStateError;
+    } else if (value < _errorRate + _failureRate) {
+        return kStateFailure;
+    } else {
+        return kStateFinished;
+    }
+}
+
+// MARK: - Private Helpers - Random
+
+/**
+ SplitMix64 pseudo random generator. Simple, fast and fully determined by the seed.
+ 
+ @return Next random value.
+ */
+- (uint64_t)nextRandom {
+    uint64_t value = (_seed += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+- (double)nextDouble {
+    return (double)([self nextRandom] >> 11) / (double)(1ULL << 53);
+}
+
+- (NSString *)nextIdentifier {
+    uint64_t high   = [self nextRandom];
+    uint64_t low    = [self nextRandom];
+    return [NSString stringWithFormat:@"%08llx-%04llx-%04llx-%04llx-%012llx",
+            high >> 32, (high >> 16) & 0xFFFF, high & 0xFFFF, low >> 48, low & 0xFFFFFFFFFFFFULL];
+}
+
+// MARK: - Private Helpers - Common
+
+/**
+ Reads whole request body.
+ 
+ @param request Request.
+ 
+ @return Number of body bytes.
+ */
++ (long long)drainBody:(NSURLRequest *)request {
+    if (request.HTTPBody) {
+        return request.HTTPBody.length;
+    }
+    
+    NSInputStream *stream = request.HTTPBodyStream;
+    if (!stream) {
+        return 0;
+    }
+    
+    long long   retValue = 0;
+    uint8_t     buffer[16 * 1024];
+    NSInteger   read;
+    [stream open];
+    while ((read = [stream read:buffer maxLength:sizeof(buffer)]) > 0) {
+        retValue += read;
+    }
+    [stream close];
+    
+    return retValue;
+}
+
++ (NSError *)errorWithCode:(NSInteger)code request:(NSURLRequest *)request {
+    return [NSError errorWithDomain:NSURLErrorDomain
+                               code:code
+                           userInfo:@{NSURLErrorFailingURLErrorKey: request.URL,
+                                      NSLocalizedDescriptionKey: @"Emulated communication error."}];
+}
+
+/**
+ Passed verification with all values shown in overview.
+ 
+ @return Result JSON.
+ */
++ (NSDictionary *)defaultResult {
+    return @{@"code": @0,
+             @"message": @"Success",
+             @"type": @"JSON",
+             @"object": @{@"document": @{@"result": @"SUCCESS",
+                                         @"templateName": @"Loopback Residence Permit",
+                                         @"firstName": @"JOHN",
+                                         @"surname": @"SAMPLE",
+                                         @"gender": @"M",
+                                         @"nationality": @"CZE",
+                                         @"birthDate": @"1980-01-01",
+                                         @"expiryDate": @"2030-01-01",
+                                         @"documentNumber": @"000000000",
+                                         @"documentType": @"ResidencePermit",
+                                         @"totalVerifications": @1,
+                                         @"numberImagesProcessed": @2},
+                          @"face": @{@"result": @"SUCCESS",
+                                     @"score": @100}}};
+}
+
+@end
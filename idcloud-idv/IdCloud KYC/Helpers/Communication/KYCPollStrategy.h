@@ -0,0 +1,70 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Strategy deciding how long to wait before next status request while verification is still running.
+ */
+@protocol KYCPollStrategy <NSObject>
+
+/**
+ Returns delay before next status request.
+
+ @param attempt Number of already finished status requests. Starting with 0 for the first poll.
+ @param serverHint Delay requested by the server via {@code Retry-After} header or {@code 0} if there is none.
+
+ @return Delay in seconds.
+ */
+- (NSTimeInterval)delayForAttempt:(NSInteger)attempt serverHint:(NSTimeInterval)serverHint;
+
+@end
+
+/**
+ Original behaviour. Same delay between all requests.
+ */
+@interface KYCPollStrategyFixed : NSObject <KYCPollStrategy>
+
++ (instancetype)strategyWithDelay:(NSTimeInterval)delay;
+
+@end
+
+/**
+ Exponential backoff with random jitter. First polls are done quickly, so fast results are picked up early, while
+ slow backend is not flooded with requests.
+ */
+@interface KYCPollStrategyBackoff : NSObject <KYCPollStrategy>
+
+/**
+ Creates a new {@code KYCPollStrategyBackoff} instance.
+
+ @param initialDelay Delay before first poll.
+ @param maxDelay Upper limit of delay between polls.
+ @param multiplier Delay growth between attempts.
+ @param jitter Random portion of the delay in range 0 - 1. Avoids synchronized polling from multiple clients.
+
+ @return Instance of {@code KYCPollStrategyBackoff}.
+ */
++ (instancetype)strategyWithInitialDelay:(NSTimeInterval)initialDelay
+                                maxDelay:(NSTimeInterval)maxDelay
+                              multiplier:(double)multiplier
+                                  jitter:(double)jitter;
+
+@end
@@ -0,0 +1,85 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCPollStrategy.h"
+
+// MARK: - KYCPollStrategyFixed
+
+@interface KYCPollStrategyFixed()
+
+@property (nonatomic, assign) NSTimeInterval delay;
+
+@end
+
+@implementation KYCPollStrategyFixed
+
++ (instancetype)strategyWithDelay:(NSTimeInterval)delay {
+    KYCPollStrategyFixed *retValue = [KYCPollStrategyFixed new];
+    retValue.delay = delay;
+    return retValue;
+}
+
+- (NSTimeInterval)delayForAttempt:(NSInteger)attempt serverHint:(NSTimeInterval)serverHint {
+    return MAX(_delay, serverHint);
+}
+
+@end
+
+// MARK: - KYCPollStrategyBackoff
+
+@interface KYCPollStrategyBackoff()
+
+@property (nonatomic, assign) NSTimeInterval    initialDelay;
+@property (nonatomic, assign) NSTimeInterval    maxDelay;
+@property (nonatomic, assign) double            multiplier;
+@property (nonatomic, assign) double            jitter;
+
+@end
+
+@implementation KYCPollStrategyBackoff
+
++ (instancetype)strategyWithInitialDelay:(NSTimeInterval)initialDelay
+                                maxDelay:(NSTimeInterval)maxDelay
+                              multiplier:(double)multiplier
+                                  jitter:(double)jitter {
+    KYCPollStrategyBackoff *retValue = [KYCPollStrategyBackoff new];
+    retValue.initialDelay   = initialDelay;
+    retValue.maxDelay       = maxDelay;
+    retValue.multiplier     = multiplier;
+    retValue.jitter         = MIN(MAX(jitter, .0), 1.);
+    return retValue;
+}
+
+- (NSTimeInterval)delayForAttempt:(NSInteger)attempt serverHint:(NSTimeInterval)serverHint {
+    // Server knows best. Do not ask sooner than requested.
+    if (serverHint > .0) {
+        return serverHint;
+    }
+    
+    NSTimeInterval delay = MIN(_initialDelay * pow(_multiplier, attempt), _maxDelay);
+    
+    // Keep (1 - jitter) part of delay fixed and randomize the rest.
+    double random = (double)arc4random_uniform(UINT32_MAX) / (double)UINT32_MAX;
+    return delay * (1. - _jitter) + delay * _jitter * random;
+}
+
+@end
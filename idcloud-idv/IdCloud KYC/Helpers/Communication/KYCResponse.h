@@ -33,6 +33,24 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 + (instancetype)responseWithJSON:(NSDictionary *)response;
 
+/**
+ Key paths of images which can be decoded directly while the reply is being read.
+ 
+ @param prefix Key path of the response object within the server reply.
+ 
+ @return Set of key paths.
+ */
++ (NSSet<NSString *> *)imageKeyPathsWithPrefix:(NSString *)prefix;
+
+/**
+ Key paths of images which are not used by the application and can be skipped while the reply is being read.
+ 
+ @param prefix Key path of the response object within the server reply.
+ 
+ @return Set of key paths.
+ */
++ (NSSet<NSString *> *)droppedKeyPathsWithPrefix:(NSString *)prefix;
+
 - (NSString *)getMessageReadable;
 
 @end
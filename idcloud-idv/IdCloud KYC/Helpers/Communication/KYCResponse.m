@@ -24,6 +24,32 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 @implementation KYCResponse
 
+// MARK: - Key Paths
+
++ (NSSet<NSString *> *)imageKeyPathsWithPrefix:(NSString *)prefix {
+    NSMutableSet *retValue = [NSMutableSet setWithObject:[prefix stringByAppendingString:@".object.document.portrait"]];
+#if !CFG_IDCLOUD_DROP_ECHOED_IMAGES
+    [retValue unionSet:[KYCResponse echoedImageKeyPathsWithPrefix:prefix]];
+#endif
+    
+    return retValue;
+}
+
++ (NSSet<NSString *> *)droppedKeyPathsWithPrefix:(NSString *)prefix {
+#if CFG_IDCLOUD_DROP_ECHOED_IMAGES
+    return [KYCResponse echoedImageKeyPathsWithPrefix:prefix];
+#else
+    return [NSSet set];
+#endif
+}
+
++ (NSSet<NSString *> *)echoedImageKeyPathsWithPrefix:(NSString *)prefix {
+    return [NSSet setWithObjects:
+            [prefix stringByAppendingString:@".object.document.imageWhiteBack"],
+            [prefix stringByAppendingString:@".object.document.imageWhiteFront"],
+            [prefix stringByAppendingString:@".object.face.image"], nil];
+}
+
 + (instancetype)responseWithJSON:(NSDictionary *)response {
     return [[KYCResponse alloc] initWithJSON:response];
 }
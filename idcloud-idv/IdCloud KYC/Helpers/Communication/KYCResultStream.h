@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Handler called for every state received from the server.
+
+ @param state Parsed JSON state. Same structure as response of regular status request.
+
+ @return {@code True} if more states are expected, {@code false} to close the stream.
+ */
+typedef BOOL (^KYCResultStreamHandler)(NSDictionary *state, NSURLResponse *response);
+
+/**
+ Called once the stream is closed.
+
+ @param finished {@code True} if the handler requested close, {@code false} if the server ended the stream sooner.
+ @param error Communication error if any.
+ */
+typedef void (^KYCResultStreamCompletion)(BOOL finished, NSError *error);
+
+/**
+ Single long lived status request which delivers state changes as soon as server publishes them.
+
+ Server can answer either with {@code text/event-stream} where every {@code data:} event holds one state, or with
+ a regular {@code application/json} body, which is handled as a long-poll answer. Servers without support for either
+ simply return current state immediately, so the stream degrades to a regular poll.
+ */
+@interface KYCResultStream : NSObject
+
+/**
+ Creates and starts a new {@code KYCResultStream}.
+
+ @param request Status request.
+ @param timeout Maximum time the server can hold the connection open.
+ @param handler State handler. Called on background queue.
+ @param completion Completion handler. Called on background queue.
+
+ @return Instance of {@code KYCResultStream}.
+ */
++ (instancetype)streamWithRequest:(NSURLRequest *)request
+                          timeout:(NSTimeInterval)timeout
+                          handler:(KYCResultStreamHandler)handler
+                       completion:(KYCResultStreamCompletion)completion;
+
+/**
+ Close the stream. Completion handler is not called.
+ */
+- (void)cancel;
+
+@end
@@ -0,0 +1,210 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCResultStream.h"
+#import "KYCURLSessionManager.h"
+
+#define kContentTypeEventStream @"text/event-stream"
+
+@interface KYCResultStream() <NSURLSessionDataDelegate>
+
+@property (nonatomic, strong)   NSURLSessionDataTask        *task;
+@property (nonatomic, strong)   NSURLResponse               *response;
+@property (nonatomic, strong)   NSMutableData               *buffer;
+@property (nonatomic, copy)     KYCResultStreamHandler      handler;
+@property (nonatomic, copy)     KYCResultStreamCompletion   completion;
+@property (nonatomic, assign)   BOOL                        eventStream;
+@property (nonatomic, assign)   BOOL                        finished;
+@property (nonatomic, assign)   BOOL                        pendingCarriageReturn;
+
+@end
+
+@implementation KYCResultStream
+
+// MARK: - Life Cycle
+
++ (instancetype)streamWithRequest:(NSURLRequest *)request
+                          timeout:(NSTimeInterval)timeout
+                          handler:(KYCResultStreamHandler)handler
+                       completion:(KYCResultStreamCompletion)completion {
+    KYCResultStream *retValue = [[KYCResultStream alloc] initWithHandler:handler completion:completion];
+    [retValue start:request timeout:timeout];
+    return retValue;
+}
+
+- (instancetype)initWithHandler:(KYCResultStreamHandler)handler completion:(KYCResultStreamCompletion)completion {
+    if (self = [super init]) {
+        self.handler    = handler;
+        self.completion = completion;
+        self.buffer     = [NSMutableData new];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (void)cancel {
+    @synchronized (self) {
+        self.completion = nil;
+        self.handler    = nil;
+        [_task cancel];
+    }
+}
+
+// MARK: - Private Helpers
+
+- (void)start:(NSURLRequest *)request timeout:(NSTimeInterval)timeout {
+    // Shared session keeps the connection warm for following requests. Only this request may stay idle much longer.
+    NSMutableURLRequest *streamRequest = [request mutableCopy];
+    [streamRequest setValue:[NSString stringWithFormat:@"%@, application/json", kContentTypeEventStream] forHTTPHeaderField:@"Accept"];
+    [streamRequest setValue:[NSString stringWithFormat:@"wait=%ld", (long)timeout] forHTTPHeaderField:@"Prefer"];
+    streamRequest.timeoutInterval = timeout + 5.;
+    
+    // Manager retains delegate until the task completes. This keeps stream alive while the connection is open.
+    self.task = [[KYCURLSessionManager sharedInstance] startDataTaskWithRequest:streamRequest delegate:self];
+}
+
+- (void)processEventsFinal:(BOOL)final {
+    if (!_eventStream) {
+        // Long-poll answer. Whole body is one state.
+        if (final && _buffer.length) {
+            [self processState:_buffer];
+        }
+        return;
+    }
+    
+    // Events are separated by an empty line. Process all complete ones and keep the rest in buffer.
+    NSData *separator = [@"\n\n" dataUsingEncoding:NSUTF8StringEncoding];
+    while (!_finished) {
+        NSRange range = [_buffer rangeOfData:separator options:0 range:NSMakeRange(0, _buffer.length)];
+        if (range.location == NSNotFound) {
+            break;
+        }
+        
+        NSData *event = [_buffer subdataWithRange:NSMakeRange(0, range.location)];
+        [_buffer replaceBytesInRange:NSMakeRange(0, NSMaxRange(range)) withBytes:NULL length:0];
+        [self processEvent:event];
+    }
+}
+
+- (void)processEvent:(NSData *)event {
+    // Only data lines are interesting. Multiple data lines are joined with new line.
+    NSString        *text = [[NSString alloc] initWithData:event encoding:NSUTF8StringEncoding];
+    NSMutableArray  *data = [NSMutableArray new];
+    for (NSString *loopLine in [text componentsSeparatedByString:@"\n"]) {
+        if ([loopLine hasPrefix:@"data:"]) {
+            NSString *value = [loopLine substringFromIndex:5];
+            [data addObject:[value hasPrefix:@" "] ? [value substringFromIndex:1] : value];
+        }
+    }
+    
+    if (data.count) {
+        [self processState:[[data componentsJoinedByString:@"\n"] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+}
+
+- (void)processState:(NSData *)data {
+    NSDictionary            *state      = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    KYCResultStreamHandler  handler     = self.handler;
+    if (![state isKindOfClass:[NSDictionary class]] || !handler) {
+        return;
+    }
+    
+    if (!handler(state, _response)) {
+        // Final state received. There is nothing else to wait for.
+        self.finished = YES;
+        [_task cancel];
+    }
+}
+
+- (void)callCompletion:(NSError *)error {
+    KYCResultStreamCompletion completion;
+    @synchronized (self) {
+        completion      = self.completion;
+        self.completion = nil;
+        self.handler    = nil;
+    }
+    
+    if (completion) {
+        completion(_finished, _finished ? nil : error);
+    }
+}
+
+- (void)appendEventData:(NSData *)data {
+    // Lines may end with CRLF, CR or LF. Normalize them on bytes so the event separator is always the same.
+    // Neither of them can be part of multi byte UTF-8 sequence, and CRLF may be split between two chunks.
+    const uint8_t   *source     = data.bytes;
+    NSMutableData   *normalized = [NSMutableData dataWithLength:data.length];
+    uint8_t         *target     = normalized.mutableBytes;
+    NSUInteger      length      = 0;
+    for (NSUInteger loopIndex = 0; loopIndex < data.length; loopIndex++) {
+        uint8_t byte = source[loopIndex];
+        if (byte == '\n' && _pendingCarriageReturn) {
+            // Second half of CRLF. New line was already written for the CR.
+            _pendingCarriageReturn = NO;
+            continue;
+        }
+        
+        _pendingCarriageReturn  = byte == '\r';
+        target[length++]        = _pendingCarriageReturn ? '\n' : byte;
+    }
+    
+    [_buffer appendBytes:target length:length];
+}
+
+// MARK: - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session
+          dataTask:(NSURLSessionDataTask *)dataTask
+didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+    // Error reply does not carry any state. Close the stream and let the caller fall back to polling.
+    NSInteger statusCode = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 200;
+    if (statusCode < 200 || statusCode >= 300) {
+        completionHandler(NSURLSessionResponseCancel);
+        return;
+    }
+    
+    self.response       = response;
+    self.eventStream    = [response.MIMEType isEqualToString:kContentTypeEventStream];
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    if (_eventStream) {
+        [self appendEventData:data];
+    } else {
+        [_buffer appendData:data];
+    }
+    [self processEventsFinal:NO];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    if (!_finished) {
+        [self processEventsFinal:YES];
+    }
+    
+    [self callCompletion:error];
+}
+
+@end
@@ -21,18 +21,74 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCResponse.h"
+#import "KYCPollStrategy.h"
+#import "KYCResultStream.h"
+#import "KYCTrace.h"
 
 typedef void (^KYCResponseHandler)(KYCResponse *response, NSString *error);
+typedef void (^KYCUploadFailedHandler)(NSError *error);
+typedef void (^KYCUploadedHandler)(NSString *sessionId);
 
 @interface KYCSession : NSObject
 
-@property (nonatomic, assign)           NSInteger   tryCount;
-@property (nonatomic, copy, readonly)   NSURL       *url;
-@property (nonatomic, copy, readonly)   NSURL       *urlWithSessionId;
+@property (nonatomic, assign)           NSInteger               tryCount;
+@property (nonatomic, copy, readonly)   NSURL                   *url;
+@property (nonatomic, copy, readonly)   NSURL                   *urlWithSessionId;
+@property (nonatomic, strong, readonly) id<KYCPollStrategy>     pollStrategy;
+@property (nonatomic, strong, readonly) NSDate                  *deadline;
+@property (nonatomic, strong)           KYCResultStream         *resultStream;
+@property (nonatomic, copy)             KYCUploadFailedHandler  uploadFailedHandler;
+
+/**
+ {@code True} once the verification was cancelled by the caller.
+ */
+@property (nonatomic, assign, readonly, getter=isCancelled) BOOL    cancelled;
+
+/**
+ Number of requests which were running or scheduled when the verification was cancelled.
+ */
+@property (nonatomic, assign, readonly) NSInteger               savedRequestCount;
+
+/**
+ Number of body bytes which did not have to be uploaded thanks to cancellation.
+ */
+@property (nonatomic, assign, readonly) long long               savedBytes;
 
 + (instancetype)createWithURL:(NSString *)urlBase andHandler:(KYCResponseHandler)handler;
 - (void)updateWithSessionId:(NSString *)sessionId;
 - (void)handleError:(NSString *)error;
+- (void)handleUploadError:(NSError *)error;
+- (void)handleTimeout;
 - (void)handleResult:(KYCResponse *)result;
 
+/**
+ Stops the verification. Running requests are aborted and scheduled polls are dropped. Handler is not called.
+ */
+- (void)cancel;
+
+/**
+ Registers running request, so it can be aborted together with the session. Used by transports.
+ 
+ @param task Running task.
+ */
+- (void)trackTask:(NSURLSessionTask *)task;
+
+/**
+ Schedules next step of the verification. Block is dropped if the session is cancelled or ends before the delay.
+ 
+ @param delay Delay in seconds.
+ @param block Next step. Called on background queue.
+ */
+- (void)dispatchAfter:(NSTimeInterval)delay block:(dispatch_block_t)block;
+
+/**
+ Starts trace span of a verification step. Spans still running when the verification ends are ended with it.
+ 
+ @param name Step name.
+ @param category Span category.
+ 
+ @return Running span or {@code nil} if tracing is disabled.
+ */
+- (KYCTraceSpan *)beginTraceSpan:(NSString *)name category:(NSString *)category;
+
 @end
@@ -27,6 +27,13 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (nonatomic, copy)     NSString            *urlBase;
 @property (nonatomic, copy)     NSString            *sessionId;
 @property (nonatomic, copy)     KYCResponseHandler  handler;
+@property (nonatomic, strong)   KYCTraceSpan        *traceSpan;
+@property (nonatomic, strong)   NSMutableArray      *traceSpans;
+@property (nonatomic, strong)   NSHashTable         *tasks;
+@property (nonatomic, strong)   dispatch_block_t    scheduledBlock;
+@property (nonatomic, strong)   dispatch_block_t    deadlineBlock;
+@property (nonatomic, strong)   NSDate              *verificationDeadline;
+@property (nonatomic, assign)   BOOL                completed;
 
 @end
 
@@ -42,7 +49,30 @@ Please make sure to review our IdCloud documentation, including security guideli
     if (self = [super init]) {
         self.urlBase    = urlBase;
         self.handler    = handler;
-        self.tryCount   = 1;
+        self.tryCount   = 0;
+        
+        // Whole verification is one span. Steps are traced separately within it.
+        self.traceSpan  = [KYCTrace beginSpanWithName:@"verification" category:kTraceCategoryNetwork];
+        self.traceSpans = [NSMutableArray new];
+        self.tasks      = [NSHashTable weakObjectsHashTable];
+        
+        // Whole verification including the upload must end in time, no matter which step is running.
+        __weak __typeof(self) weakSelf = self;
+        self.verificationDeadline   = [NSDate dateWithTimeIntervalSinceNow:CFG_IDCLOUD_VERIFICATION_DEADLINE_SEC];
+        self.deadlineBlock          = dispatch_block_create(0, ^{
+            [weakSelf handleDeadline];
+        });
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(CFG_IDCLOUD_VERIFICATION_DEADLINE_SEC * NSEC_PER_SEC)),
+                       dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), _deadlineBlock);
+
+        if (CFG_IDCLOUD_ADAPTIVE_POLLING) {
+            _pollStrategy = [KYCPollStrategyBackoff strategyWithInitialDelay:.5
+                                                                    maxDelay:CFG_IDCLOUD_RETRY_DELAY_SEC
+                                                                  multiplier:1.5
+                                                                      jitter:.2];
+        } else {
+            _pollStrategy = [KYCPollStrategyFixed strategyWithDelay:CFG_IDCLOUD_RETRY_DELAY_SEC];
+        }
     }
     
     return self;
@@ -60,18 +90,196 @@ Please make sure to review our IdCloud documentation, including security guideli
 
 - (void)updateWithSessionId:(NSString *)sessionId {
     self.sessionId = sessionId;
+    
+    // Server side processing starts now. It can't outlive the whole verification.
+    _deadline = [[NSDate dateWithTimeIntervalSinceNow:CFG_IDCLOUD_POLL_DEADLINE_SEC] earlierDate:_verificationDeadline];
+    [self beginTraceSpan:@"serverProcessing" category:kTraceCategoryNetwork];
+}
+
+- (KYCTraceSpan *)beginTraceSpan:(NSString *)name category:(NSString *)category {
+    KYCTraceSpan *retValue = _traceSpan ? [KYCTrace beginSpanWithName:name category:category] : nil;
+    if (retValue) {
+        @synchronized (_traceSpans) {
+            [_traceSpans addObject:retValue];
+        }
+    }
+    
+    return retValue;
 }
 
 - (void)handleError:(NSString *)error {
+    if (![self complete]) {
+        return;
+    }
+    
+    [self endTrace:error];
+    
     dispatch_async(dispatch_get_main_queue(), ^{
         self.handler(nil, error);
     });
 }
 
+- (void)handleUploadError:(NSError *)error {
+    // Verification did not reach the server or the server did not answer. Caller can keep the data and try again later.
+    KYCUploadFailedHandler handler = self.uploadFailedHandler;
+    if (![self complete]) {
+        return;
+    }
+    
+    [self abortRunningWork];
+    [self endTrace:error.localizedDescription];
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (handler) {
+            handler(error);
+        } else {
+            self.handler(nil, error.localizedDescription);
+        }
+    });
+}
+
+- (void)handleTimeout {
+    [self handleUploadError:[NSError errorWithDomain:NSURLErrorDomain
+                                                code:NSURLErrorTimedOut
+                                            userInfo:@{NSLocalizedDescriptionKey: @"Failed to get server response in time."}]];
+}
+
 - (void)handleResult:(KYCResponse *)result {
+    if (![self complete]) {
+        return;
+    }
+    
+    [self endTrace:nil];
+    
     dispatch_async(dispatch_get_main_queue(), ^{
         self.handler(result, nil);
     });
 }
 
+- (void)cancel {
+    if (![self complete]) {
+        return;
+    }
+    
+    _cancelled = YES;
+    [self abortRunningWork];
+    [self endTrace:@"Cancelled"];
+    
+    // Nothing will be reported any more. Release handlers together with everything they hold.
+    self.handler                = nil;
+    self.uploadFailedHandler    = nil;
+}
+
+- (void)trackTask:(NSURLSessionTask *)task {
+    @synchronized (self) {
+        if (!_completed) {
+            [_tasks addObject:task];
+            return;
+        }
+    }
+    
+    // Request was created after the session ended.
+    [task cancel];
+}
+
+- (void)dispatchAfter:(NSTimeInterval)delay block:(dispatch_block_t)block {
+    dispatch_block_t scheduled = dispatch_block_create(0, ^{
+        @synchronized (self) {
+            self.scheduledBlock = nil;
+        }
+        block();
+    });
+    
+    @synchronized (self) {
+        if (_completed) {
+            return;
+        }
+        self.scheduledBlock = scheduled;
+    }
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), scheduled);
+}
+
+// MARK: - Private Helpers
+
+/**
+ Marks the session as ended. Only the first result, error or cancellation is reported.
+ 
+ @return {@code True} if the session was still running, else {@code false}.
+ */
+- (BOOL)complete {
+    @synchronized (self) {
+        if (_completed) {
+            return NO;
+        }
+        _completed = YES;
+    }
+    
+    dispatch_block_cancel(_deadlineBlock);
+    return YES;
+}
+
+- (void)handleDeadline {
+    // Requests still running are aborted together with the session.
+    [self handleTimeout];
+}
+
+/**
+ Aborts running requests and drops scheduled poll. Session must be already completed, so no new work is started.
+ */
+- (void)abortRunningWork {
+    NSArray             *tasks;
+    dispatch_block_t    scheduled;
+    @synchronized (self) {
+        tasks               = _tasks.allObjects;
+        scheduled           = _scheduledBlock;
+        self.scheduledBlock = nil;
+        [_tasks removeAllObjects];
+    }
+    
+    if (scheduled) {
+        dispatch_block_cancel(scheduled);
+        _savedRequestCount++;
+    }
+    
+    if (_resultStream) {
+        [_resultStream cancel];
+        self.resultStream = nil;
+        _savedRequestCount++;
+    }
+    
+    // Task releases its body, including images, once cancelled.
+    for (NSURLSessionTask *loopTask in tasks) {
+        if (loopTask.state != NSURLSessionTaskStateRunning) {
+            continue;
+        }
+        
+        _savedRequestCount++;
+        _savedBytes += MAX(loopTask.countOfBytesExpectedToSend - loopTask.countOfBytesSent, 0);
+        [loopTask cancel];
+    }
+}
+
+- (void)endTrace:(NSString *)error {
+    KYCTraceSpan *traceSpan = _traceSpan;
+    if (!traceSpan) {
+        return;
+    }
+    self.traceSpan = nil;
+    
+    // Steps which did not finish on their own end together with the verification.
+    @synchronized (_traceSpans) {
+        [_traceSpans makeObjectsPerformSelector:@selector(end)];
+        [_traceSpans removeAllObjects];
+    }
+    
+    [traceSpan setArgument:@(_tryCount) forKey:@"polls"];
+    if (_cancelled) {
+        [traceSpan setArgument:@(_savedRequestCount) forKey:@"savedRequests"];
+        [traceSpan setArgument:@(_savedBytes) forKey:@"savedBytes"];
+    }
+    [traceSpan setArgument:error forKey:@"error"];
+    [traceSpan end];
+}
+
 @end
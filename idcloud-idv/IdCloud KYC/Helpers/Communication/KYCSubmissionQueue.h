@@ -0,0 +1,95 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCSession.h"
+
+#define kNotificationSubmissionFinished         @"kNotificationSubmissionFinished"
+#define kNotificationSubmissionFinishedResponse @"response"
+#define kNotificationSubmissionFinishedError    @"error"
+
+/**
+ Durable queue of verification submissions.
+
+ Captured images are written to disk before anything is sent, so a submission survives lost connection, app
+ termination or crash. Store consists of an append-only journal and a blob area with images protected by iOS
+ data protection. Each journal record is synced on its own, a torn last record after crash is simply ignored.
+
+ Submissions are identified by hash of their content. Submitting the same images again does not create a new entry.
+ Queue is drained one submission at a time whenever network is reachable. Once the server accepts a submission, its
+ server side identifier is stored as well and later attempts only wait for its result. Images are sent again only if
+ they never reached the server. Each submission has limited number of attempts. Result of a submission which outlived
+ its caller is posted as {@code kNotificationSubmissionFinished} with {@code KYCResponse} or error string in user info.
+ */
+@interface KYCSubmissionQueue : NSObject
+
+/**
+ Common method to get KYCSubmissionQueue singletone.
+
+ @return Instance of KYCSubmissionQueue class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Release singletone together with all helper class inside.
+ */
++ (void)end;
+
+/**
+ Creates queue with its own store. Used to run the queue against emulated backend. Application uses the singletone.
+ 
+ @param directory Directory of the store.
+ 
+ @return Instance of KYCSubmissionQueue class.
+ */
++ (instancetype)queueWithDirectory:(NSURL *)directory;
+
+/**
+ Stops sending. Running submission is aborted, but stays stored, so it is picked up by next {@code resume}.
+ */
+- (void)stop;
+
+/**
+ Stores the submission and sends it as soon as network is reachable.
+
+ @param docFront Front side of the document.
+ @param docBack Back side of the document. Optional.
+ @param selfie Selfie image. Optional.
+ @param handler Called once on main thread. Either with the result, or with an error if the submission could not be
+ stored, or with an information that it was queued for later because there is no connection.
+ */
+- (void)submitDocumentFront:(NSData *)docFront
+               documentBack:(NSData *)docBack
+                     selfie:(NSData *)selfie
+          completionHandler:(KYCResponseHandler)handler;
+
+/**
+ Loads submissions stored before last termination and starts sending them once network is reachable.
+ Should be called early after application start.
+ */
+- (void)resume;
+
+/**
+ Number of stored submissions waiting for server response.
+ */
+@property (nonatomic, assign, readonly) NSInteger pendingCount;
+
+@end
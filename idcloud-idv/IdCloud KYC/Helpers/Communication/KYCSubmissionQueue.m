@@ -0,0 +1,582 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCSubmissionQueue.h"
+#import "KYCCommunication.h"
+#import "KYCURLSessionManager.h"
+#import <CommonCrypto/CommonDigest.h>
+#import <SystemConfiguration/SystemConfiguration.h>
+#import <netinet/in.h>
+
+#define kStoreDirectory         @"KYCSubmissions"
+#define kJournalName            @"journal.log"
+#define kBlobDirectory          @"blobs"
+
+#define kPartFront              @"front"
+#define kPartBack               @"back"
+#define kPartSelfie             @"selfie"
+
+#define kRecordOperation        @"op"
+#define kRecordOperationAdd     @"add"
+#define kRecordOperationRemove  @"remove"
+#define kRecordOperationUpdate  @"update"
+#define kRecordIdentifier       @"id"
+#define kRecordSize             @"size"
+#define kRecordParts            @"parts"
+#define kRecordSessionId        @"sessionId"
+#define kRecordAttempts         @"attempts"
+
+// Journal is rewritten with pending records only once it grows over this size.
+#define kJournalCompactSize     (64 * 1024)
+
+// Delay before next attempt if the network is reachable, but server is not.
+#define kRetryDelaySec          30.
+
+// Number of attempts to submit or to get the result before the submission is discarded.
+#define kMaxAttempts            5
+
+#define kFileProtection         NSDataWritingFileProtectionCompleteUntilFirstUserAuthentication
+
+static KYCSubmissionQueue *sInstance = nil;
+
+@interface KYCSubmissionQueue()
+
+@property (nonatomic, strong)   dispatch_queue_t                                        queue;
+@property (nonatomic, strong)   NSURL                                                   *directory;
+@property (nonatomic, strong)   NSFileHandle                                            *journal;
+@property (nonatomic, strong)   NSMutableArray<NSString *>                              *pending;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, NSDictionary *>         *records;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, KYCResponseHandler>     *handlers;
+@property (nonatomic, assign)   SCNetworkReachabilityRef                                reachability;
+@property (nonatomic, assign)   BOOL                                                    reachabilityKnown;
+@property (nonatomic, assign)   BOOL                                                    online;
+@property (nonatomic, assign)   BOOL                                                    sending;
+@property (nonatomic, assign)   BOOL                                                    retryScheduled;
+@property (nonatomic, assign)   BOOL                                                    stopped;
+@property (nonatomic, strong)   KYCSession                                              *session;
+
+- (void)reachabilityChanged:(SCNetworkReachabilityFlags)flags;
+
+@end
+
+static void KYCSubmissionQueueReachabilityCallback(SCNetworkReachabilityRef target,
+                                                   SCNetworkReachabilityFlags flags,
+                                                   void *info) {
+    [(__bridge KYCSubmissionQueue *)info reachabilityChanged:flags];
+}
+
+@implementation KYCSubmissionQueue
+
+// MARK: - Static Helpers
+
++ (instancetype)sharedInstance {
+    @synchronized (self) {
+        if (!sInstance) {
+            sInstance = [[KYCSubmissionQueue alloc] init];
+        }
+        
+        return sInstance;
+    }
+}
+
++ (void)end {
+    @synchronized (self) {
+        [sInstance stop];
+        sInstance = nil;
+    }
+}
+
++ (instancetype)queueWithDirectory:(NSURL *)directory {
+    return [[KYCSubmissionQueue alloc] initWithDirectory:directory];
+}
+
+// MARK: - Life Cycle
+
+- (instancetype)init {
+    NSURL *support = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+    return [self initWithDirectory:[support URLByAppendingPathComponent:kStoreDirectory isDirectory:YES]];
+}
+
+- (instancetype)initWithDirectory:(NSURL *)directory {
+    if (self = [super init]) {
+        self.directory  = directory;
+        self.queue      = dispatch_queue_create("KYCSubmissionQueue", DISPATCH_QUEUE_SERIAL);
+        self.pending    = [NSMutableArray new];
+        self.records    = [NSMutableDictionary new];
+        self.handlers   = [NSMutableDictionary new];
+        
+        // Recover whatever was stored before last termination. Everything else runs on the same queue after it.
+        dispatch_async(_queue, ^{
+            [self load];
+        });
+        [self startReachability];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    [self stopReachability];
+}
+
+// MARK: - Public API
+
+- (void)submitDocumentFront:(NSData *)docFront
+               documentBack:(NSData *)docBack
+                     selfie:(NSData *)selfie
+          completionHandler:(KYCResponseHandler)handler {
+    dispatch_async(_queue, ^{
+        NSDictionary<NSString *, NSData *> *parts = [KYCSubmissionQueue partsWithFront:docFront back:docBack selfie:selfie];
+        NSString *identifier = [KYCSubmissionQueue identifierOfParts:parts];
+        
+        // Same images are already waiting. Do not store them twice, caller just takes over the result.
+        if (!self.records[identifier]) {
+            NSString *error = [self storeSubmission:identifier parts:parts];
+            if (error) {
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    handler(nil, error);
+                });
+                return;
+            }
+        }
+        
+        [self.handlers setObject:handler forKey:identifier];
+        if (self.reachabilityKnown && !self.online) {
+            [self notifyQueued];
+        } else {
+            [self drain];
+        }
+    });
+}
+
+- (void)resume {
+    dispatch_async(_queue, ^{
+        [self drain];
+    });
+}
+
+- (void)stop {
+    [self stopReachability];
+    
+    dispatch_sync(_queue, ^{
+        self.stopped = YES;
+        [self.session cancel];
+        self.session = nil;
+        [self.journal closeFile];
+        self.journal = nil;
+    });
+}
+
+- (NSInteger)pendingCount {
+    __block NSInteger retValue;
+    dispatch_sync(_queue, ^{
+        retValue = self.pending.count;
+    });
+    
+    return retValue;
+}
+
+// MARK: - Store
+
+- (NSURL *)journalURL {
+    return [_directory URLByAppendingPathComponent:kJournalName];
+}
+
+- (NSURL *)blobURL:(NSString *)identifier part:(NSString *)part {
+    NSString *name = [NSString stringWithFormat:@"%@.%@", identifier, part];
+    return [[_directory URLByAppendingPathComponent:kBlobDirectory isDirectory:YES] URLByAppendingPathComponent:name];
+}
+
+- (void)load {
+    NSFileManager *manager = [NSFileManager defaultManager];
+    [manager createDirectoryAtURL:[_directory URLByAppendingPathComponent:kBlobDirectory isDirectory:YES]
+      withIntermediateDirectories:YES
+                       attributes:nil
+                            error:nil];
+    
+    // Replay the journal. Record which was not completely written before crash is not valid JSON and is skipped.
+    NSData      *journal    = [NSData dataWithContentsOfURL:[self journalURL]];
+    NSString    *text       = journal ? [[NSString alloc] initWithData:journal encoding:NSUTF8StringEncoding] : nil;
+    for (NSString *loopLine in [text componentsSeparatedByString:@"\n"]) {
+        NSDictionary *record = [NSJSONSerialization JSONObjectWithData:[loopLine dataUsingEncoding:NSUTF8StringEncoding] options:0 error:nil];
+        if (![record isKindOfClass:[NSDictionary class]] || ![record[kRecordIdentifier] isKindOfClass:[NSString class]]) {
+            continue;
+        }
+        
+        NSString *identifier = record[kRecordIdentifier];
+        if ([record[kRecordOperation] isEqualToString:kRecordOperationAdd] && !_records[identifier]) {
+            [_pending addObject:identifier];
+            [_records setObject:record forKey:identifier];
+        } else if ([record[kRecordOperation] isEqualToString:kRecordOperationRemove]) {
+            [_pending removeObject:identifier];
+            [_records removeObjectForKey:identifier];
+        } else if ([record[kRecordOperation] isEqualToString:kRecordOperationUpdate] && _records[identifier]) {
+            [self mergeRecord:record];
+        }
+    }
+    
+    // Blobs are written before the journal record. Crash in between leaves them without owner.
+    NSURL *blobs = [_directory URLByAppendingPathComponent:kBlobDirectory isDirectory:YES];
+    for (NSURL *loopBlob in [manager contentsOfDirectoryAtURL:blobs includingPropertiesForKeys:nil options:0 error:nil]) {
+        if (!_records[loopBlob.lastPathComponent.stringByDeletingPathExtension]) {
+            [manager removeItemAtURL:loopBlob error:nil];
+        }
+    }
+    
+    [self compactJournal];
+}
+
+- (NSString *)storeSubmission:(NSString *)identifier parts:(NSDictionary<NSString *, NSData *> *)parts {
+    // Keep disk usage bounded. Already stored submissions are never dropped to make space for new ones.
+    unsigned long long size = 0;
+    for (NSData *loopPart in parts.allValues) {
+        size += loopPart.length;
+    }
+    if ([self storedSize] + size > (unsigned long long)CFG_IDCLOUD_SUBMISSION_QUEUE_MAX_MB * 1024 * 1024) {
+        return TRANSLATE(@"STRING_KYC_SUBMISSION_QUEUE_FULL");
+    }
+    
+    // Images first. Submission becomes visible only with its journal record.
+    for (NSString *loopPart in parts) {
+        NSError *error = nil;
+        if (![parts[loopPart] writeToURL:[self blobURL:identifier part:loopPart] options:NSDataWritingAtomic | kFileProtection error:&error]) {
+            return error.localizedDescription;
+        }
+    }
+    
+    NSDictionary *record = @{
+        kRecordOperation    : kRecordOperationAdd,
+        kRecordIdentifier   : identifier,
+        kRecordSize         : @(size),
+        kRecordParts        : parts.allKeys
+    };
+    NSError *error = nil;
+    if (![self appendRecord:record error:&error]) {
+        return error.localizedDescription;
+    }
+    
+    [_pending addObject:identifier];
+    [_records setObject:record forKey:identifier];
+    
+    return nil;
+}
+
+- (void)removeSubmission:(NSString *)identifier {
+    NSDictionary *record = _records[identifier];
+    if (!record) {
+        return;
+    }
+    
+    // Journal first. If blobs survive a crash, they are removed as orphans on next load.
+    [self appendRecord:@{kRecordOperation: kRecordOperationRemove, kRecordIdentifier: identifier} error:nil];
+    for (NSString *loopPart in record[kRecordParts]) {
+        [[NSFileManager defaultManager] removeItemAtURL:[self blobURL:identifier part:loopPart] error:nil];
+    }
+    
+    [_pending removeObject:identifier];
+    [_records removeObjectForKey:identifier];
+    
+    if (!_pending.count || [_journal offsetInFile] > kJournalCompactSize) {
+        [self compactJournal];
+    }
+}
+
+- (void)updateSubmission:(NSString *)identifier values:(NSDictionary *)values {
+    NSMutableDictionary *record = [values mutableCopy];
+    record[kRecordOperation]    = kRecordOperationUpdate;
+    record[kRecordIdentifier]   = identifier;
+    
+    [self appendRecord:record error:nil];
+    [self mergeRecord:record];
+}
+
+- (void)mergeRecord:(NSDictionary *)update {
+    // Compacted journal keeps only add records. Updated values become part of them.
+    NSString            *identifier = update[kRecordIdentifier];
+    NSMutableDictionary *record     = [_records[identifier] mutableCopy];
+    [record addEntriesFromDictionary:update];
+    record[kRecordOperation] = kRecordOperationAdd;
+    [_records setObject:record forKey:identifier];
+}
+
+- (BOOL)appendRecord:(NSDictionary *)record error:(NSError **)error {
+    NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:record options:0 error:error] mutableCopy];
+    if (!line || !_journal) {
+        return NO;
+    }
+    [line appendBytes:"\n" length:1];
+    
+    // Single write per record followed by sync. On disk the record is either complete, or torn and ignored on load.
+    @try {
+        [_journal seekToEndOfFile];
+        [_journal writeData:line];
+        [_journal synchronizeFile];
+    } @catch (NSException *exception) {
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (void)compactJournal {
+    // Rewrite journal with add records of pending submissions only. Replacement is atomic.
+    NSMutableData *data = [NSMutableData new];
+    for (NSString *loopIdentifier in _pending) {
+        [data appendData:[NSJSONSerialization dataWithJSONObject:_records[loopIdentifier] options:0 error:nil]];
+        [data appendBytes:"\n" length:1];
+    }
+    
+    [_journal closeFile];
+    [data writeToURL:[self journalURL] options:NSDataWritingAtomic | kFileProtection error:nil];
+    self.journal = [NSFileHandle fileHandleForWritingToURL:[self journalURL] error:nil];
+}
+
+- (unsigned long long)storedSize {
+    unsigned long long retValue = 0;
+    for (NSDictionary *loopRecord in _records.allValues) {
+        retValue += [loopRecord[kRecordSize] unsignedLongLongValue];
+    }
+    
+    return retValue;
+}
+
++ (NSDictionary<NSString *, NSData *> *)partsWithFront:(NSData *)docFront back:(NSData *)docBack selfie:(NSData *)selfie {
+    NSMutableDictionary *retValue = [NSMutableDictionary new];
+    [retValue setValue:docFront forKey:kPartFront];
+    [retValue setValue:docBack forKey:kPartBack];
+    [retValue setValue:selfie forKey:kPartSelfie];
+    return retValue;
+}
+
++ (NSString *)identifierOfParts:(NSDictionary<NSString *, NSData *> *)parts {
+    // Hash of all parts in fixed order. Part name is included, so moving image between parts changes the hash.
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    for (NSString *loopPart in @[kPartFront, kPartBack, kPartSelfie]) {
+        NSData      *data   = parts[loopPart];
+        uint64_t    length  = data.length;
+        CC_SHA256_Update(&context, loopPart.UTF8String, (CC_LONG)strlen(loopPart.UTF8String));
+        CC_SHA256_Update(&context, &length, sizeof(length));
+        CC_SHA256_Update(&context, data.bytes, (CC_LONG)data.length);
+    }
+    
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &context);
+    
+    NSMutableString *retValue = [NSMutableString new];
+    for (NSInteger index = 0; index < CC_SHA256_DIGEST_LENGTH; index++) {
+        [retValue appendFormat:@"%02x", digest[index]];
+    }
+    
+    return retValue;
+}
+
+// MARK: - Drain
+
+- (void)drain {
+    if (_stopped || _sending || !_online || !_pending.count) {
+        return;
+    }
+    
+    // Oldest submission first. Give up on it once it runs out of attempts.
+    NSString    *identifier = _pending.firstObject;
+    NSString    *sessionId  = _records[identifier][kRecordSessionId];
+    NSInteger   attempts    = [_records[identifier][kRecordAttempts] integerValue];
+    if (attempts >= kMaxAttempts) {
+        [self discardSubmission:identifier error:TRANSLATE(@"STRING_KYC_SUBMISSION_EXPIRED")];
+        return;
+    }
+    
+    // Server already has the images. Just wait for the result.
+    if (sessionId) {
+        [self updateSubmission:identifier values:@{kRecordAttempts: @(attempts + 1)}];
+        self.sending = YES;
+        self.session = [KYCCommunication resumeVerification:sessionId
+                                          completionHandler:[self completionHandlerOfSubmission:identifier]
+                                        uploadFailedHandler:[self uploadFailedHandlerOfSubmission:identifier]];
+        return;
+    }
+    
+    // Load images. Missing image means the store was damaged outside of the app.
+    NSMutableDictionary<NSString *, NSData *> *parts = [NSMutableDictionary new];
+    for (NSString *loopPart in _records[identifier][kRecordParts]) {
+        NSData *data = [NSData dataWithContentsOfURL:[self blobURL:identifier part:loopPart]];
+        if (!data) {
+            [self discardSubmission:identifier error:TRANSLATE(@"STRING_KYC_SUBMISSION_DAMAGED")];
+            return;
+        }
+        [parts setObject:data forKey:loopPart];
+    }
+    
+    [self updateSubmission:identifier values:@{kRecordAttempts: @(attempts + 1)}];
+    self.sending = YES;
+    self.session = [KYCCommunication verifyDocumentFront:parts[kPartFront]
+                                            documentBack:parts[kPartBack]
+                                                  selfie:parts[kPartSelfie]
+                                       completionHandler:[self completionHandlerOfSubmission:identifier]
+                                         uploadedHandler:^(NSString *sessionId) {
+        // From now on the submission must not be uploaded again, even after crash.
+        dispatch_async(self.queue, ^{
+            if (!self.stopped) {
+                [self updateSubmission:identifier values:@{kRecordSessionId: sessionId}];
+            }
+        });
+    } uploadFailedHandler:[self uploadFailedHandlerOfSubmission:identifier]];
+}
+
+- (KYCResponseHandler)completionHandlerOfSubmission:(NSString *)identifier {
+    return ^(KYCResponse *response, NSString *error) {
+        // Server answered. Either with result or with error, there is no point in sending the same data again.
+        dispatch_async(self.queue, ^{
+            self.sending = NO;
+            self.session = nil;
+            [self removeSubmission:identifier];
+            [self finish:identifier response:response error:error];
+            [self drain];
+        });
+    };
+}
+
+- (KYCUploadFailedHandler)uploadFailedHandlerOfSubmission:(NSString *)identifier {
+    return ^(NSError *error) {
+        dispatch_async(self.queue, ^{
+            self.sending = NO;
+            self.session = nil;
+            
+            // Upload might have reached the server even though the answer was lost. Sending it again could create
+            // second verification on the server.
+            if (!self.records[identifier][kRecordSessionId] && ![KYCCommunication isUnsentRequestError:error]) {
+                [self discardSubmission:identifier error:error.localizedDescription];
+                return;
+            }
+            
+            // Server was not reached or did not answer in time. Keep it for the next attempt.
+            [self notifyQueued];
+            [self scheduleRetry];
+        });
+    };
+}
+
+- (void)discardSubmission:(NSString *)identifier error:(NSString *)error {
+    [self removeSubmission:identifier];
+    [self finish:identifier response:nil error:error];
+    [self drain];
+}
+
+- (void)scheduleRetry {
+    if (_retryScheduled) {
+        return;
+    }
+    
+    self.retryScheduled = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kRetryDelaySec * NSEC_PER_SEC)), _queue, ^{
+        self.retryScheduled = NO;
+        [self drain];
+    });
+}
+
+- (void)finish:(NSString *)identifier response:(KYCResponse *)response error:(NSString *)error {
+    KYCResponseHandler handler = _handlers[identifier];
+    [_handlers removeObjectForKey:identifier];
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (handler) {
+            handler(response, error);
+        } else {
+            NSMutableDictionary *userInfo = [NSMutableDictionary new];
+            [userInfo setValue:response forKey:kNotificationSubmissionFinishedResponse];
+            [userInfo setValue:error forKey:kNotificationSubmissionFinishedError];
+            [[NSNotificationCenter defaultCenter] postNotificationName:kNotificationSubmissionFinished
+                                                                object:nil
+                                                              userInfo:userInfo];
+        }
+    });
+}
+
+- (void)notifyQueued {
+    // Waiting callers are released. Final result will be delivered as notification.
+    NSArray<KYCResponseHandler> *handlers = _handlers.allValues;
+    [_handlers removeAllObjects];
+    
+    dispatch_async(dispatch_get_main_queue(), ^{
+        for (KYCResponseHandler loopHandler in handlers) {
+            loopHandler(nil, TRANSLATE(@"STRING_KYC_SUBMISSION_QUEUED"));
+        }
+    });
+}
+
+// MARK: - Reachability
+
+- (void)startReachability {
+    // Emulated backend or any other custom transport does not need any network.
+    if (CFG_IDCLOUD_LOOPBACK || [KYCCommunication transport] != [KYCURLSessionManager sharedInstance]) {
+        self.online = YES;
+        return;
+    }
+
+    // Zero address checks general availability of network without resolving any host.
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len     = sizeof(address);
+    address.sin_family  = AF_INET;
+    
+    self.reachability = SCNetworkReachabilityCreateWithAddress(kCFAllocatorDefault, (const struct sockaddr *)&address);
+    if (!_reachability) {
+        // Can't watch the network. Try to send right away and rely on upload errors.
+        self.online = YES;
+        return;
+    }
+    
+    SCNetworkReachabilityContext context = {0, (__bridge void *)self, NULL, NULL, NULL};
+    SCNetworkReachabilitySetCallback(_reachability, KYCSubmissionQueueReachabilityCallback, &context);
+    SCNetworkReachabilitySetDispatchQueue(_reachability, _queue);
+    
+    // Callback is called only on change. Get initial state on the queue as well.
+    dispatch_async(_queue, ^{
+        SCNetworkReachabilityFlags flags = 0;
+        if (self.reachability && SCNetworkReachabilityGetFlags(self.reachability, &flags)) {
+            [self reachabilityChanged:flags];
+        }
+    });
+}
+
+- (void)stopReachability {
+    if (_reachability) {
+        SCNetworkReachabilitySetCallback(_reachability, NULL, NULL);
+        SCNetworkReachabilitySetDispatchQueue(_reachability, NULL);
+        CFRelease(_reachability);
+        self.reachability = NULL;
+    }
+}
+
+- (void)reachabilityChanged:(SCNetworkReachabilityFlags)flags {
+    self.reachabilityKnown  = YES;
+    self.online             = (flags & kSCNetworkReachabilityFlagsReachable) &&
+                              !(flags & kSCNetworkReachabilityFlagsConnectionRequired);
+    if (_online) {
+        [self drain];
+    } else {
+        [self notifyQueued];
+    }
+}
+
+@end
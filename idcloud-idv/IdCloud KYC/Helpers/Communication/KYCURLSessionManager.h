@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCTransport.h"
+
+/**
+ Owner of the {@code NSURLSession} used for all verification steps.
+
+ Session is created once per credential set (JWT and API key) and reused, so the connection established by the
+ first request is kept alive for all following requests and polls. Session is rebuilt only when credentials change.
+ */
+@interface KYCURLSessionManager : NSObject <KYCTransport>
+
+/**
+ Session configured with current credentials.
+ */
+@property (nonatomic, strong, readonly) NSURLSession    *session;
+
+/**
+ Number of HTTP transactions finished by the current session.
+ */
+@property (nonatomic, assign, readonly) NSInteger       transactionCount;
+
+/**
+ Number of HTTP transactions which reused already opened connection.
+ */
+@property (nonatomic, assign, readonly) NSInteger       reusedConnectionCount;
+
+/**
+ {@code True} if the verification backend announced support of gzip compressed request body.
+ */
+@property (nonatomic, assign, readonly) BOOL            gzipRequestSupported;
+
+/**
+ Maximum number of connections opened to the backend. Single verification needs only one. Default value is 1.
+ Changing the value rebuilds the session.
+ */
+@property (nonatomic, assign)           NSInteger       maximumConnectionsPerHost;
+
+/**
+ Common method to get KYCURLSessionManager singletone.
+
+ @return Instance of KYCURLSessionManager class.
+ */
++ (instancetype)sharedInstance;
+
+/**
+ Invalidate current session and release singletone.
+ */
++ (void)end;
+
+/**
+ Starts a task which reports response and data to the delegate as they arrive instead of calling completion handler.
+ Used for long lived connections. Task runs on its own session, so it never waits for or blocks regular requests.
+ 
+ @param request Request to send.
+ @param delegate Receiver of response, data and completion. Retained until the task completes.
+ 
+ @return Running task.
+ */
+- (NSURLSessionDataTask *)startDataTaskWithRequest:(NSURLRequest *)request delegate:(id<NSURLSessionDataDelegate>)delegate;
+
+/**
+ Lets the owner use more connections than {@code maximumConnectionsPerHost} until it releases them. Session uses
+ the highest limit of all owners. Change of the resulting limit rebuilds the session.
+ 
+ @param limit Number of connections needed by the owner or 0 to release them.
+ @param owner Unique key of the owner.
+ */
+- (void)setConnectionLimit:(NSInteger)limit forOwner:(NSString *)owner;
+
+/**
+ Reset transaction statistics. Session is shared by all verifications, so only the owner of the statistics calls it.
+ */
+- (void)resetMetrics;
+
+/**
+ Updates known backend capabilities from headers of finished transactions. Sessions not owned by this class can
+ forward their metrics here as well.
+
+ @param metrics Task metrics.
+ */
+- (void)updateCapabilitiesWithMetrics:(NSURLSessionTaskMetrics *)metrics;
+
+@end
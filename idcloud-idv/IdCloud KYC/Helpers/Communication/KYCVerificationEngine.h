@@ -0,0 +1,149 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCSession.h"
+
+@class KYCVerificationJob;
+
+typedef NS_ENUM(NSInteger, KYCVerificationJobState) {
+    KYCVerificationJobStatePending      = 0,    // Waiting for free slot.
+    KYCVerificationJobStateRunning      = 1,    // Verification is running.
+    KYCVerificationJobStateFinished     = 2,    // Server returned verification result.
+    KYCVerificationJobStateFailed       = 3,    // Verification failed. See error of the job.
+    KYCVerificationJobStateCancelled    = 4     // Verification was cancelled by the caller.
+};
+
+typedef void (^KYCVerificationJobHandler)(KYCVerificationJob *job);
+
+/**
+ One verification owned by {@code KYCVerificationEngine}. Job keeps its own copy of images, so it does not depend on
+ images captured by {@code KYCManager}.
+ */
+@interface KYCVerificationJob : NSObject
+
+@property (nonatomic, copy, readonly)   NSString                *identifier;
+@property (nonatomic, copy, readonly)   NSString                *group;
+@property (nonatomic, assign, readonly) KYCVerificationJobState state;
+@property (nonatomic, strong, readonly) KYCResponse             *response;
+@property (nonatomic, copy, readonly)   NSString                *error;
+@property (nonatomic, strong, readonly) NSDate                  *submitDate;
+@property (nonatomic, strong, readonly) NSDate                  *startDate;
+@property (nonatomic, strong, readonly) NSDate                  *finishDate;
+
+@end
+
+/**
+ Snapshot of engine counters.
+ */
+@interface KYCVerificationEngineStatistics : NSObject
+
+@property (nonatomic, assign, readonly) NSInteger       submittedCount;
+@property (nonatomic, assign, readonly) NSInteger       pendingCount;
+@property (nonatomic, assign, readonly) NSInteger       runningCount;
+@property (nonatomic, assign, readonly) NSInteger       peakRunningCount;
+@property (nonatomic, assign, readonly) NSInteger       finishedCount;
+@property (nonatomic, assign, readonly) NSInteger       failedCount;
+@property (nonatomic, assign, readonly) NSInteger       cancelledCount;
+
+/**
+ Completed verifications per second since the first one was started.
+ */
+@property (nonatomic, assign, readonly) double          throughput;
+
+/**
+ Average time in seconds from submission to completion.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval  averageLatency;
+
+/**
+ Average time in seconds spent waiting for free slot.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval  averageWaitTime;
+
+@end
+
+/**
+ Runs many independent verifications at once, e.g. for kiosk or batch re-verification.
+
+ Number of verifications in flight is bounded. Waiting jobs are scheduled round-robin between groups and in order of
+ submission within a group, so one busy terminal can't starve the others. Every job has its own {@code KYCSession}.
+ */
+@interface KYCVerificationEngine : NSObject
+
+/**
+ Creates new engine.
+ 
+ @param maxConcurrent Maximum number of verifications in flight.
+ 
+ @return Instance of KYCVerificationEngine class.
+ */
++ (instancetype)engineWithMaxConcurrent:(NSInteger)maxConcurrent;
+
+/**
+ Maximum number of verifications in flight. Raising the value starts waiting jobs right away.
+ */
+@property (nonatomic, assign) NSInteger maxConcurrent;
+
+/**
+ Queues new verification.
+ 
+ @param docFront Front side of the document.
+ @param docBack Back side of the document. Optional.
+ @param selfie Selfie image. Optional.
+ @param group Fairness group, e.g. kiosk identifier. Optional.
+ @param handler Called once on main thread when the job is finished, failed or cancelled.
+ 
+ @return Queued job.
+ */
+- (KYCVerificationJob *)submitDocumentFront:(NSData *)docFront
+                               documentBack:(NSData *)docBack
+                                     selfie:(NSData *)selfie
+                                      group:(NSString *)group
+                          completionHandler:(KYCVerificationJobHandler)handler;
+
+/**
+ Cancels the job. Waiting job is removed from the queue. Running job aborts its requests and releases its slot
+ right away.
+ 
+ @param job Job to be cancelled.
+ 
+ @return {@code True} if the job was cancelled, {@code false} if it was already completed.
+ */
+- (BOOL)cancelJob:(KYCVerificationJob *)job;
+
+/**
+ Cancels all waiting and running jobs.
+ */
+- (void)cancelAll;
+
+/**
+ Current counters.
+ 
+ @return Statistics snapshot.
+ */
+- (KYCVerificationEngineStatistics *)statistics;
+
+/**
+ Resets counters of completed jobs together with connection reuse statistics. Running and waiting jobs are kept.
+ */
+- (void)resetStatistics;
+
+@end
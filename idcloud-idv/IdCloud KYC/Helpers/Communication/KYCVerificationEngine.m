@@ -0,0 +1,400 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCVerificationEngine.h"
+#import "KYCCommunication.h"
+#import "KYCURLSessionManager.h"
+
+#define kDefaultGroup @""
+
+// MARK: - KYCVerificationJob
+
+@interface KYCVerificationJob()
+
+@property (nonatomic, copy)     NSString                    *identifier;
+@property (nonatomic, copy)     NSString                    *group;
+@property (nonatomic, assign)   KYCVerificationJobState     state;
+@property (nonatomic, strong)   KYCResponse                 *response;
+@property (nonatomic, copy)     NSString                    *error;
+@property (nonatomic, strong)   NSDate                      *submitDate;
+@property (nonatomic, strong)   NSDate                      *startDate;
+@property (nonatomic, strong)   NSDate                      *finishDate;
+@property (nonatomic, strong)   NSData                      *documentFront;
+@property (nonatomic, strong)   NSData                      *documentBack;
+@property (nonatomic, strong)   NSData                      *selfie;
+@property (nonatomic, copy)     KYCVerificationJobHandler   handler;
+@property (nonatomic, strong)   KYCSession                  *session;
+
+@end
+
+@implementation KYCVerificationJob
+
+@end
+
+// MARK: - KYCVerificationEngineStatistics
+
+@interface KYCVerificationEngineStatistics()
+
+@property (nonatomic, assign)   NSInteger       submittedCount;
+@property (nonatomic, assign)   NSInteger       pendingCount;
+@property (nonatomic, assign)   NSInteger       runningCount;
+@property (nonatomic, assign)   NSInteger       peakRunningCount;
+@property (nonatomic, assign)   NSInteger       finishedCount;
+@property (nonatomic, assign)   NSInteger       failedCount;
+@property (nonatomic, assign)   NSInteger       cancelledCount;
+@property (nonatomic, assign)   double          throughput;
+@property (nonatomic, assign)   NSTimeInterval  averageLatency;
+@property (nonatomic, assign)   NSTimeInterval  averageWaitTime;
+
+@end
+
+@implementation KYCVerificationEngineStatistics
+
+@end
+
+// MARK: - KYCVerificationEngine
+
+@interface KYCVerificationEngine()
+
+@property (nonatomic, strong)   dispatch_queue_t                                        queue;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, NSMutableArray *>       *pending;
+@property (nonatomic, strong)   NSMutableArray<NSString *>                              *groups;
+@property (nonatomic, assign)   NSUInteger                                              nextGroup;
+@property (nonatomic, strong)   NSMutableSet<KYCVerificationJob *>                      *running;
+@property (nonatomic, copy)     NSString                                                *identifier;
+@property (nonatomic, assign)   NSInteger                                               connectionLimit;
+
+@property (nonatomic, assign)   NSInteger                                               submittedCount;
+@property (nonatomic, assign)   NSInteger                                               peakRunningCount;
+@property (nonatomic, assign)   NSInteger                                               finishedCount;
+@property (nonatomic, assign)   NSInteger                                               failedCount;
+@property (nonatomic, assign)   NSInteger                                               cancelledCount;
+@property (nonatomic, assign)   NSTimeInterval                                          totalLatency;
+@property (nonatomic, assign)   NSTimeInterval                                          totalWaitTime;
+@property (nonatomic, assign)   NSInteger                                               startedCount;
+@property (nonatomic, strong)   NSDate                                                  *firstStartDate;
+
+@end
+
+@implementation KYCVerificationEngine
+
+// MARK: - Life Cycle
+
++ (instancetype)engineWithMaxConcurrent:(NSInteger)maxConcurrent {
+    return [[KYCVerificationEngine alloc] initWithMaxConcurrent:maxConcurrent];
+}
+
+- (instancetype)initWithMaxConcurrent:(NSInteger)maxConcurrent {
+    if (self = [super init]) {
+        self.queue      = dispatch_queue_create("com.thales.kyc.engine", DISPATCH_QUEUE_SERIAL);
+        self.pending    = [NSMutableDictionary new];
+        self.groups     = [NSMutableArray new];
+        self.running    = [NSMutableSet new];
+        self.identifier = [NSUUID UUID].UUIDString;
+        
+        _maxConcurrent  = MAX(maxConcurrent, 1);
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    if (_connectionLimit) {
+        [[KYCURLSessionManager sharedInstance] setConnectionLimit:0 forOwner:_identifier];
+    }
+}
+
+// MARK: - Public API
+
+- (NSInteger)maxConcurrent {
+    __block NSInteger retValue;
+    dispatch_sync(_queue, ^{
+        retValue = self->_maxConcurrent;
+    });
+    
+    return retValue;
+}
+
+- (void)setMaxConcurrent:(NSInteger)maxConcurrent {
+    dispatch_async(_queue, ^{
+        self->_maxConcurrent = MAX(maxConcurrent, 1);
+        [self schedule];
+    });
+}
+
+- (KYCVerificationJob *)submitDocumentFront:(NSData *)docFront
+                               documentBack:(NSData *)docBack
+                                     selfie:(NSData *)selfie
+                                      group:(NSString *)group
+                          completionHandler:(KYCVerificationJobHandler)handler {
+    assert(handler);
+    
+    // Own copy of images. Caller can reuse its buffers right away.
+    KYCVerificationJob *job = [KYCVerificationJob new];
+    job.identifier      = [NSUUID UUID].UUIDString;
+    job.group           = group ?: kDefaultGroup;
+    job.state           = KYCVerificationJobStatePending;
+    job.submitDate      = [NSDate date];
+    job.documentFront   = [docFront copy];
+    job.documentBack    = [docBack copy];
+    job.selfie          = [selfie copy];
+    job.handler         = handler;
+    
+    dispatch_async(_queue, ^{
+        NSMutableArray *queue = self.pending[job.group];
+        if (!queue) {
+            queue = [NSMutableArray new];
+            [self.pending setObject:queue forKey:job.group];
+            [self.groups addObject:job.group];
+        }
+        [queue addObject:job];
+        self.submittedCount++;
+        
+        [self schedule];
+    });
+    
+    return job;
+}
+
+- (BOOL)cancelJob:(KYCVerificationJob *)job {
+    __block BOOL retValue = NO;
+    dispatch_sync(_queue, ^{
+        retValue = [self cancelJobOnQueue:job];
+    });
+    
+    return retValue;
+}
+
+- (void)cancelAll {
+    dispatch_sync(_queue, ^{
+        // Waiting jobs go first, so no new job is started in the released slots.
+        for (NSString *loopGroup in self.groups.copy) {
+            for (KYCVerificationJob *loopJob in [self.pending[loopGroup] copy]) {
+                [self cancelJobOnQueue:loopJob];
+            }
+        }
+        for (KYCVerificationJob *loopJob in self.running.allObjects) {
+            [self cancelJobOnQueue:loopJob];
+        }
+    });
+}
+
+- (KYCVerificationEngineStatistics *)statistics {
+    KYCVerificationEngineStatistics *retValue = [KYCVerificationEngineStatistics new];
+    
+    dispatch_sync(_queue, ^{
+        NSInteger pendingCount = 0;
+        for (NSArray *loopQueue in self.pending.allValues) {
+            pendingCount += loopQueue.count;
+        }
+        
+        NSInteger completedCount    = self.finishedCount + self.failedCount;
+        NSTimeInterval elapsed      = self.firstStartDate ? -[self.firstStartDate timeIntervalSinceNow] : .0;
+        
+        retValue.submittedCount     = self.submittedCount;
+        retValue.pendingCount       = pendingCount;
+        retValue.runningCount       = self.running.count;
+        retValue.peakRunningCount   = self.peakRunningCount;
+        retValue.finishedCount      = self.finishedCount;
+        retValue.failedCount        = self.failedCount;
+        retValue.cancelledCount     = self.cancelledCount;
+        retValue.throughput         = elapsed > .0 ? completedCount / elapsed : .0;
+        retValue.averageLatency     = completedCount ? self.totalLatency / completedCount : .0;
+        retValue.averageWaitTime    = self.startedCount ? self.totalWaitTime / self.startedCount : .0;
+    });
+    
+    return retValue;
+}
+
+- (void)resetStatistics {
+    dispatch_async(_queue, ^{
+        self.submittedCount     = 0;
+        self.peakRunningCount   = self.running.count;
+        self.finishedCount      = 0;
+        self.failedCount        = 0;
+        self.cancelledCount     = 0;
+        self.totalLatency       = .0;
+        self.totalWaitTime      = .0;
+        self.startedCount       = 0;
+        self.firstStartDate     = self.running.count ? [NSDate date] : nil;
+    });
+    
+    // Connection reuse is measured over the same period as the job counters.
+    [[KYCURLSessionManager sharedInstance] resetMetrics];
+}
+
+// MARK: - Private Helpers
+
+/**
+ Starts waiting jobs while there is a free slot. Groups are served round-robin. Called on engine queue.
+ */
+- (void)schedule {
+    // Connections are needed before the first request of started jobs is sent.
+    [self updateConnectionLimit];
+    
+    while ((NSInteger)_running.count < _maxConcurrent && _groups.count) {
+        _nextGroup %= _groups.count;
+        
+        NSString            *group  = _groups[_nextGroup];
+        NSMutableArray      *queue  = _pending[group];
+        KYCVerificationJob  *job    = queue.firstObject;
+        [queue removeObjectAtIndex:0];
+        
+        // Drop empty group. Next group moves to the current index.
+        if (!queue.count) {
+            [_pending removeObjectForKey:group];
+            [_groups removeObjectAtIndex:_nextGroup];
+        } else {
+            _nextGroup++;
+        }
+        
+        [self startJob:job];
+    }
+    
+    [self updateConnectionLimit];
+}
+
+/**
+ Starts the verification of the job. Called on engine queue.
+ 
+ @param job Job to be started.
+ */
+- (void)startJob:(KYCVerificationJob *)job {
+    job.state       = KYCVerificationJobStateRunning;
+    job.startDate   = [NSDate date];
+    
+    [_running addObject:job];
+    
+    self.peakRunningCount   = MAX(_peakRunningCount, (NSInteger)_running.count);
+    self.totalWaitTime      += [job.startDate timeIntervalSinceDate:job.submitDate];
+    self.startedCount++;
+    if (!_firstStartDate) {
+        self.firstStartDate = job.startDate;
+    }
+    
+    job.session = [KYCCommunication verifyDocumentFront:job.documentFront
+                                           documentBack:job.documentBack
+                                                 selfie:job.selfie
+                                      completionHandler:^(KYCResponse *response, NSString *error) {
+        dispatch_async(self.queue, ^{
+            [self completeJob:job response:response error:error];
+        });
+    }];
+}
+
+/**
+ Handles the end of verification and releases the slot. Called on engine queue.
+ 
+ @param job Job which was running.
+ @param response Verification result.
+ @param error Verification error.
+ */
+- (void)completeJob:(KYCVerificationJob *)job response:(KYCResponse *)response error:(NSString *)error {
+    // Result arrived just before the job was cancelled. Cancellation was already reported.
+    if (job.state != KYCVerificationJobStateRunning) {
+        return;
+    }
+    
+    [_running removeObject:job];
+    
+    job.response    = response;
+    job.error       = error;
+    if (response) {
+        job.state = KYCVerificationJobStateFinished;
+        self.finishedCount++;
+    } else {
+        job.state = KYCVerificationJobStateFailed;
+        self.failedCount++;
+    }
+    [self finishJob:job];
+    self.totalLatency += [job.finishDate timeIntervalSinceDate:job.submitDate];
+    
+    [self schedule];
+}
+
+/**
+ Cancels the job. Called on engine queue.
+ 
+ @param job Job to be cancelled.
+ 
+ @return {@code True} if the job was cancelled, {@code false} if it was already completed.
+ */
+- (BOOL)cancelJobOnQueue:(KYCVerificationJob *)job {
+    if (job.state == KYCVerificationJobStatePending) {
+        NSMutableArray *queue = _pending[job.group];
+        [queue removeObject:job];
+        if (queue && !queue.count) {
+            NSUInteger index = [_groups indexOfObject:job.group];
+            [_pending removeObjectForKey:job.group];
+            [_groups removeObjectAtIndex:index];
+            if (index < _nextGroup) {
+                _nextGroup--;
+            }
+        }
+    } else if (job.state == KYCVerificationJobStateRunning) {
+        // Requests are aborted right away, so the slot can be used by next job.
+        [job.session cancel];
+        [_running removeObject:job];
+    } else {
+        return NO;
+    }
+    
+    job.state = KYCVerificationJobStateCancelled;
+    job.error = @"Verification was cancelled.";
+    self.cancelledCount++;
+    [self finishJob:job];
+    [self schedule];
+    
+    return YES;
+}
+
+/**
+ Releases job images and notifies the caller. Called on engine queue.
+ 
+ @param job Completed job.
+ */
+- (void)finishJob:(KYCVerificationJob *)job {
+    job.finishDate      = [NSDate date];
+    job.session         = nil;
+    job.documentFront   = nil;
+    job.documentBack    = nil;
+    job.selfie          = nil;
+    
+    KYCVerificationJobHandler handler = job.handler;
+    job.handler = nil;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        handler(job);
+    });
+}
+
+/**
+ All jobs share one URL session. Let it open as many connections as there are verifications in flight, but only
+ while the engine has some work. Idle engine returns the session to its own limit. Called on engine queue.
+ */
+- (void)updateConnectionLimit {
+    NSInteger limit = _running.count || _groups.count ? _maxConcurrent : 0;
+    if (limit != _connectionLimit) {
+        self.connectionLimit = limit;
+        [[KYCURLSessionManager sharedInstance] setConnectionLimit:limit forOwner:_identifier];
+    }
+}
+
+@end
@@ -29,15 +29,17 @@ Please make sure to review our IdCloud documentation, including security guideli
 @property (nonatomic, copy)     NSString    *birthDate;
 @property (nonatomic, copy)     NSString    *documentType;
 @property (nonatomic, copy)     NSString    *surname;
-@property (nonatomic, strong)   NSData      *portrait;
-@property (nonatomic, strong)   NSData      *imageWhiteBack;
-@property (nonatomic, strong)   NSData      *imageWhiteFront;
 @property (nonatomic, copy)     NSString    *result;
 @property (nonatomic, copy)     NSString    *gender;
 @property (nonatomic, copy)     NSString    *documentNumber;
 @property (nonatomic, copy)     NSString    *expiryDate;
 @property (nonatomic, copy)     NSString    *nationality;
 
+// Images are decoded from base64 on first access.
+@property (nonatomic, strong, readonly) NSData  *portrait;
+@property (nonatomic, strong, readonly) NSData  *imageWhiteBack;
+@property (nonatomic, strong, readonly) NSData  *imageWhiteFront;
+
 @property (nonatomic, assign)   NSInteger   numberImagesProcessed;
 @property (nonatomic, assign)   NSInteger   totalVerifications;
 
@@ -21,7 +21,15 @@ Please make sure to review our IdCloud documentation, including security guideli
 */
 
 #import "KYCDocument.h"
-#import "KYCCommunication.h"
+#import "KYCLazyImage.h"
+
+@interface KYCDocument()
+
+@property (nonatomic, strong)   KYCLazyImage    *lazyPortrait;
+@property (nonatomic, strong)   KYCLazyImage    *lazyImageWhiteBack;
+@property (nonatomic, strong)   KYCLazyImage    *lazyImageWhiteFront;
+
+@end
 
 @implementation KYCDocument
 
@@ -36,10 +44,12 @@ Please make sure to review our IdCloud documentation, including security guideli
         self.birthDate              = response[@"birthDate"];
         self.documentType           = response[@"documentType"];
         self.surname                = response[@"surname"];
-        self.portrait               = [IdCloudHelper imageFromBase64:response[@"portrait"]];
+        self.lazyPortrait           = [KYCLazyImage imageWithJSONValue:response[@"portrait"]];
         self.totalVerifications     = [response[@"totalVerifications"] integerValue];
-        self.imageWhiteBack         = [IdCloudHelper imageFromBase64:response[@"imageWhiteBack"]];
-        self.imageWhiteFront        = [IdCloudHelper imageFromBase64:response[@"imageWhiteFront"]];
+#if !CFG_IDCLOUD_DROP_ECHOED_IMAGES
+        self.lazyImageWhiteBack     = [KYCLazyImage imageWithJSONValue:response[@"imageWhiteBack"]];
+        self.lazyImageWhiteFront    = [KYCLazyImage imageWithJSONValue:response[@"imageWhiteFront"]];
+#endif
         self.result                 = response[@"result"];
         self.numberImagesProcessed  = [response[@"numberImagesProcessed"] integerValue];
         self.gender                 = response[@"gender"];
@@ -58,4 +68,18 @@ Please make sure to review our IdCloud documentation, including security guideli
     return self;
 }
 
+// MARK: - Public API
+
+- (NSData *)portrait {
+    return _lazyPortrait.data;
+}
+
+- (NSData *)imageWhiteBack {
+    return _lazyImageWhiteBack.data;
+}
+
+- (NSData *)imageWhiteFront {
+    return _lazyImageWhiteFront.data;
+}
+
 @end
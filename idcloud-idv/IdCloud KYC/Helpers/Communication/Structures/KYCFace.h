@@ -20,12 +20,12 @@ IMPORTANT: This source code is intended to serve training information purposes o
 Please make sure to review our IdCloud documentation, including security guidelines.
 */
 
-#import <UIKit/UIKit.h>
+#import <Foundation/Foundation.h>
 
 @interface KYCFace : NSObject
 
 @property (nonatomic, copy)     NSString    *result;
-@property (nonatomic, strong)   NSData      *image;
+@property (nonatomic, strong, readonly) NSData *image;
 @property (nonatomic, assign)   NSInteger   score;
 
 + (instancetype)createWithJSON:(NSDictionary *)response;
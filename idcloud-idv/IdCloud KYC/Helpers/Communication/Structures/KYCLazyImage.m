@@ -0,0 +1,63 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCLazyImage.h"
+
+@interface KYCLazyImage()
+
+@property (nonatomic, strong) NSString  *base64;
+@property (nonatomic, strong) NSData    *decoded;
+
+@end
+
+@implementation KYCLazyImage
+
+// MARK: - Life Cycle
+
++ (instancetype)imageWithJSONValue:(id)value {
+    if ((![value isKindOfClass:[NSString class]] && ![value isKindOfClass:[NSData class]]) || ![value length]) {
+        return nil;
+    }
+    
+    KYCLazyImage *retValue = [KYCLazyImage new];
+    if ([value isKindOfClass:[NSData class]]) {
+        retValue.decoded    = value;
+    } else {
+        retValue.base64     = value;
+    }
+    return retValue;
+}
+
+// MARK: - Public API
+
+- (NSData *)data {
+    @synchronized (self) {
+        if (_base64) {
+            self.decoded    = [[NSData alloc] initWithBase64EncodedString:_base64 options:0];
+            self.base64     = nil;
+        }
+        
+        return _decoded;
+    }
+}
+
+@end
@@ -24,12 +24,69 @@
 // IdCloud demo endpoint url.
 #define CFG_IDCLOUD_BASE_URL @""
 
-// Number of attempts before throwing timeout error.
-#define CFG_IDCLOUD_NUMBER_OF_RETRIES 30
+// Number of seconds to wait for verification result before throwing timeout error.
+#define CFG_IDCLOUD_POLL_DEADLINE_SEC 60
 
-// Number of seconds between each verification attempt.
+// Number of seconds the whole verification including upload can take. Running requests are aborted afterwards.
+#define CFG_IDCLOUD_VERIFICATION_DEADLINE_SEC 120
+
+// Number of seconds between each verification attempt. Upper limit for adaptive polling.
 #define CFG_IDCLOUD_RETRY_DELAY_SEC 2
 
+// Poll quickly at the beginning and slow down over time instead of fixed delay between attempts.
+#define CFG_IDCLOUD_ADAPTIVE_POLLING 1
+
+// Wait for verification result on one long lived connection (server-sent events or long-poll) instead of polling.
+// Polling is still used as fallback when server closes the connection without result.
+#define CFG_IDCLOUD_RESULT_STREAM 0
+
+// Maximum number of seconds server can hold the result connection open.
+#define CFG_IDCLOUD_RESULT_STREAM_TIMEOUT_SEC 30
+
+// Stream verification body and encode images on the fly instead of building whole JSON in memory.
+#define CFG_IDCLOUD_STREAMED_UPLOAD 1
+
+// Compress verification body with gzip once the backend announces support for it. Opt-in.
+#define CFG_IDCLOUD_COMPRESSED_UPLOAD 0
+
+// Crop the selfie to the detected face with some margin around it instead of sending the whole camera frame.
+#define CFG_IDCLOUD_PORTRAIT_CROP 1
+
+// Do not keep document and selfie images echoed back in verification result. Application shows only extracted portrait.
+#define CFG_IDCLOUD_DROP_ECHOED_IMAGES 1
+
+// Trace duration of capture, image processing and verification steps. Spans are visible in Instruments as signposts
+// and every finished verification is exported as Chrome trace JSON to Documents/kyc-trace.json. Opt-in.
+#define CFG_IDCLOUD_TRACE 0
+
+// Store verification on disk before sending and submit it automatically once connection is available.
+// Document and selfie images stay on disk protected only until first unlock. Enable only if that is acceptable.
+#define CFG_IDCLOUD_SUBMISSION_QUEUE 0
+
+// Maximum disk space in megabytes used by verifications waiting for submission.
+#define CFG_IDCLOUD_SUBMISSION_QUEUE_MAX_MB 50
+
+// Replace verification backend with in-process emulation. Whole flow runs offline, useful for demos and load testing.
+#define CFG_IDCLOUD_LOOPBACK 0
+
+// Seed of emulated backend. Same seed gives same sequence of latencies and failures.
+#define CFG_IDCLOUD_LOOPBACK_SEED 1
+
+// Run self checks of the verification flow against emulated backend on start. Failed check stops debug build.
+#define CFG_IDCLOUD_LOOPBACK_CHECKS 0
+
+// Store SDK callbacks and captured document of each scan to Documents/capture-recordings. Opt-in.
+#define CFG_IDCLOUD_CAPTURE_RECORD 0
+
+// Name of recording in Documents/capture-recordings to replay instead of live camera. Empty to use camera.
+#define CFG_IDCLOUD_CAPTURE_REPLAY @""
+
+// Replay speed. Recorded timing is divided by this value.
+#define CFG_IDCLOUD_CAPTURE_REPLAY_SPEED 10
+
+// Initialize document capture SDK and face license on screens before the scanners, so camera starts sooner.
+#define CFG_IDCLOUD_CAPTURE_WARMUP 1
+
 // IDV Face capture product key.
 #define CFG_PRODUCT_KEY @""
 
@@ -0,0 +1,172 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+// Types of recorded capture events.
+#define kCaptureEventWarnings   @"warnings"
+#define kCaptureEventScreen     @"screen"
+#define kCaptureEventSuccess    @"success"
+
+// Error codes of failed replay.
+typedef NS_ENUM(NSInteger, KYCCaptureReplayError) {
+    KYCCaptureReplayErrorStepMismatch = 1    // Controller did not display recorded tutorial step.
+};
+
+@class KYCCaptureReplay;
+
+typedef void (^KYCCaptureReplayCompletion)(KYCCaptureReplay *replay, NSError *error);
+
+/**
+ Controller which can be driven by recorded capture session instead of live SDK.
+ */
+@protocol KYCCaptureReplayTarget <NSObject>
+
+/**
+ Current tutorial step. Compared with step recorded after each screen change.
+ */
+@property (nonatomic, assign, readonly) NSInteger step;
+
+/**
+ Same as {@code DetectionWarningDelegate}.
+
+ @param warnings Recorded detection warnings.
+ */
+- (void)detectionWarnings:(DetectionWarning)warnings;
+
+/**
+ Same as {@code CaptureDelegate}.
+
+ @param screen Recorded capture screen.
+ */
+- (void)onScreenChanged:(CaptureScreen)screen;
+
+/**
+ Recorded capture finished. Replaces {@code onSuccess:} of {@code CaptureDelegate} since capture result can't be created
+ outside of SDK.
+
+ @param side1 Recorded front side.
+ @param side2 Recorded back side or {@code nil} for single sided document.
+ */
+- (void)onReplaySuccess:(NSData *)side1 side:(NSData *)side2;
+
+@end
+
+/**
+ Stores sequence of SDK capture callbacks together with captured images to the directory, so the same session can be
+ replayed later without camera and document.
+
+ Directory contains {@code events.json} with time offset of each event and {@code side1} and {@code side2} images.
+ */
+@interface KYCCaptureRecorder : NSObject
+
+/**
+ Creates a new {@code KYCCaptureRecorder} instance. Time of events is measured from this moment.
+
+ @param url Directory where recording will be stored. Created once recording is finished.
+
+ @return Instance of {@code KYCCaptureRecorder}.
+ */
++ (instancetype)recorderWithURL:(NSURL *)url;
+
+/**
+ Records detection warnings. Can be called from any thread.
+
+ @param warnings Warnings reported by SDK.
+ */
+- (void)recordWarnings:(DetectionWarning)warnings;
+
+/**
+ Records screen change together with tutorial step displayed after the change was handled.
+
+ @param screen Screen reported by SDK.
+ @param step Current tutorial step.
+ */
+- (void)recordScreen:(CaptureScreen)screen step:(NSInteger)step;
+
+/**
+ Records successful capture and writes whole recording to disk.
+
+ @param side1 Captured front side.
+ @param side2 Captured back side or {@code nil}.
+ @param error Write error.
+
+ @return {@code YES} if recording was stored, otherwise {@code NO}.
+ */
+- (BOOL)finishWithSide1:(NSData *)side1 side2:(NSData *)side2 error:(NSError **)error;
+
+@end
+
+/**
+ Feeds recorded capture session through the delegate methods of the scanner.
+
+ Events are delivered on the main thread with recorded timing divided by speed. After each event the main queue is
+ drained, so measured time includes work the controller dispatched asynchronously. Tutorial step is checked after
+ every screen change and the first mismatch fails the replay. Each callback is traced as a {@code captureReplay.<type>} span and totals are added to
+ {@code captureReplay} span.
+ */
+@interface KYCCaptureReplay : NSObject
+
+/**
+ Playback speed. 1 replays in recorded time. Default value is 1.
+ */
+@property (nonatomic, assign)           double          speed;
+
+/**
+ Number of events delivered so far.
+ */
+@property (nonatomic, assign, readonly) NSUInteger      eventCount;
+
+/**
+ Main thread time spent in all callbacks and maximum of single callback.
+ */
+@property (nonatomic, assign, readonly) NSTimeInterval  mainThreadTime;
+@property (nonatomic, assign, readonly) NSTimeInterval  maxMainThreadTime;
+
+/**
+ Default location of recordings. Documents/capture-recordings.
+
+ @return Directory URL.
+ */
++ (NSURL *)recordingsURL;
+
+/**
+ Creates a new {@code KYCCaptureReplay} instance.
+
+ @param url Directory created by {@code KYCCaptureRecorder}.
+
+ @return Instance of {@code KYCCaptureReplay} or {@code nil} if there is no valid recording.
+ */
++ (instancetype)replayWithURL:(NSURL *)url;
+
+/**
+ Starts delivering recorded events. Must be called from the main thread.
+
+ @param target Controller to drive. Weak reference.
+ @param completion Called on the main thread once all events were delivered or with error once controller did not
+ follow the recording. Not called when cancelled.
+ */
+- (void)startWithTarget:(id<KYCCaptureReplayTarget>)target completion:(KYCCaptureReplayCompletion)completion;
+
+/**
+ Stops delivering events.
+ */
+- (void)cancel;
+
+@end
@@ -0,0 +1,269 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCCaptureReplay.h"
+#import "KYCTrace.h"
+
+#define kRecordingEventsFile    @"events.json"
+#define kRecordingSide1File     @"side1"
+#define kRecordingSide2File     @"side2"
+#define kRecordingsDirectory    @"capture-recordings"
+
+#define kEventKeyTime           @"time"
+#define kEventKeyType           @"type"
+#define kEventKeyValue          @"value"
+#define kEventKeyStep           @"step"
+
+#define kErrorDomain            @"KYCCaptureReplay"
+
+// MARK: - KYCCaptureRecorder
+
+@interface KYCCaptureRecorder()
+
+@property (nonatomic, strong) NSURL                             *url;
+@property (nonatomic, assign) CFTimeInterval                    startTime;
+// Guarded by self. Warnings are reported from SDK thread.
+@property (nonatomic, strong) NSMutableArray<NSDictionary *>    *events;
+
+@end
+
+@implementation KYCCaptureRecorder
+
+// MARK: - Life Cycle
+
++ (instancetype)recorderWithURL:(NSURL *)url {
+    return [[KYCCaptureRecorder alloc] initWithURL:url];
+}
+
+- (instancetype)initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        _url        = url;
+        _startTime  = CACurrentMediaTime();
+        _events     = [NSMutableArray new];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (void)recordWarnings:(DetectionWarning)warnings {
+    [self recordEvent:kCaptureEventWarnings value:warnings step:nil];
+}
+
+- (void)recordScreen:(CaptureScreen)screen step:(NSInteger)step {
+    [self recordEvent:kCaptureEventScreen value:screen step:@(step)];
+}
+
+- (BOOL)finishWithSide1:(NSData *)side1 side2:(NSData *)side2 error:(NSError **)error {
+    [self recordEvent:kCaptureEventSuccess value:0 step:nil];
+    
+    NSData *events;
+    @synchronized (self) {
+        events = [NSJSONSerialization dataWithJSONObject:_events options:NSJSONWritingPrettyPrinted error:error];
+    }
+    
+    return events &&
+    [[NSFileManager defaultManager] createDirectoryAtURL:_url withIntermediateDirectories:YES attributes:nil error:error] &&
+    [side1 writeToURL:[_url URLByAppendingPathComponent:kRecordingSide1File] options:NSDataWritingAtomic error:error] &&
+    (!side2 || [side2 writeToURL:[_url URLByAppendingPathComponent:kRecordingSide2File] options:NSDataWritingAtomic error:error]) &&
+    [events writeToURL:[_url URLByAppendingPathComponent:kRecordingEventsFile] options:NSDataWritingAtomic error:error];
+}
+
+// MARK: - Private Helpers
+
+- (void)recordEvent:(NSString *)type value:(NSInteger)value step:(NSNumber *)step {
+    NSMutableDictionary *event = [NSMutableDictionary dictionaryWithDictionary:@{kEventKeyTime: @(CACurrentMediaTime() - _startTime),
+                                                                                 kEventKeyType: type,
+                                                                                 kEventKeyValue: @(value)}];
+    if (step) {
+        event[kEventKeyStep] = step;
+    }
+    
+    @synchronized (self) {
+        [_events addObject:event];
+    }
+}
+
+@end
+
+// MARK: - KYCCaptureReplay
+
+@interface KYCCaptureReplay()
+
+@property (nonatomic, strong) NSURL                                       *url;
+@property (nonatomic, strong) NSArray<NSDictionary *>                     *events;
+@property (nonatomic, weak)   id<KYCCaptureReplayTarget>                  target;
+@property (nonatomic, copy)   KYCCaptureReplayCompletion                  completion;
+@property (nonatomic, assign) CFTimeInterval                              startTime;
+@property (nonatomic, assign) BOOL                                        cancelled;
+@property (nonatomic, strong) KYCTraceSpan                                *span;
+// Main thread time and number of callbacks per event type.
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *typeTimes;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *typeCounts;
+
+@end
+
+@implementation KYCCaptureReplay
+
++ (NSURL *)recordingsURL {
+    NSURL *documents = [[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask].firstObject;
+    return [documents URLByAppendingPathComponent:kRecordingsDirectory];
+}
+
+// MARK: - Life Cycle
+
++ (instancetype)replayWithURL:(NSURL *)url {
+    NSData  *data   = [NSData dataWithContentsOfURL:[url URLByAppendingPathComponent:kRecordingEventsFile]];
+    id      events  = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    if (![events isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    
+    return [[KYCCaptureReplay alloc] initWithURL:url events:events];
+}
+
+- (instancetype)initWithURL:(NSURL *)url events:(NSArray<NSDictionary *> *)events {
+    if (self = [super init]) {
+        _url        = url;
+        _events     = events;
+        _speed      = 1.;
+        _typeTimes  = [NSMutableDictionary new];
+        _typeCounts = [NSMutableDictionary new];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (void)startWithTarget:(id<KYCCaptureReplayTarget>)target completion:(KYCCaptureReplayCompletion)completion {
+    self.target     = target;
+    self.completion = completion;
+    self.startTime  = CACurrentMediaTime();
+    self.span       = [KYCTrace beginSpanWithName:@"captureReplay" category:kTraceCategoryCapture];
+    
+    [self scheduleEventAtIndex:0];
+}
+
+- (void)cancel {
+    self.cancelled = YES;
+    [_span end];
+    self.span = nil;
+}
+
+// MARK: - Private Helpers
+
+- (void)scheduleEventAtIndex:(NSUInteger)index {
+    if (_cancelled) {
+        return;
+    }
+    
+    if (index >= _events.count || !_target) {
+        [self finishWithError:nil];
+        return;
+    }
+    
+    // Keep recorded timing. Slow callbacks delay following events, they are never delivered in parallel.
+    NSTimeInterval  time    = [_events[index][kEventKeyTime] doubleValue] / MAX(_speed, .001);
+    NSTimeInterval  delay   = MAX(_startTime + time - CACurrentMediaTime(), .0);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [self deliverEventAtIndex:index];
+    });
+}
+
+- (void)deliverEventAtIndex:(NSUInteger)index {
+    id<KYCCaptureReplayTarget> target = _target;
+    if (_cancelled || !target) {
+        return;
+    }
+    
+    NSDictionary    *event  = _events[index];
+    NSString        *type   = event[kEventKeyType];
+    NSInteger       value   = [event[kEventKeyValue] integerValue];
+    
+    KYCTraceSpan    *span   = [KYCTrace beginSpanWithName:[@"captureReplay." stringByAppendingString:type]
+                                                 category:kTraceCategoryCapture];
+    CFTimeInterval  begin   = CACurrentMediaTime();
+    if ([type isEqualToString:kCaptureEventWarnings]) {
+        [target detectionWarnings:(DetectionWarning)value];
+    } else if ([type isEqualToString:kCaptureEventScreen]) {
+        [target onScreenChanged:(CaptureScreen)value];
+    } else if ([type isEqualToString:kCaptureEventSuccess]) {
+        // Completion would be too late. Controller leaves the scanner right away.
+        [self finishWithError:nil];
+        NSData *side1 = [NSData dataWithContentsOfURL:[_url URLByAppendingPathComponent:kRecordingSide1File]];
+        NSData *side2 = [NSData dataWithContentsOfURL:[_url URLByAppendingPathComponent:kRecordingSide2File]];
+        [target onReplaySuccess:side1 side:side2];
+        [span end];
+        return;
+    }
+    
+    // Work dispatched by the callback is queued before this block.
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSTimeInterval duration = CACurrentMediaTime() - begin;
+        [span end];
+        
+        self.eventCount++;
+        self.mainThreadTime     += duration;
+        self.maxMainThreadTime  = MAX(self.maxMainThreadTime, duration);
+        self.typeTimes[type]    = @(self.typeTimes[type].doubleValue + duration);
+        self.typeCounts[type]   = @(self.typeCounts[type].integerValue + 1);
+        
+        // Step is recorded only for screen changes. Controller went a different way than recorded one. Following
+        // events would not make sense any more.
+        NSNumber *step = event[kEventKeyStep];
+        if (step && step.integerValue != target.step) {
+            NSString *description = [NSString stringWithFormat:@"Event %lu: expected step %ld, displayed step %ld.",
+                                     (unsigned long)index, (long)step.integerValue, (long)target.step];
+            [self finishWithError:[NSError errorWithDomain:kErrorDomain
+                                                      code:KYCCaptureReplayErrorStepMismatch
+                                                  userInfo:@{NSLocalizedDescriptionKey: description}]];
+            return;
+        }
+        
+        [self scheduleEventAtIndex:index + 1];
+    });
+}
+
+- (void)finishWithError:(NSError *)error {
+    if (_cancelled) {
+        return;
+    }
+    self.cancelled = YES;
+    
+    [_span setArgument:@(_eventCount) forKey:@"events"];
+    [_span setArgument:error.localizedDescription forKey:@"error"];
+    [_span setArgument:@(_mainThreadTime * 1000.) forKey:@"mainThreadMs"];
+    [_span setArgument:@(_maxMainThreadTime * 1000.) forKey:@"maxMainThreadMs"];
+    for (NSString *loopType in _typeCounts) {
+        [_span setArgument:_typeCounts[loopType] forKey:[loopType stringByAppendingString:@"Count"]];
+        [_span setArgument:@(_typeTimes[loopType].doubleValue * 1000.) forKey:[loopType stringByAppendingString:@"Ms"]];
+    }
+    [_span end];
+    self.span = nil;
+    
+    if (_completion) {
+        _completion(self, error);
+    }
+}
+
+@end
@@ -0,0 +1,170 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+/**
+ Completion handler of asynchronous scaling.
+
+ @param data Encoded image or {@code nil} if encoding failed.
+ */
+typedef void (^KYCImageScalerCompletion)(NSData *data);
+
+/**
+ Checks whether encoded image is still good enough for further processing.
+
+ @param data Encoded image.
+
+ @return {@code True} if image can be used, {@code false} if higher quality is needed.
+ */
+typedef BOOL (^KYCImageScalerValidator)(NSData *data);
+
+/**
+ Downscales and encodes images with ImageIO.
+
+ Scaling is done by the image decoder or encoder itself, so there is no intermediate bitmap context with scaled copy
+ of the image and no work is done on the main thread.
+ */
+@interface KYCImageScaler : NSObject
+
+/**
+ Scales decoded image to given width and encodes it as JPEG in one step.
+
+ @param image Source image.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param quality JPEG compression quality in range 0 - 1.
+
+ @return Encoded image or {@code nil} if encoding failed.
+ */
++ (NSData *)jpegFromImage:(UIImage *)image
+                 maxWidth:(CGFloat)maxWidth
+                  quality:(CGFloat)quality;
+
+/**
+ Scales decoded image to given width and encodes it in given format.
+
+ @param image Source image.
+ @param type Uniform type identifier of the output format. E.g. {@code public.jpeg} or {@code public.heic}.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param quality Compression quality in range 0 - 1. Ignored by lossless formats.
+
+ @return Encoded image or {@code nil} if encoding failed or format is not supported.
+ */
++ (NSData *)encodeImage:(UIImage *)image
+                   type:(NSString *)type
+               maxWidth:(CGFloat)maxWidth
+                quality:(CGFloat)quality;
+
+/**
+ Checks whether ImageIO on current device can encode given format. HEIC is not available on older hardware.
+
+ @param type Uniform type identifier of the output format.
+
+ @return {@code True} if format can be encoded.
+ */
++ (BOOL)isTypeSupported:(NSString *)type;
+
+/**
+ Crops image to the region of interest extended by relative margin on every side. Region is clamped to the image.
+
+ @param image Source image.
+ @param rect Region of interest in image coordinates. Empty rect keeps whole image.
+ @param margin Extension of each side relative to the region size. E.g. {@code .5} for half of width / height.
+
+ @return Cropped image or the source image if there is nothing to crop.
+ */
++ (UIImage *)cropImage:(UIImage *)image toRect:(CGRect)rect margin:(CGFloat)margin;
+
+/**
+ Scales already encoded image and encodes it again as JPEG. Decoder produces only the scaled bitmap, full resolution
+ image is never decoded.
+
+ @param data Source encoded image.
+ @param maxPixelSize Maximum width or height in pixels.
+ @param quality JPEG compression quality in range 0 - 1.
+
+ @return Encoded image or {@code nil} if data are not a valid image.
+ */
++ (NSData *)jpegFromData:(NSData *)data
+            maxPixelSize:(CGFloat)maxPixelSize
+                 quality:(CGFloat)quality;
+
+/**
+ Scales decoded image to given width and encodes it as JPEG with the highest quality which fits the byte budget.
+
+ Quality is found by binary search. If the validator rejects the result, quality is raised step by step even over
+ the budget, because image which can't be recognized is useless regardless of its size.
+
+ @param image Source image.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param byteBudget Maximum size of encoded image in bytes. {@code 0} means maximum quality without limit.
+ @param validator Optional check of the encoded image.
+
+ @return Encoded image or {@code nil} if encoding failed.
+ */
++ (NSData *)jpegFromImage:(UIImage *)image
+                 maxWidth:(CGFloat)maxWidth
+               byteBudget:(NSUInteger)byteBudget
+                validator:(KYCImageScalerValidator)validator;
+
+/**
+ Asynchronous variant of {@code jpegFromImage:maxWidth:byteBudget:validator:}. Work is done on background queue.
+
+ @param image Source image.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param byteBudget Maximum size of encoded image in bytes. {@code 0} means maximum quality without limit.
+ @param validator Optional check of the encoded image. Called on background queue.
+ @param completion Callback. Called on main thread.
+ */
++ (void)jpegFromImage:(UIImage *)image
+             maxWidth:(CGFloat)maxWidth
+           byteBudget:(NSUInteger)byteBudget
+            validator:(KYCImageScalerValidator)validator
+           completion:(KYCImageScalerCompletion)completion;
+
+/**
+ Asynchronous variant of {@code jpegFromImage:maxWidth:quality:}. Work is done on background queue.
+
+ @param image Source image.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param quality JPEG compression quality in range 0 - 1.
+ @param completion Callback. Called on main thread.
+ */
++ (void)jpegFromImage:(UIImage *)image
+             maxWidth:(CGFloat)maxWidth
+              quality:(CGFloat)quality
+           completion:(KYCImageScalerCompletion)completion;
+
+/**
+ Asynchronous variant of {@code encodeImage:type:maxWidth:quality:}. Work is done on background queue.
+
+ @param image Source image.
+ @param type Uniform type identifier of the output format.
+ @param maxWidth Maximum width in pixels. Image is not upscaled. {@code 0} keeps original size.
+ @param quality Compression quality in range 0 - 1.
+ @param completion Callback. Called on main thread.
+ */
++ (void)encodeImage:(UIImage *)image
+               type:(NSString *)type
+           maxWidth:(CGFloat)maxWidth
+            quality:(CGFloat)quality
+         completion:(KYCImageScalerCompletion)completion;
+
+@end
@@ -0,0 +1,319 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCImageScaler.h"
+#import <ImageIO/ImageIO.h>
+#import <MobileCoreServices/MobileCoreServices.h>
+
+// Lowest quality tried by the ladder. Below this JPEG artifacts start to break text recognition.
+#define kQualityMin         .3f
+
+// Number of binary search steps. Quality resolution is (1 - kQualityMin) / 2^steps.
+#define kQualitySearchSteps 5
+
+// Quality increment used when validator rejects the image.
+#define kQualityStep        .1f
+
+@implementation KYCImageScaler
+
+// MARK: - Public API
+
++ (NSData *)jpegFromImage:(UIImage *)image
+                 maxWidth:(CGFloat)maxWidth
+                  quality:(CGFloat)quality {
+    return [KYCImageScaler encodeImage:image type:(__bridge NSString *)kUTTypeJPEG maxWidth:maxWidth quality:quality];
+}
+
++ (NSData *)encodeImage:(UIImage *)image
+                   type:(NSString *)type
+               maxWidth:(CGFloat)maxWidth
+                quality:(CGFloat)quality {
+    CGImageRef cgImage = image.CGImage;
+    if (!cgImage) {
+        return nil;
+    }
+    
+    // Encoder limits the longer side. Convert requested width to it, so result is the same as scaling by width.
+    CGFloat width           = CGImageGetWidth(cgImage);
+    CGFloat height          = CGImageGetHeight(cgImage);
+    BOOL    rotated         = [KYCImageScaler isRotated:image.imageOrientation];
+    CGFloat visibleWidth    = rotated ? height : width;
+    CGFloat maxPixelSize    = .0;
+    if (maxWidth > .0 && visibleWidth > maxWidth) {
+        maxPixelSize = floor(maxWidth * MAX(width, height) / visibleWidth);
+    }
+    
+    return [KYCImageScaler encodeCGImage:cgImage
+                                    type:type
+                             orientation:[KYCImageScaler propertyOrientation:image.imageOrientation]
+                            maxPixelSize:maxPixelSize
+                                 quality:quality];
+}
+
++ (BOOL)isTypeSupported:(NSString *)type {
+    NSArray *supported = CFBridgingRelease(CGImageDestinationCopyTypeIdentifiers());
+    return [supported containsObject:type];
+}
+
++ (UIImage *)cropImage:(UIImage *)image toRect:(CGRect)rect margin:(CGFloat)margin {
+    // Nothing reasonable to crop to. Keep whole image.
+    CGRect bounds = CGRectMake(.0f, .0f, image.size.width, image.size.height);
+    if (CGRectIsNull(rect) || CGRectIsInfinite(rect) || CGRectIsEmpty(rect)) {
+        return image;
+    }
+    
+    rect = CGRectIntegral(CGRectIntersection(CGRectInset(rect, -rect.size.width * margin, -rect.size.height * margin), bounds));
+    if (CGRectIsEmpty(rect) || CGRectEqualToRect(rect, bounds)) {
+        return image;
+    }
+    
+    // Renderer applies image orientation, so rect is always in the coordinates of the displayed image.
+    // Only the cropped area is rasterized.
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat preferredFormat];
+    format.scale    = image.scale;
+    format.opaque   = YES;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:rect.size format:format];
+    return [renderer imageWithActions:^(UIGraphicsImageRendererContext *context) {
+        [image drawAtPoint:CGPointMake(-rect.origin.x, -rect.origin.y)];
+    }];
+}
+
++ (NSData *)jpegFromImage:(UIImage *)image
+                 maxWidth:(CGFloat)maxWidth
+               byteBudget:(NSUInteger)byteBudget
+                validator:(KYCImageScalerValidator)validator {
+    // Scaling is done only once together with the best possible quality. That's also the final result if it fits.
+    NSData *retValue = [KYCImageScaler jpegFromImage:image maxWidth:maxWidth quality:1.f];
+    if (!retValue || !byteBudget || retValue.length <= byteBudget) {
+        return retValue;
+    }
+    
+    // Following encodes start from already scaled bitmap.
+    CGImagePropertyOrientation  orientation = [KYCImageScaler propertyOrientation:image.imageOrientation];
+    CGImageSourceRef            source      = CGImageSourceCreateWithData((__bridge CFDataRef)retValue, NULL);
+    CGImageRef                  scaled      = source ? CGImageSourceCreateImageAtIndex(source, 0, NULL) : NULL;
+    if (source) {
+        CFRelease(source);
+    }
+    if (!scaled) {
+        return retValue;
+    }
+    
+    // Binary search of the highest quality within the budget.
+    CGFloat low         = kQualityMin;
+    CGFloat high        = 1.f;
+    CGFloat quality     = kQualityMin;
+    NSData  *fitting    = nil;
+    for (NSInteger step = 0; step < kQualitySearchSteps; step++) {
+        CGFloat middle  = (low + high) / 2.f;
+        NSData  *data   = [KYCImageScaler jpegFromCGImage:scaled orientation:orientation maxPixelSize:.0 quality:middle];
+        if (data.length <= byteBudget) {
+            fitting = data;
+            quality = middle;
+            low     = middle;
+        } else {
+            high    = middle;
+        }
+    }
+    
+    // Even the lowest quality does not fit. Use it anyway, it's the closest one.
+    if (!fitting) {
+        fitting = [KYCImageScaler jpegFromCGImage:scaled orientation:orientation maxPixelSize:.0 quality:quality];
+    }
+    
+    // Smaller upload is not worth failed recognition. Raise quality until validator is satisfied.
+    while (fitting && validator && !validator(fitting) && quality < 1.f) {
+        quality = MIN(quality + kQualityStep, 1.f);
+        fitting = [KYCImageScaler jpegFromCGImage:scaled orientation:orientation maxPixelSize:.0 quality:quality];
+    }
+    CGImageRelease(scaled);
+    
+    // Validator is satisfied only with maximum quality. Use the first encode, it was made from original image.
+    return quality < 1.f ? fitting : retValue;
+}
+
++ (NSData *)jpegFromData:(NSData *)data
+            maxPixelSize:(CGFloat)maxPixelSize
+                 quality:(CGFloat)quality {
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL);
+    if (!source) {
+        return nil;
+    }
+    
+    // Thumbnail is decoded directly in target size. Orientation is applied, so output does not need EXIF.
+    NSDictionary *options = @{
+        (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways   : @YES,
+        (__bridge NSString *)kCGImageSourceCreateThumbnailWithTransform     : @YES,
+        (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize            : @(maxPixelSize)
+    };
+    CGImageRef image = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+    CFRelease(source);
+    if (!image) {
+        return nil;
+    }
+    
+    NSData *retValue = [KYCImageScaler jpegFromImage:[UIImage imageWithCGImage:image] maxWidth:.0 quality:quality];
+    CGImageRelease(image);
+    
+    return retValue;
+}
+
++ (void)jpegFromImage:(UIImage *)image
+             maxWidth:(CGFloat)maxWidth
+           byteBudget:(NSUInteger)byteBudget
+            validator:(KYCImageScalerValidator)validator
+           completion:(KYCImageScalerCompletion)completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSData *data = [KYCImageScaler jpegFromImage:image maxWidth:maxWidth byteBudget:byteBudget validator:validator];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(data);
+        });
+    });
+}
+
++ (void)jpegFromImage:(UIImage *)image
+             maxWidth:(CGFloat)maxWidth
+              quality:(CGFloat)quality
+           completion:(KYCImageScalerCompletion)completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSData *data = [KYCImageScaler jpegFromImage:image maxWidth:maxWidth quality:quality];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(data);
+        });
+    });
+}
+
++ (void)encodeImage:(UIImage *)image
+               type:(NSString *)type
+           maxWidth:(CGFloat)maxWidth
+            quality:(CGFloat)quality
+         completion:(KYCImageScalerCompletion)completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSData *data = [KYCImageScaler encodeImage:image type:type maxWidth:maxWidth quality:quality];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(data);
+        });
+    });
+}
+
+// MARK: - Private Helpers
+
++ (NSData *)jpegFromCGImage:(CGImageRef)image
+                orientation:(CGImagePropertyOrientation)orientation
+               maxPixelSize:(CGFloat)maxPixelSize
+                    quality:(CGFloat)quality {
+    return [KYCImageScaler encodeCGImage:image
+                                    type:(__bridge NSString *)kUTTypeJPEG
+                             orientation:orientation
+                            maxPixelSize:maxPixelSize
+                                 quality:quality];
+}
+
++ (NSData *)encodeCGImage:(CGImageRef)image
+                     type:(NSString *)type
+              orientation:(CGImagePropertyOrientation)orientation
+             maxPixelSize:(CGFloat)maxPixelSize
+                  quality:(CGFloat)quality {
+    NSMutableDictionary *properties = [NSMutableDictionary new];
+    [properties setObject:@(quality) forKey:(__bridge NSString *)kCGImageDestinationLossyCompressionQuality];
+    [properties setObject:@(orientation) forKey:(__bridge NSString *)kCGImagePropertyOrientation];
+    if (maxPixelSize > .0) {
+        if (@available(iOS 12.0, *)) {
+            [properties setObject:@(maxPixelSize) forKey:(__bridge NSString *)kCGImageDestinationImageMaxPixelSize];
+        } else {
+            // Encoder can't scale on older systems. Scale the bitmap first and encode it as is.
+            CGImageRef  scaled      = [KYCImageScaler createScaledCGImage:image maxPixelSize:maxPixelSize];
+            NSData      *retValue   = nil;
+            if (scaled) {
+                retValue = [KYCImageScaler encodeCGImage:scaled type:type orientation:orientation maxPixelSize:.0 quality:quality];
+                CGImageRelease(scaled);
+            }
+            return retValue;
+        }
+    }
+    
+    NSMutableData           *retValue       = [NSMutableData new];
+    CGImageDestinationRef   destination     = CGImageDestinationCreateWithData((__bridge CFMutableDataRef)retValue, (__bridge CFStringRef)type, 1, NULL);
+    if (!destination) {
+        return nil;
+    }
+    
+    CGImageDestinationAddImage(destination, image, (__bridge CFDictionaryRef)properties);
+    BOOL success = CGImageDestinationFinalize(destination);
+    CFRelease(destination);
+    
+    return success ? retValue : nil;
+}
+
+/**
+ Scales the bitmap without {@code kCGImageDestinationImageMaxPixelSize}, which is available since iOS 12.
+ Image source can create thumbnail only from encoded data, so the image is encoded once in full size first.
+ 
+ @param image Image to scale.
+ @param maxPixelSize Maximum size of the longer side.
+ 
+ @return Scaled image, which must be released by the caller, or {@code NULL} on failure.
+ */
++ (CGImageRef)createScaledCGImage:(CGImageRef)image maxPixelSize:(CGFloat)maxPixelSize CF_RETURNS_RETAINED {
+    NSData *data = [KYCImageScaler jpegFromCGImage:image orientation:kCGImagePropertyOrientationUp maxPixelSize:.0 quality:1.f];
+    CGImageSourceRef source = data ? CGImageSourceCreateWithData((__bridge CFDataRef)data, NULL) : NULL;
+    if (!source) {
+        return NULL;
+    }
+    
+    // Orientation is written by the final encode. Keep pixels as they are.
+    NSDictionary *options = @{
+        (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways   : @YES,
+        (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize            : @(maxPixelSize)
+    };
+    CGImageRef retValue = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)options);
+    CFRelease(source);
+    
+    return retValue;
+}
+
++ (BOOL)isRotated:(UIImageOrientation)orientation {
+    switch (orientation) {
+        case UIImageOrientationLeft:
+        case UIImageOrientationLeftMirrored:
+        case UIImageOrientationRight:
+        case UIImageOrientationRightMirrored:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
++ (CGImagePropertyOrientation)propertyOrientation:(UIImageOrientation)orientation {
+    switch (orientation) {
+        case UIImageOrientationUp:              return kCGImagePropertyOrientationUp;
+        case UIImageOrientationDown:            return kCGImagePropertyOrientationDown;
+        case UIImageOrientationLeft:            return kCGImagePropertyOrientationLeft;
+        case UIImageOrientationRight:           return kCGImagePropertyOrientationRight;
+        case UIImageOrientationUpMirrored:      return kCGImagePropertyOrientationUpMirrored;
+        case UIImageOrientationDownMirrored:    return kCGImagePropertyOrientationDownMirrored;
+        case UIImageOrientationLeftMirrored:    return kCGImagePropertyOrientationLeftMirrored;
+        case UIImageOrientationRightMirrored:   return kCGImagePropertyOrientationRightMirrored;
+    }
+}
+
+@end
@@ -24,13 +24,24 @@
 
 #import "IdCloudOption.h"
 #import "KYCScannerStep.h"
+#import "KYCImageBuffer.h"
+
+@class CaptureInterface;
 
 #define kNotificationDataLayerChanged @"kNotificationDataLayerChanged"
 
 typedef void (^FaceIdCompletion)(BOOL success, NSError *error);
 
+typedef void (^DocumentCaptureCompletion)(BOOL isCompleted, int errorCode);
+
 typedef NSArray<NSArray <IdCloudOption *> *> OptionArray;
 
+typedef NS_ENUM(NSInteger, PortraitEncoding) {
+    PortraitEncodingPng,
+    PortraitEncodingJpeg,
+    PortraitEncodingHeic
+};
+
 @interface KYCManager : NSObject
 
 // KYC Generic values
@@ -54,6 +65,7 @@ typedef NSArray<NSArray <IdCloudOption *> *> OptionArray;
 @property (nonatomic, assign) NSInteger faceLivenessThreshold;
 @property (nonatomic, assign) NSInteger faceQualityThreshold;
 @property (nonatomic, assign) NSInteger faceBlinkTimeout;
+@property (nonatomic, assign) NSInteger portraitEncoding;
 
 // Options
 @property (nonatomic, strong, readonly) NSArray <NSString *>        *optionCaptions;
@@ -62,9 +74,12 @@ typedef NSArray<NSArray <IdCloudOption *> *> OptionArray;
 @property (nonatomic, copy, readonly)   NSString                    *apiKey;
 
 // Scanned elements
-@property (nonatomic, strong)           NSData *scannedDocFront;
-@property (nonatomic, strong)           NSData *scannedDocBack;
-@property (nonatomic, strong)           NSData *scannedPortrait;
+@property (nonatomic, strong)           KYCImageBuffer *scannedDocFront;
+@property (nonatomic, strong)           KYCImageBuffer *scannedDocBack;
+@property (nonatomic, strong)           KYCImageBuffer *scannedPortrait;
+
+// Document capture view initialized in advance by warmUpDocumentCapture. Nil once scanner used it.
+@property (nonatomic, strong, readonly) CaptureInterface            *warmDocumentCapture;
 
 /**
  Common method to get KYCManager singletone.
@@ -85,14 +100,43 @@ typedef NSArray<NSArray <IdCloudOption *> *> OptionArray;
 - (void)initializeFaceIdLicense:(FaceIdCompletion)completion;
 
 /**
- Switch to proper View Controller based on SDK state.
+ Starts document capture SDK initialization on screens leading to the scanner. Scanner then takes over already
+ initialized capture view instead of waiting for it. Does nothing if warm-up is disabled or already running.
+ */
+- (void)warmUpDocumentCapture;
 
+/**
+ Initializes capture view of document scanner. Warmed capture view is not initialized again, completion is called
+ once the warm-up finishes or right away if it already did.
+ 
+ @param captureView Capture view to initialize.
+ @param completion Same as completion of {@code initWithCompletion:}.
  */
-- (void)updateRootViewController;
+- (void)initializeDocumentCapture:(CaptureInterface *)captureView completion:(DocumentCaptureCompletion)completion;
 
-+ (void)removeClassFromSubviews:(Class)cls parent:(UIView *)parent;
+/**
+ Releases capture view initialized in advance, e.g. once the user leaves the document flow. Camera and SDK resources
+ held by the view are freed. Next warm-up starts from scratch.
+ */
+- (void)releaseWarmDocumentCapture;
 
-+ (NSArray<__kindof UIView *> *)getClassesFromSubviews:(Class)cls parent:(UIView *)parent;
+/**
+ Drops completion still waiting for warm-up of given capture view. Called once the scanner no longer uses the view.
+ 
+ @param captureView Capture view passed to {@code initializeDocumentCapture:completion:}.
+ */
+- (void)cancelDocumentCaptureInitialization:(CaptureInterface *)captureView;
+
+/**
+ Repeats failed face SDK license initialization before the face scanner is displayed.
+ */
+- (void)warmUpFaceCapture;
+
+/**
+ Switch to proper View Controller based on SDK state.
+
+ */
+- (void)updateRootViewController;
 
 
 @end
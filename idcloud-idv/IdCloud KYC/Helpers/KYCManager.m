@@ -24,8 +24,10 @@
 #import "AppDelegate.h"
 #import "SideMenuViewController.h"
 #import "KYCPrivacyPolicyViewController.h"
+#import "KYCScannerViewController.h"
 #import <JWTDecode/JWTDecode-Swift.h>
 #import "IdCloudQrCodeReader.h"
+#import "KYCTrace.h"
 
 
 // KYC Generic values
@@ -49,6 +51,7 @@
 #define KEY_FACE_LIVENESS_THRESHOLD @"KycPreferenceKeyLivenessThreshold"
 #define KEY_FACE_QUALITY_THRESHOLD  @"KycPreferenceKeyQualityThreshold"
 #define KEY_FACE_BLINK_TIMEOUT      @"KycPreferenceKeyBlinkTimeout"
+#define KEY_PORTRAIT_ENCODING       @"KycPreferenceKeyPortraitEncoding"
 
 #define KEY_MAX_PICTURE_WIDTH       @"MaxPictureWidth"
 #define KEY_JSON_WEB_TOKEN          @"JsonWebTokenV2"
@@ -63,6 +66,13 @@ static KYCManager *sInstance = nil;
 @property (nonatomic, strong)   NSError             *faceIdInitError;
 @property (nonatomic, assign)   BOOL                faceIdInitSuccess;
 
+@property (nonatomic, strong)   CaptureInterface            *warmDocumentCapture;
+// Scanners waiting for warm-up to finish. Entry is dropped together with the capture view or by the scanner.
+@property (nonatomic, strong)   NSMapTable<CaptureInterface *, DocumentCaptureCompletion>   *warmDocumentCompletions;
+@property (nonatomic, assign)   BOOL                        warmDocumentFinished;
+@property (nonatomic, assign)   BOOL                        warmDocumentSuccess;
+@property (nonatomic, assign)   int                         warmDocumentError;
+
 @end
 
 @implementation KYCManager
@@ -111,6 +121,7 @@ static KYCManager *sInstance = nil;
              KEY_FACE_LIVENESS_THRESHOLD  : [NSNumber numberWithInteger:0],
              KEY_FACE_QUALITY_THRESHOLD   : [NSNumber numberWithInteger:50],
              KEY_FACE_BLINK_TIMEOUT       : [NSNumber numberWithInteger:15],
+             KEY_PORTRAIT_ENCODING        : [NSNumber numberWithInteger:PortraitEncodingJpeg],
          }];
         
         // Available options in settings menu.
@@ -205,6 +216,16 @@ static KYCManager *sInstance = nil;
                           selectorGet:@selector(faceBlinkTimeout)
                           selectorSet:@selector(setFaceBlinkTimeout:)
                              minValue:0 maxValue:100],
+                [IdCloudOption segment:TRANSLATE(@"STRING_KYC_OPTION_PORTRAIT_ENCODING_CAP")
+                               section:IdCloudOptionSectionFaceCapture
+                               options:@{
+                                   [NSNumber numberWithInteger:PortraitEncodingPng]: TRANSLATE(@"STRING_KYC_OPTION_PORTRAIT_ENCODING_PNG"),
+                                   [NSNumber numberWithInteger:PortraitEncodingJpeg]: TRANSLATE(@"STRING_KYC_OPTION_PORTRAIT_ENCODING_JPEG"),
+                                   [NSNumber numberWithInteger:PortraitEncodingHeic]: TRANSLATE(@"STRING_KYC_OPTION_PORTRAIT_ENCODING_HEIC")
+                               }
+                                target:self
+                           selectorGet:@selector(portraitEncoding)
+                           selectorSet:@selector(setPortraitEncoding:)],
             ],
             
             
@@ -245,6 +266,8 @@ static KYCManager *sInstance = nil;
             TRANSLATE(@"STRING_KYC_OPTION_SECTION_VERSION")
         ];
         
+        self.warmDocumentCompletions = [NSMapTable weakToStrongObjectsMapTable];
+        
         // Do any additional setup after loading the view.
         [self initFaceId];
     }
@@ -360,6 +383,14 @@ static KYCManager *sInstance = nil;
     return [[NSUserDefaults standardUserDefaults] integerForKey:KEY_FACE_BLINK_TIMEOUT];
 }
 
+- (void)setPortraitEncoding:(NSInteger)portraitEncoding {
+    [[NSUserDefaults standardUserDefaults] setInteger:portraitEncoding forKey:KEY_PORTRAIT_ENCODING];
+}
+
+- (NSInteger)portraitEncoding {
+    return [[NSUserDefaults standardUserDefaults] integerForKey:KEY_PORTRAIT_ENCODING];
+}
+
 // MARK: - Public API
 
 - (void)displayQRcodeScannerForInit {
@@ -397,6 +428,81 @@ static KYCManager *sInstance = nil;
     }
 }
 
+- (void)warmUpDocumentCapture {
+    if (!CFG_IDCLOUD_CAPTURE_WARMUP || _warmDocumentCapture) {
+        return;
+    }
+    
+    // Same view scanner storyboard would load. Frame is updated once the view is placed to the scanner.
+    self.warmDocumentCapture    = [KYCScannerViewController instantiateCaptureView];
+    self.warmDocumentFinished   = NO;
+    
+    KYCTraceSpan        *span           = [KYCTrace beginSpanWithName:@"captureWarmUp" category:kTraceCategoryCapture];
+    CaptureInterface    *captureView    = _warmDocumentCapture;
+    [captureView initWithCompletion:^(BOOL isCompleted, int errorCode) {
+        [span setArgument:@(isCompleted) forKey:@"success"];
+        [span end];
+        
+        // Scanner is already waiting for this view.
+        DocumentCaptureCompletion completion = [self.warmDocumentCompletions objectForKey:captureView];
+        if (completion) {
+            [self.warmDocumentCompletions removeObjectForKey:captureView];
+            completion(isCompleted, errorCode);
+            return;
+        }
+        
+        // Warm-up was replaced meanwhile.
+        if (captureView != self.warmDocumentCapture) {
+            return;
+        }
+        
+        // Save init response for later use.
+        self.warmDocumentFinished   = YES;
+        self.warmDocumentSuccess    = isCompleted;
+        self.warmDocumentError      = errorCode;
+    }];
+}
+
+- (void)initializeDocumentCapture:(CaptureInterface *)captureView completion:(DocumentCaptureCompletion)completion {
+    // Regular init of storyboard view or repeated init after returning from background.
+    if (!captureView || captureView != _warmDocumentCapture) {
+        [captureView initWithCompletion:completion];
+        return;
+    }
+    
+    // Warmed view belongs to the scanner from now on.
+    self.warmDocumentCapture = nil;
+    
+    if (!_warmDocumentFinished) {
+        // Init is still running. Wait for it.
+        [_warmDocumentCompletions setObject:completion forKey:captureView];
+    } else if (_warmDocumentSuccess) {
+        completion(YES, _warmDocumentError);
+    } else {
+        // Something went wrong during warm-up (e.g. app was in background). Try it again.
+        [captureView initWithCompletion:completion];
+    }
+}
+
+- (void)releaseWarmDocumentCapture {
+    // Running init sees the view was replaced and drops its result.
+    self.warmDocumentCapture    = nil;
+    self.warmDocumentFinished   = NO;
+}
+
+- (void)cancelDocumentCaptureInitialization:(CaptureInterface *)captureView {
+    if (captureView) {
+        [_warmDocumentCompletions removeObjectForKey:captureView];
+    }
+}
+
+- (void)warmUpFaceCapture {
+    // License init starts with application. Repeat failed attempt now, so face scanner does not have to.
+    if (CFG_IDCLOUD_CAPTURE_WARMUP && !_faceIdInitSuccess && _faceIdInitError) {
+        [self initFaceId];
+    }
+}
+
 - (void)updateRootViewController {
     AppDelegate *appDelegate = (AppDelegate *)[[UIApplication sharedApplication] delegate];
     [appDelegate.rootViewController switchToViewController:[SideMenuViewController kycVC]];
@@ -530,32 +636,6 @@ static KYCManager *sInstance = nil;
     return [[NSUserDefaults standardUserDefaults] integerForKey:KEY_MAX_PICTURE_WIDTH];
 }
 
-// MARK: - Static Helpers
-
-+ (void)removeClassFromSubviews:(Class)cls parent:(UIView *)parent {
-    for (UIView *loopView in parent.subviews) {
-        if ([loopView isKindOfClass:cls]) {
-            [loopView removeFromSuperview];
-        } else {
-            [KYCManager removeClassFromSubviews:cls parent:loopView];
-        }
-    }
-}
-
-+ (NSArray<__kindof UIView *> *)getClassesFromSubviews:(Class)cls parent:(UIView *)parent {
-    NSMutableArray<__kindof UIView *> *retValue = [NSMutableArray array];
-    
-    for (UIView *loopView in parent.subviews) {
-        if ([loopView isKindOfClass:cls]) {
-            [retValue addObject:loopView];
-        }
-        
-        [retValue addObjectsFromArray:[KYCManager getClassesFromSubviews:cls parent:loopView]];
-    }
-    
-    return retValue;
-}
-
 // MARK: - IdCloudQrCodeReaderDelegate
 
 - (void)onQRCodeProvided:(IdCloudQrCodeReader *)sender qrCode:(NSString *)qrCode {
@@ -0,0 +1,275 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+
+#import "KYCTrace.h"
+#import <os/log.h>
+#import <os/signpost.h>
+#import <pthread.h>
+#import <time.h>
+
+// Oldest spans are dropped once the recorder holds this many.
+#define kRecorderCapacity   4096
+
+#define kTraceFileName      @"kyc-trace.json"
+
+static BOOL                         sEnabled    = NO;
+static NSArray<id<KYCTraceSink>>    *sSinks     = nil;
+static uint64_t                     sLastId     = 0;
+
+// MARK: - KYCTraceSpan
+
+@interface KYCTraceSpan()
+
+@property (nonatomic, strong)   NSArray<id<KYCTraceSink>>               *sinks;
+@property (nonatomic, strong)   NSMutableDictionary<NSString *, id>     *mutableArguments;
+
++ (instancetype)spanWithName:(NSString *)name category:(NSString *)category sinks:(NSArray<id<KYCTraceSink>> *)sinks;
+
+@end
+
+@implementation KYCTraceSpan
+
++ (instancetype)spanWithName:(NSString *)name category:(NSString *)category sinks:(NSArray<id<KYCTraceSink>> *)sinks {
+    KYCTraceSpan *retValue = [KYCTraceSpan new];
+    retValue->_name         = [name copy];
+    retValue->_category     = [category copy];
+    retValue->_identifier   = __atomic_add_fetch(&sLastId, 1, __ATOMIC_RELAXED);
+    retValue.sinks          = sinks;
+    pthread_threadid_np(NULL, &retValue->_threadId);
+    retValue->_startTime    = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    return retValue;
+}
+
+- (NSDictionary<NSString *, id> *)arguments {
+    @synchronized (self) {
+        return [_mutableArguments copy];
+    }
+}
+
+- (void)setArgument:(id)value forKey:(NSString *)key {
+    @synchronized (self) {
+        if (!_mutableArguments) {
+            self.mutableArguments = [NSMutableDictionary new];
+        }
+        [_mutableArguments setValue:value forKey:key];
+    }
+}
+
+- (void)end {
+    NSArray<id<KYCTraceSink>> *sinks;
+    @synchronized (self) {
+        if (_endTime) {
+            return;
+        }
+        
+        _endTime    = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+        sinks       = _sinks;
+        self.sinks  = nil;
+    }
+    
+    for (id<KYCTraceSink> loopSink in sinks) {
+        [loopSink traceSpanEnded:self];
+    }
+}
+
+@end
+
+// MARK: - KYCTrace
+
+@implementation KYCTrace
+
++ (void)setEnabled:(BOOL)enabled {
+    sEnabled = enabled;
+}
+
++ (BOOL)isEnabled {
+    return CFG_IDCLOUD_TRACE && sEnabled;
+}
+
++ (void)addSink:(id<KYCTraceSink>)sink {
+    @synchronized (self) {
+        sSinks = sSinks ? [sSinks arrayByAddingObject:sink] : @[sink];
+    }
+}
+
++ (void)removeSink:(id<KYCTraceSink>)sink {
+    @synchronized (self) {
+        NSMutableArray *sinks = [sSinks mutableCopy];
+        [sinks removeObject:sink];
+        sSinks = [sinks copy];
+    }
+}
+
++ (KYCTraceSpan *)beginSpanWithName:(NSString *)name category:(NSString *)category {
+    // Fast path. Nothing is allocated while tracing is off.
+    if (!CFG_IDCLOUD_TRACE || !sEnabled) {
+        return nil;
+    }
+    
+    NSArray<id<KYCTraceSink>> *sinks;
+    @synchronized (self) {
+        sinks = sSinks;
+    }
+    
+    KYCTraceSpan *retValue = [KYCTraceSpan spanWithName:name category:category sinks:sinks];
+    for (id<KYCTraceSink> loopSink in sinks) {
+        if ([loopSink respondsToSelector:@selector(traceSpanBegan:)]) {
+            [loopSink traceSpanBegan:retValue];
+        }
+    }
+    
+    return retValue;
+}
+
+@end
+
+// MARK: - KYCTraceSignpostSink
+
+@interface KYCTraceSignpostSink()
+
+@property (nonatomic, strong) os_log_t log;
+
+@end
+
+@implementation KYCTraceSignpostSink
+
++ (instancetype)sinkWithSubsystem:(NSString *)subsystem {
+    KYCTraceSignpostSink *retValue = [KYCTraceSignpostSink new];
+    retValue.log = os_log_create(subsystem.UTF8String, "Verification");
+    return retValue;
+}
+
+- (void)traceSpanBegan:(KYCTraceSpan *)span {
+    if (@available(iOS 12.0, *)) {
+        // Signpost name must be a literal. Step is identified by the message instead.
+        os_signpost_interval_begin(_log, span.identifier, "KYC", "%{public}@.%{public}@", span.category, span.name);
+    }
+}
+
+- (void)traceSpanEnded:(KYCTraceSpan *)span {
+    if (@available(iOS 12.0, *)) {
+        os_signpost_interval_end(_log, span.identifier, "KYC", "%{public}@", span.arguments.description ?: @"");
+    }
+}
+
+@end
+
+// MARK: - KYCTraceRecorder
+
+static KYCTraceRecorder *sInstance = nil;
+
+@interface KYCTraceRecorder()
+
+@property (nonatomic, strong) NSMutableArray<KYCTraceSpan *> *spans;
+
+@end
+
+@implementation KYCTraceRecorder
+
+// MARK: - Static Helpers
+
++ (instancetype)sharedInstance {
+    @synchronized (self) {
+        if (!sInstance) {
+            sInstance = [[KYCTraceRecorder alloc] init];
+        }
+        
+        return sInstance;
+    }
+}
+
++ (void)end {
+    @synchronized (self) {
+        sInstance = nil;
+    }
+}
+
++ (NSURL *)defaultURL {
+    NSURL *documents = [[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask].firstObject;
+    return [documents URLByAppendingPathComponent:kTraceFileName];
+}
+
+// MARK: - Life Cycle
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.spans = [NSMutableArray new];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (NSData *)chromeTraceData {
+    NSArray<KYCTraceSpan *> *spans;
+    @synchronized (self) {
+        spans = [_spans copy];
+    }
+    
+    // Complete events ("ph": "X") with time in microseconds. Only JSON compatible arguments are exported.
+    NSMutableArray *events = [NSMutableArray arrayWithCapacity:spans.count];
+    for (KYCTraceSpan *loopSpan in spans) {
+        NSMutableDictionary *args = [NSMutableDictionary new];
+        [loopSpan.arguments enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            args[key] = [value isKindOfClass:[NSNumber class]] ? value : [value description];
+        }];
+        
+        [events addObject:@{
+            @"name" : loopSpan.name,
+            @"cat"  : loopSpan.category,
+            @"ph"   : @"X",
+            @"ts"   : @(loopSpan.startTime / 1000.),
+            @"dur"  : @((loopSpan.endTime - loopSpan.startTime) / 1000.),
+            @"pid"  : @([NSProcessInfo processInfo].processIdentifier),
+            @"tid"  : @(loopSpan.threadId),
+            @"args" : args
+        }];
+    }
+    
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents": events, @"displayTimeUnit": @"ms"}
+                                           options:0
+                                             error:nil];
+}
+
+- (BOOL)writeToURL:(NSURL *)url error:(NSError **)error {
+    return [[self chromeTraceData] writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+- (void)reset {
+    @synchronized (self) {
+        [_spans removeAllObjects];
+    }
+}
+
+// MARK: - KYCTraceSink
+
+- (void)traceSpanEnded:(KYCTraceSpan *)span {
+    @synchronized (self) {
+        if (_spans.count >= kRecorderCapacity) {
+            [_spans removeObjectAtIndex:0];
+        }
+        [_spans addObject:span];
+    }
+}
+
+@end
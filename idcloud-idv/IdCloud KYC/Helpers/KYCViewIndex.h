@@ -0,0 +1,50 @@
+/**
+ Index of all views below single root view grouped by their class.
+
+ Hierarchy is traversed only once, when the index is created. Index is then kept up to date from
+ {@code didAddSubview:} and {@code willRemoveSubview:} of every indexed view, so class lookups never walk the view tree.
+ Index must be used only from the main thread, same as the views it contains.
+ */
+@interface KYCViewIndex : NSObject
+
+/**
+ View passed to {@code indexWithRootView:}. Root view itself is not part of the lookup results.
+ */
+@property (nonatomic, weak, readonly)   UIView      *rootView;
+
+/**
+ Number of views currently indexed below root view.
+ */
+@property (nonatomic, assign, readonly) NSUInteger  viewCount;
+
+/**
+ Creates a new {@code KYCViewIndex} instance. Any previous index of the same root view is invalidated.
+
+ @param rootView View which hierarchy should be indexed.
+
+ @return Instance of {@code KYCViewIndex}.
+ */
++ (instancetype)indexWithRootView:(UIView *)rootView;
+
+/**
+ Returns all views below root view which are kind of given class.
+
+ @param cls Class or superclass of requested views.
+
+ @return Matching views. Empty array if there are none.
+ */
+- (NSArray<__kindof UIView *> *)viewsOfClass:(Class)cls;
+
+/**
+ Removes all views below root view which are kind of given class from their superviews.
+
+ @param cls Class or superclass of views to remove.
+ */
+- (void)removeViewsOfClass:(Class)cls;
+
+/**
+ Stops tracking hierarchy changes and releases all indexed views.
+ */
+- (void)invalidate;
+
+@end
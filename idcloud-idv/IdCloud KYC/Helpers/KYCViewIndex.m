@@ -0,0 +1,226 @@
+/*
+MIT License
+
+Copyright (c) 2020 Thales DIS
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+IMPORTANT: This source code is intended to serve training information purposes only.
+Please make sure to review our IdCloud documentation, including security guidelines.
+*/
+#import "KYCViewIndex.h"
+#import "KYCTrace.h"
+#import <objc/runtime.h>
+
+// Associated object key. Each indexed view keeps reference to the index it belongs to.
+static char kViewIndexKey;
+
+// Original UIView implementations called from the hooks.
+static IMP sDidAddSubview       = NULL;
+static IMP sWillRemoveSubview   = NULL;
+
+@interface KYCViewIndex()
+
+@property (nonatomic, weak)     UIView                                                  *rootView;
+// Indexed views grouped by their exact class. Each group keeps the order in which views were added.
+@property (nonatomic, strong)   NSMutableDictionary<id<NSCopying>, NSPointerArray *>    *views;
+// Position of each indexed view across all groups. Used to merge groups in the same order.
+@property (nonatomic, strong)   NSMapTable<UIView *, NSNumber *>                        *order;
+@property (nonatomic, assign)   NSUInteger                                              nextOrder;
+// Results of kind-of lookups. Dropped with every hierarchy change.
+@property (nonatomic, strong)   NSMutableDictionary<id<NSCopying>, NSArray<UIView *> *> *lookups;
+
+- (void)addSubtree:(UIView *)view;
+- (void)removeSubtree:(UIView *)view;
+
+@end
+
+// MARK: - UIView Hooks
+
+static void KYCDidAddSubview(UIView *self, SEL _cmd, UIView *subview) {
+    ((void (*)(UIView *, SEL, UIView *))sDidAddSubview)(self, _cmd, subview);
+    
+    // Single associated object lookup. Views outside of any index are not affected.
+    [objc_getAssociatedObject(self, &kViewIndexKey) addSubtree:subview];
+}
+
+static void KYCWillRemoveSubview(UIView *self, SEL _cmd, UIView *subview) {
+    [objc_getAssociatedObject(self, &kViewIndexKey) removeSubtree:subview];
+    
+    ((void (*)(UIView *, SEL, UIView *))sWillRemoveSubview)(self, _cmd, subview);
+}
+
+/**
+ Replaces UIView method with the hook. Method which already runs the hook is left as is, so installing twice never
+ makes the hook call itself or restores the original implementation.
+ 
+ @param selector Hooked method.
+ @param hook Hook implementation.
+ 
+ @return Original implementation.
+ */
+static IMP KYCInstallHook(SEL selector, IMP hook) {
+    Method method = class_getInstanceMethod([UIView class], selector);
+    if (method_getImplementation(method) == hook) {
+        return NULL;
+    }
+    
+    return method_setImplementation(method, hook);
+}
+
+@implementation UIView (KYCViewIndex)
+
++ (void)installViewIndexHooks {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sDidAddSubview      = KYCInstallHook(@selector(didAddSubview:), (IMP)KYCDidAddSubview) ?: sDidAddSubview;
+        sWillRemoveSubview  = KYCInstallHook(@selector(willRemoveSubview:), (IMP)KYCWillRemoveSubview) ?: sWillRemoveSubview;
+    });
+}
+
+@end
+
+@implementation KYCViewIndex
+
+// MARK: - Life Cycle
+
++ (instancetype)indexWithRootView:(UIView *)rootView {
+    return [[KYCViewIndex alloc] initWithRootView:rootView];
+}
+
+- (instancetype)initWithRootView:(UIView *)rootView {
+    if (self = [super init]) {
+        [UIView installViewIndexHooks];
+        
+        _rootView   = rootView;
+        _views      = [NSMutableDictionary dictionary];
+        _order      = [NSMapTable weakToStrongObjectsMapTable];
+        _lookups    = [NSMutableDictionary dictionary];
+        
+        KYCTraceSpan *span = [KYCTrace beginSpanWithName:@"viewIndexBuild" category:kTraceCategoryCapture];
+        [objc_getAssociatedObject(rootView, &kViewIndexKey) invalidate];
+        objc_setAssociatedObject(rootView, &kViewIndexKey, self, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        for (UIView *loopView in rootView.subviews) {
+            [self addSubtree:loopView];
+        }
+        [span setArgument:@(_viewCount) forKey:@"views"];
+        [span end];
+    }
+    
+    return self;
+}
+
+// MARK: - Public API
+
+- (NSArray<__kindof UIView *> *)viewsOfClass:(Class)cls {
+    NSArray<UIView *> *retValue = _lookups[(id<NSCopying>)cls];
+    
+    // Merge all exact classes matching requested one in the order views were added. Result is kept until next
+    // hierarchy change.
+    if (!retValue) {
+        NSMutableArray<UIView *>    *views  = [NSMutableArray array];
+        NSUInteger                  groups  = 0;
+        for (Class loopClass in _views) {
+            if ([loopClass isSubclassOfClass:cls]) {
+                [views addObjectsFromArray:_views[(id<NSCopying>)loopClass].allObjects];
+                groups++;
+            }
+        }
+        if (groups > 1) {
+            [views sortUsingComparator:^NSComparisonResult(UIView *view1, UIView *view2) {
+                return [[self.order objectForKey:view1] compare:[self.order objectForKey:view2]];
+            }];
+        }
+        retValue = views;
+        _lookups[(id<NSCopying>)cls] = retValue;
+    }
+    
+    return retValue;
+}
+
+- (void)removeViewsOfClass:(Class)cls {
+    // Returned array is not affected by index updates triggered from removal.
+    for (UIView *loopView in [self viewsOfClass:cls]) {
+        [loopView removeFromSuperview];
+    }
+}
+
+- (void)invalidate {
+    UIView *rootView = _rootView;
+    if (objc_getAssociatedObject(rootView, &kViewIndexKey) == self) {
+        objc_setAssociatedObject(rootView, &kViewIndexKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    for (NSPointerArray *loopViews in _views.allValues) {
+        for (UIView *loopView in loopViews.allObjects) {
+            if (objc_getAssociatedObject(loopView, &kViewIndexKey) == self) {
+                objc_setAssociatedObject(loopView, &kViewIndexKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+            }
+        }
+    }
+    
+    [_views removeAllObjects];
+    [_order removeAllObjects];
+    [_lookups removeAllObjects];
+    _viewCount = 0;
+}
+
+// MARK: - Private Helpers
+
+- (void)addSubtree:(UIView *)view {
+    id<NSCopying>   key     = (id<NSCopying>)view.class;
+    NSPointerArray  *views  = _views[key];
+    if (!views) {
+        // Views are owned by their superviews. Index only refers to them.
+        views = [NSPointerArray weakObjectsPointerArray];
+        _views[key] = views;
+    }
+    
+    // View can be added again when it's moved within the same superview. It keeps its original position.
+    if (![_order objectForKey:view]) {
+        [views addPointer:(__bridge void *)view];
+        [_order setObject:@(_nextOrder++) forKey:view];
+        _viewCount++;
+    }
+    objc_setAssociatedObject(view, &kViewIndexKey, self, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    [_lookups removeAllObjects];
+    
+    for (UIView *loopView in view.subviews) {
+        [self addSubtree:loopView];
+    }
+}
+
+- (void)removeSubtree:(UIView *)view {
+    if ([_order objectForKey:view]) {
+        // Released views leave empty slots behind. Drop them together with the removed one.
+        NSPointerArray *views = _views[(id<NSCopying>)view.class];
+        for (NSUInteger loopIndex = views.count; loopIndex > 0; loopIndex--) {
+            void *pointer = [views pointerAtIndex:loopIndex - 1];
+            if (!pointer || pointer == (__bridge void *)view) {
+                [views removePointerAtIndex:loopIndex - 1];
+            }
+        }
+        [_order removeObjectForKey:view];
+        _viewCount--;
+    }
+    if (objc_getAssociatedObject(view, &kViewIndexKey) == self) {
+        objc_setAssociatedObject(view, &kViewIndexKey, nil, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    [_lookups removeAllObjects];
+    
+    for (UIView *loopView in view.subviews) {
+        [self removeSubtree:loopView];
+    }
+}
+
+@end